@@ -149,6 +149,85 @@ EAS_PUBLIC const S_EAS_LIB_CONFIG *EAS_Config (void);
 */
 EAS_PUBLIC EAS_RESULT EAS_Shutdown (EAS_DATA_HANDLE pEASData);
 
+/* maximum number of idle instances kept by a pool */
+#ifndef EAS_MAX_POOL_INSTANCES
+#define EAS_MAX_POOL_INSTANCES  4
+#endif
+
+typedef struct s_eas_pool_tag *EAS_POOL_HANDLE;
+
+/*----------------------------------------------------------------------------
+ * EAS_PoolInit()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Creates a pool of ready to use instances, so that short sounds such as
+ * notifications do not pay for EAS_Init on every play. Dynamic memory
+ * model only. The pool functions are not thread safe. They return
+ * EAS_ERROR_FEATURE_NOT_AVAILABLE if the library is built without
+ * _INSTANCE_POOL.
+ *
+ * Inputs:
+ *  ppPool          - pointer to pool handle variable
+ *  numInstances    - number of instances to initialize now, from 1 to
+ *                    EAS_MAX_POOL_INSTANCES
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_PoolInit (EAS_POOL_HANDLE *ppPool, EAS_INT numInstances);
+
+/*----------------------------------------------------------------------------
+ * EAS_PoolGet()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Hands out an instance from the pool. The instance is in the same
+ * state as one just returned by EAS_Init. If no idle instance is left,
+ * a new one is initialized.
+ *
+ * Inputs:
+ *  pPool           - pool handle
+ *  ppEASData       - pointer to data handle variable
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_PoolGet (EAS_POOL_HANDLE pPool, EAS_DATA_HANDLE *ppEASData);
+
+/*----------------------------------------------------------------------------
+ * EAS_PoolRelease()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns an instance to the pool in place of EAS_Shutdown. Open streams
+ * are closed and a loaded DLS collection is released. JET must be shut
+ * down first, otherwise the instance is shut down instead of pooled.
+ *
+ * Inputs:
+ *  pPool           - pool handle
+ *  pEASData        - handle to data for this instance
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_PoolRelease (EAS_POOL_HANDLE pPool, EAS_DATA_HANDLE pEASData);
+
+/*----------------------------------------------------------------------------
+ * EAS_PoolShutdown()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Shuts down the idle instances and frees the pool
+ *
+ * Inputs:
+ *  pPool           - pool handle
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_PoolShutdown (EAS_POOL_HANDLE pPool);
+
 /*----------------------------------------------------------------------------
  * EAS_Render()
  *----------------------------------------------------------------------------
@@ -608,6 +687,50 @@ EAS_PUBLIC EAS_RESULT EAS_MetricsReport (EAS_DATA_HANDLE pEASData);
 EAS_PUBLIC EAS_RESULT EAS_MetricsReset (EAS_DATA_HANDLE pEASData);
 #endif
 
+/*----------------------------------------------------------------------------
+ * EAS_GetMemoryUsage()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns the dynamic memory used by this instance. The high-water mark
+ * shows how much of the instance arena reserved by EAS_Init has been
+ * touched, use it to tune EAS_ARENA_STREAM_SIZE. Returns
+ * EAS_ERROR_FEATURE_NOT_AVAILABLE if the library is built without
+ * _HW_MEMORY_ARENA.
+ *
+ * Inputs:
+ * pEASData         - instance data handle
+ *
+ * Outputs:
+ * pCurrent         - bytes allocated now
+ * pPeak            - most bytes allocated at one time
+ * pHighWater       - highest offset used in the instance arena
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_GetMemoryUsage (EAS_DATA_HANDLE pEASData, EAS_I32 *pCurrent, EAS_I32 *pPeak, EAS_I32 *pHighWater);
+
+/*----------------------------------------------------------------------------
+ * EAS_SetRenderBudget()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Sets the CPU time this instance may spend in EAS_Render for one buffer.
+ * While the measured render time is over the budget, the library lowers
+ * its polyphony and parses fewer events per buffer. It raises the
+ * polyphony again when the load drops, up to the polyphony it had when
+ * the budget was set. 0 (the default) turns this off. Returns
+ * EAS_ERROR_FEATURE_NOT_AVAILABLE if the library is built without
+ * _ADAPTIVE_POLYPHONY.
+ *
+ * Inputs:
+ * pEASData         - instance data handle
+ * budget           - render budget in microseconds per buffer
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetRenderBudget (EAS_DATA_HANDLE pEASData, EAS_I32 budget);
+
 /*----------------------------------------------------------------------------
  * EAS_SearchFile
  *----------------------------------------------------------------------------
@@ -36,9 +36,9 @@ typedef enum
 {
     EAS_PARAM_CHORUS_BYPASS,
     EAS_PARAM_CHORUS_PRESET,
-    EAS_PARAM_CHORUS_RATE,
-    EAS_PARAM_CHORUS_DEPTH,
-    EAS_PARAM_CHORUS_LEVEL
+    EAS_PARAM_CHORUS_RATE,          /* LFO rate in 0.1 Hz, 1 to 50 */
+    EAS_PARAM_CHORUS_DEPTH,         /* sweep depth in 0.1 ms, 0 to 50 */
+    EAS_PARAM_CHORUS_LEVEL          /* wet level, 0 to 32767 */
 } E_CHORUS_PARAMS;
 
 typedef enum
@@ -36,6 +36,9 @@
 #define _EAS_HOST_H
 
 #include "eas_types.h"
+#ifdef _ADAPTIVE_POLYPHONY
+#include <stdint.h>
+#endif
 
 /* for C++ linkage */
 #ifdef __cplusplus
@@ -58,6 +61,13 @@ extern EAS_I32 EAS_HWMemCmp(const void *s1, const void *s2, EAS_I32 n);
 /* memory allocation */
 extern void *EAS_HWMalloc(EAS_HW_DATA_HANDLE hwInstData, EAS_I32 size);
 extern void EAS_HWFree(EAS_HW_DATA_HANDLE hwInstData, void *p);
+#ifdef _HW_MEMORY_ARENA
+extern EAS_RESULT EAS_HWReserveMemory(EAS_HW_DATA_HANDLE hwInstData, EAS_I32 size);
+extern EAS_RESULT EAS_HWGetMemoryUsage(EAS_HW_DATA_HANDLE hwInstData, EAS_I32 *pCurrent, EAS_I32 *pPeak, EAS_I32 *pHighWater);
+#endif
+#ifdef _HW_ALLOC_GUARD
+extern void EAS_HWSetAllocGuard(EAS_HW_DATA_HANDLE hwInstData, EAS_BOOL enable);
+#endif
 
 /* file I/O */
 extern EAS_RESULT EAS_HWOpenFile(EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_LOCATOR locator, EAS_FILE_HANDLE *pFile, EAS_FILE_MODE mode);
@@ -77,6 +87,11 @@ extern EAS_RESULT EAS_HWVibrate(EAS_HW_DATA_HANDLE hwInstData, EAS_BOOL state);
 extern EAS_RESULT EAS_HWLED(EAS_HW_DATA_HANDLE hwInstData, EAS_BOOL state);
 extern EAS_RESULT EAS_HWBackLight(EAS_HW_DATA_HANDLE hwInstData, EAS_BOOL state);
 
+#ifdef _ADAPTIVE_POLYPHONY
+/* monotonic clock in microseconds, used to measure render time */
+extern uint64_t EAS_HWGetTime(EAS_HW_DATA_HANDLE hwInstData);
+#endif
+
 #ifdef __cplusplus
 } /* end extern "C" */
 #endif
@@ -55,6 +55,9 @@
 #include <errno.h>
 #include <signal.h>
 #include <pthread.h>
+#ifdef _ADAPTIVE_POLYPHONY
+#include <time.h>
+#endif
 #include <media/MediaPlayerInterface.h>
 #endif
 
@@ -91,9 +94,44 @@ typedef struct eas_hw_file_tag
     void *handle;
 } EAS_HW_FILE;
 
+#ifdef _HW_MEMORY_ARENA
+/*
+ * Memory arena
+ *
+ * Each instance can reserve one block of memory at init time. Allocations
+ * are carved out of it first-fit from an address ordered free list, and
+ * freed blocks are merged with their neighbours. When the arena is full,
+ * or was never reserved, allocations fall back to malloc. The arena is
+ * released in one shot by EAS_HWShutdown.
+ *
+ * Every block, in the arena or not, starts with a header so that the
+ * allocated size is known when it is freed.
+ */
+typedef union eas_hw_block_tag
+{
+    struct
+    {
+        union eas_hw_block_tag *pNext;  /* next free block, free list only */
+        EAS_I32 units;                  /* block size in headers, including this one */
+    } s;
+    long double align;                  /* forces worst case alignment */
+} EAS_HW_BLOCK;
+#endif
+
 typedef struct eas_hw_inst_data_tag
 {
     EAS_HW_FILE files[EAS_MAX_FILE_HANDLES];
+#ifdef _HW_MEMORY_ARENA
+    EAS_HW_BLOCK *pArena;               /* reserved memory, NULL if none */
+    EAS_HW_BLOCK *pFreeList;            /* free arena blocks, by address */
+    EAS_I32 arenaUnits;                 /* size of arena in headers */
+    EAS_I32 highWater;                  /* highest arena offset ever allocated, bytes */
+    EAS_I32 curBytes;                   /* bytes allocated now */
+    EAS_I32 peakBytes;                  /* most bytes allocated at one time */
+#endif
+#ifdef _HW_ALLOC_GUARD
+    EAS_BOOL allocGuard;                /* EAS_TRUE while allocation is not allowed */
+#endif
 } EAS_HW_INST_DATA;
 
 pthread_key_t EAS_sigbuskey;
@@ -138,10 +176,162 @@ EAS_RESULT EAS_HWInit (EAS_HW_DATA_HANDLE *pHWInstData)
 EAS_RESULT EAS_HWShutdown (EAS_HW_DATA_HANDLE hwInstData)
 {
 
+#ifdef _HW_MEMORY_ARENA
+    /* release the arena, including anything that was not freed */
+    free(hwInstData->pArena);
+#endif
     free(hwInstData);
     return EAS_SUCCESS;
 }
 
+#ifdef _HW_MEMORY_ARENA
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWReserveMemory
+ *
+ * Reserves the memory arena for this instance
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_HWReserveMemory (EAS_HW_DATA_HANDLE hwInstData, EAS_I32 size)
+{
+    EAS_I32 units;
+
+    /* only one arena per instance */
+    if (hwInstData->pArena != NULL)
+        return EAS_ERROR_FEATURE_ALREADY_ACTIVE;
+    if (size <= 0)
+        return EAS_ERROR_PARAMETER_RANGE;
+
+    units = (EAS_I32) ((size + sizeof(EAS_HW_BLOCK) - 1) / sizeof(EAS_HW_BLOCK));
+    hwInstData->pArena = malloc((size_t) units * sizeof(EAS_HW_BLOCK));
+    if (hwInstData->pArena == NULL)
+        return EAS_ERROR_MALLOC_FAILED;
+
+    /* the whole arena starts out as one free block */
+    hwInstData->arenaUnits = units;
+    hwInstData->pArena->s.units = units;
+    hwInstData->pArena->s.pNext = NULL;
+    hwInstData->pFreeList = hwInstData->pArena;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWGetMemoryUsage
+ *
+ * Returns the current, peak and arena high-water memory use in bytes
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT EAS_HWGetMemoryUsage (EAS_HW_DATA_HANDLE hwInstData, EAS_I32 *pCurrent, EAS_I32 *pPeak, EAS_I32 *pHighWater)
+{
+    *pCurrent = hwInstData->curBytes;
+    *pPeak = hwInstData->peakBytes;
+    *pHighWater = hwInstData->highWater;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ *
+ * ArenaAlloc
+ *
+ * Allocates a block from the arena, returns NULL if there is no room
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_HW_BLOCK *ArenaAlloc (EAS_HW_DATA_HANDLE hwInstData, EAS_I32 units)
+{
+    EAS_HW_BLOCK **ppPrev;
+    EAS_HW_BLOCK *pBlock;
+    EAS_HW_BLOCK *pRest;
+    EAS_I32 top;
+
+    for (ppPrev = &hwInstData->pFreeList; (pBlock = *ppPrev) != NULL; ppPrev = &pBlock->s.pNext)
+    {
+        if (pBlock->s.units < units)
+            continue;
+
+        /* take the front of the block, the rest stays free */
+        if (pBlock->s.units == units)
+            *ppPrev = pBlock->s.pNext;
+        else
+        {
+            pRest = pBlock + units;
+            pRest->s.units = pBlock->s.units - units;
+            pRest->s.pNext = pBlock->s.pNext;
+            *ppPrev = pRest;
+            pBlock->s.units = units;
+        }
+
+        top = (EAS_I32) ((pBlock - hwInstData->pArena) + units) * (EAS_I32) sizeof(EAS_HW_BLOCK);
+        if (top > hwInstData->highWater)
+            hwInstData->highWater = top;
+        return pBlock;
+    }
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ *
+ * ArenaFree
+ *
+ * Returns a block to the arena free list, merging it with its neighbours
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ArenaFree (EAS_HW_DATA_HANDLE hwInstData, EAS_HW_BLOCK *pBlock)
+{
+    EAS_HW_BLOCK *pPrev;
+    EAS_HW_BLOCK *pNext;
+
+    /* find the free blocks on either side */
+    pPrev = NULL;
+    pNext = hwInstData->pFreeList;
+    while ((pNext != NULL) && (pNext < pBlock))
+    {
+        pPrev = pNext;
+        pNext = pNext->s.pNext;
+    }
+
+    /* merge with the following block */
+    if ((pNext != NULL) && (pBlock + pBlock->s.units == pNext))
+    {
+        pBlock->s.units += pNext->s.units;
+        pBlock->s.pNext = pNext->s.pNext;
+    }
+    else
+        pBlock->s.pNext = pNext;
+
+    /* merge with the preceding block */
+    if (pPrev == NULL)
+        hwInstData->pFreeList = pBlock;
+    else if (pPrev + pPrev->s.units == pBlock)
+    {
+        pPrev->s.units += pBlock->s.units;
+        pPrev->s.pNext = pBlock->s.pNext;
+    }
+    else
+        pPrev->s.pNext = pBlock;
+}
+#endif
+
+#ifdef _HW_ALLOC_GUARD
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWSetAllocGuard
+ *
+ * While the guard is set, any call to EAS_HWMalloc is reported and fails,
+ * and any call to EAS_HWFree is reported
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_HWSetAllocGuard (EAS_HW_DATA_HANDLE hwInstData, EAS_BOOL enable)
+{
+    hwInstData->allocGuard = enable;
+}
+#endif
+
 /*----------------------------------------------------------------------------
  *
  * EAS_HWMalloc
@@ -157,7 +347,40 @@ void *EAS_HWMalloc (EAS_HW_DATA_HANDLE hwInstData, EAS_I32 size)
      * negative or 0 values through */
     if (size <= 0)
       return NULL;
+#ifdef _HW_ALLOC_GUARD
+    if (hwInstData->allocGuard)
+    {
+        EAS_ReportEx(_EAS_SEVERITY_NOFILTER, 0x1a54b6e8, 0x00000007 , size);
+        return NULL;
+    }
+#endif
+#ifdef _HW_MEMORY_ARENA
+    {
+        EAS_HW_BLOCK *pBlock;
+        EAS_I32 units;
+
+        if ((size_t) size > (size_t) INT_MAX - 2 * sizeof(EAS_HW_BLOCK))
+            return NULL;
+        units = (EAS_I32) ((size + sizeof(EAS_HW_BLOCK) - 1) / sizeof(EAS_HW_BLOCK)) + 1;
+
+        /* try the arena first */
+        pBlock = ArenaAlloc(hwInstData, units);
+        if (pBlock == NULL)
+        {
+            pBlock = malloc((size_t) units * sizeof(EAS_HW_BLOCK));
+            if (pBlock == NULL)
+                return NULL;
+            pBlock->s.units = units;
+        }
+
+        hwInstData->curBytes += units * (EAS_I32) sizeof(EAS_HW_BLOCK);
+        if (hwInstData->curBytes > hwInstData->peakBytes)
+            hwInstData->peakBytes = hwInstData->curBytes;
+        return pBlock + 1;
+    }
+#else
     return malloc((size_t) size);
+#endif
 }
 
 /*----------------------------------------------------------------------------
@@ -171,7 +394,27 @@ void *EAS_HWMalloc (EAS_HW_DATA_HANDLE hwInstData, EAS_I32 size)
 /*lint -esym(715, hwInstData) hwInstData available for customer use */
 void EAS_HWFree (EAS_HW_DATA_HANDLE hwInstData, void *p)
 {
+#ifdef _HW_ALLOC_GUARD
+    /* memory is released by the calls that allocated it, never while rendering */
+    if (hwInstData->allocGuard && (p != NULL))
+        EAS_ReportEx(_EAS_SEVERITY_NOFILTER, 0x1a54b6e8, 0x00000008);
+#endif
+#ifdef _HW_MEMORY_ARENA
+    EAS_HW_BLOCK *pBlock;
+
+    if (p == NULL)
+        return;
+    pBlock = (EAS_HW_BLOCK*) p - 1;
+    hwInstData->curBytes -= pBlock->s.units * (EAS_I32) sizeof(EAS_HW_BLOCK);
+
+    /* blocks outside the arena came from malloc */
+    if ((hwInstData->pArena != NULL) && (pBlock >= hwInstData->pArena) && (pBlock < hwInstData->pArena + hwInstData->arenaUnits))
+        ArenaFree(hwInstData, pBlock);
+    else
+        free(pBlock);
+#else
     free(p);
+#endif
 }
 
 /*----------------------------------------------------------------------------
@@ -564,6 +807,27 @@ EAS_RESULT EAS_HWBackLight (EAS_HW_DATA_HANDLE hwInstData, EAS_BOOL state)
     return EAS_SUCCESS;
 }
 
+#ifdef _ADAPTIVE_POLYPHONY
+/*----------------------------------------------------------------------------
+ *
+ * EAS_HWGetTime
+ *
+ * Returns a monotonic time stamp in microseconds. It is 64 bits wide so
+ * that it does not wrap, a 32-bit count would wrap every 71 minutes.
+ *
+ *----------------------------------------------------------------------------
+*/
+/*lint -esym(715, hwInstData) hwInstData available for customer use */
+uint64_t EAS_HWGetTime (EAS_HW_DATA_HANDLE hwInstData)
+{
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+        return 0;
+    return (uint64_t) ts.tv_sec * 1000000 + (uint64_t) (ts.tv_nsec / 1000);
+}
+#endif
+
 /*----------------------------------------------------------------------------
  *
  * EAS_HWYield
@@ -38,7 +38,8 @@ typedef enum
     EAS_PARAM_REVERB_BYPASS,
     EAS_PARAM_REVERB_PRESET,
     EAS_PARAM_REVERB_WET,
-    EAS_PARAM_REVERB_DRY
+    EAS_PARAM_REVERB_DRY,
+    EAS_PARAM_REVERB_HALF_RATE      /* EAS_TRUE runs the reverb at half the output rate, always with _REVERB_HALF_RATE */
 } E_REVERB_PARAMS;
 
 
@@ -0,0 +1 @@
+../../host_src/eas_chorus.h
\ No newline at end of file
@@ -0,0 +1,580 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * eas_chorus.c
+ *
+ * Contents and purpose:
+ * Contains the implementation of the Chorus effect. A mono sum of the input
+ * feeds a single delay line that is read by two taps, one per output
+ * channel, whose delays are swept by a triangle LFO a quarter period apart.
+ *
+ *
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+/*------------------------------------
+ * includes
+ *------------------------------------
+*/
+
+#include <stdint.h>
+
+#include "eas_data.h"
+#include "eas_effects.h"
+#include "eas_math.h"
+#include "eas_chorusdata.h"
+#include "eas_chorus.h"
+#include "eas_config.h"
+#include "eas_host.h"
+#include "eas_report.h"
+
+/* prototypes for effects interface */
+static EAS_RESULT ChorusInit (EAS_DATA_HANDLE pEASData, EAS_VOID_PTR *pInstData);
+static void ChorusProcess (EAS_VOID_PTR pInstData, EAS_PCM *pSrc, EAS_PCM *pDst, EAS_I32 numSamples);
+static EAS_RESULT ChorusShutdown (EAS_DATA_HANDLE pEASData, EAS_VOID_PTR pInstData);
+static EAS_RESULT ChorusGetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 *pValue);
+static EAS_RESULT ChorusSetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 value);
+static void ChorusProcess32 (EAS_VOID_PTR pInstData, EAS_I32 *pMix, EAS_I32 numSamples);
+
+#ifdef _CHORUS
+static void ChorusProcessSend (EAS_VOID_PTR pInstData, EAS_I32 *pSend, EAS_I32 *pMix, EAS_I32 numSamples);
+#endif
+
+/* 32-bit processing */
+static void ChorusProcessBus (S_CHORUS_OBJECT *pChorusData, const EAS_I32 *pSend, EAS_I32 *pMix, EAS_I32 numSamples, EAS_I32 nShift);
+static void ChorusTap (const EAS_PCM *pLine, EAS_I32 *pMix, EAS_I32 nDelay, EAS_I32 nDelayInc, EAS_I32 nLevel, EAS_I32 nShift, EAS_I32 numSamples);
+static EAS_I32 ChorusLfoDelay (const S_CHORUS_OBJECT *pChorusData, EAS_U32 nPhase);
+static EAS_U32 ChorusAdvancePhase (EAS_U32 nPhase, EAS_U32 nIncrement, EAS_I32 numSamples);
+static void ChorusUpdateParams (S_CHORUS_OBJECT *pChorusData);
+
+/* common effects interface for configuration module */
+const S_EFFECTS_INTERFACE EAS_Chorus =
+{
+    ChorusInit,
+    ChorusProcess,
+    ChorusShutdown,
+    ChorusGetParam,
+    ChorusSetParam,
+    ChorusProcess32,
+    EAS_PARAM_CHORUS_BYPASS
+#ifdef _INSTANCE_POOL
+    , sizeof(S_CHORUS_OBJECT)
+#endif
+#if defined(_REVERB) || defined(_CHORUS)
+#ifdef _CHORUS
+    , ChorusProcessSend
+#else
+    , NULL
+#endif
+#endif
+};
+
+/* rate, depth, level for each of E_CHORUS_PRESETS */
+static const S_CHORUS_PRESET chorusPresets[CHORUS_MAX_TYPE] =
+{
+    {  6, 20, 16384 },      /* gentle, slow sweep */
+    { 10, 30, 20000 },      /* standard chorus */
+    {  3, 45, 22000 },      /* slow and deep, ensemble */
+    { 30, 10, 12000 }       /* fast and shallow, shimmer */
+};
+
+/*----------------------------------------------------------------------------
+ * ChorusInit()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Initializes the Chorus effect.
+ *
+ * Inputs:
+ * pEASData         - instance data
+ * pInstData        - receives the handle to the chorus instance data
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT ChorusInit (EAS_DATA_HANDLE pEASData, EAS_VOID_PTR *pInstData)
+{
+    S_CHORUS_OBJECT *pChorusData;
+
+    /* check Configuration Module for data allocation */
+    if (pEASData->staticMemoryModel)
+        pChorusData = EAS_CMEnumFXData(EAS_MODULE_CHORUS);
+
+    /* allocate dynamic memory */
+    else
+        pChorusData = EAS_HWMalloc(pEASData->hwInstData, sizeof(S_CHORUS_OBJECT));
+
+    if (pChorusData == NULL)
+    {
+        { /* dpp: EAS_ReportEx(_EAS_SEVERITY_FATAL, "Failed to allocate Chorus memory\n"); */ }
+        return EAS_ERROR_MALLOC_FAILED;
+    }
+
+    /* clear the structure, this also clears the delay line */
+    EAS_HWMemSet(pChorusData, 0, sizeof(S_CHORUS_OBJECT));
+
+#ifndef _CHORUS
+    /* without a send bus the whole mix would be chorused, so it is off until the application enables it */
+    pChorusData->m_bBypass = EAS_TRUE;
+#endif
+    pChorusData->m_bIdle = EAS_TRUE;
+
+    pChorusData->m_nCurrentPreset = EAS_PARAM_CHORUS_PRESET1;
+    pChorusData->m_nRate = chorusPresets[EAS_PARAM_CHORUS_PRESET1].m_nRate;
+    pChorusData->m_nDepth = chorusPresets[EAS_PARAM_CHORUS_PRESET1].m_nDepth;
+    pChorusData->m_nLevel = chorusPresets[EAS_PARAM_CHORUS_PRESET1].m_nLevel;
+    ChorusUpdateParams(pChorusData);
+
+    *pInstData = pChorusData;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * ChorusProcess()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Adds the chorus to a 16-bit buffer, for builds that run the chorus after
+ * the final conversion to 16 bits.
+ *
+ * Inputs:
+ * pSrc             - source buffer, interleaved
+ * pDst             - destination buffer, may be the same as pSrc
+ * numSamples       - number of samples per channel
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ChorusProcess (EAS_VOID_PTR pInstData, EAS_PCM *pSrc, EAS_PCM *pDst, EAS_I32 numSamples)
+{
+    S_CHORUS_OBJECT *pChorusData;
+    EAS_I32 nMix[NUM_OUTPUT_CHANNELS * CHORUS_BLOCK_SIZE];
+    EAS_I32 n;
+    EAS_I32 i;
+    EAS_I32 tempValue;
+
+    pChorusData = (S_CHORUS_OBJECT*) pInstData;
+
+    for (; numSamples > 0; numSamples -= n)
+    {
+        n = (numSamples < CHORUS_BLOCK_SIZE) ? numSamples : CHORUS_BLOCK_SIZE;
+
+        for (i = 0; i < n * NUM_OUTPUT_CHANNELS; i++)
+            nMix[i] = pSrc[i];
+
+        ChorusProcessBus(pChorusData, nMix, nMix, n, 0);
+
+        for (i = 0; i < n * NUM_OUTPUT_CHANNELS; i++)
+        {
+            tempValue = nMix[i];
+            pDst[i] = (EAS_PCM) SATURATE(tempValue);
+        }
+
+        pSrc += n * NUM_OUTPUT_CHANNELS;
+        pDst += n * NUM_OUTPUT_CHANNELS;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * ChorusProcess32()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Adds the chorus to the 32-bit mix buffer in place, after the master gain
+ * and before the final conversion to 16 bits. Used when there is no chorus
+ * send bus, so the whole mix is sent to the chorus.
+ *
+ * Inputs:
+ * pMix             - mix buffer, interleaved
+ * numSamples       - number of samples per channel
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ * - wet signal is added to the mix buffer
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ChorusProcess32 (EAS_VOID_PTR pInstData, EAS_I32 *pMix, EAS_I32 numSamples)
+{
+    ChorusProcessBus((S_CHORUS_OBJECT*) pInstData, pMix, pMix, numSamples, 0);
+}
+
+#ifdef _CHORUS
+/*----------------------------------------------------------------------------
+ * ChorusProcessSend()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Runs the chorus send bus (CC93) through the chorus and adds the wet
+ * signal to the mix buffer. Both buffers are in the 32-bit mix domain,
+ * before the master gain, see CHORUS_SEND_SHIFT.
+ *
+ * Inputs:
+ * pSend            - chorus send bus, interleaved stereo
+ * pMix             - mix buffer, interleaved stereo
+ * numSamples       - number of samples per channel
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ * - wet signal is added to the mix buffer
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ChorusProcessSend (EAS_VOID_PTR pInstData, EAS_I32 *pSend, EAS_I32 *pMix, EAS_I32 numSamples)
+{
+    ChorusProcessBus((S_CHORUS_OBJECT*) pInstData, pSend, pMix, numSamples, CHORUS_SEND_SHIFT);
+}
+#endif
+
+/*----------------------------------------------------------------------------
+ * ChorusProcessBus()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Writes the mono sum of a 32-bit input into the 16-bit delay line and adds
+ * the output of the two modulated taps to a 32-bit mix buffer. The input is
+ * scaled down by nShift and the wet signal scaled back up. pSend and pMix
+ * may be the same buffer.
+ *
+ * The LFO is only evaluated once per block of CHORUS_BLOCK_SIZE samples,
+ * the tap delays are ramped linearly between the block boundaries. Each
+ * span stops at the end of the delay line, so the taps read contiguous
+ * samples from the mirrored line without any masking.
+ *
+ * Inputs:
+ * pSend            - input, interleaved
+ * pMix             - mix buffer, interleaved
+ * numSamples       - number of samples per channel
+ * nShift           - level of the input relative to the 16-bit delay line
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ChorusProcessBus (S_CHORUS_OBJECT *pChorusData, const EAS_I32 *pSend, EAS_I32 *pMix, EAS_I32 numSamples, EAS_I32 nShift)
+{
+    EAS_PCM *pLine;
+    EAS_I32 nOr;
+    EAS_I32 nDelayL;
+    EAS_I32 nTargetL;
+#if (NUM_OUTPUT_CHANNELS == 2)
+    EAS_I32 nDelayR;
+    EAS_I32 nTargetR;
+#endif
+    EAS_I32 nWrite;
+    EAS_I32 n;
+    EAS_I32 i;
+    EAS_I32 tempValue;
+
+    // nothing to add if bypassed or the wet signal is off
+    if (pChorusData->m_bBypass || (pChorusData->m_nLevel == 0))
+        return;
+
+    nOr = 0;
+    for (i = 0; i < numSamples * NUM_OUTPUT_CHANNELS; i++)
+        nOr |= pSend[i];
+
+    //once the delay line holds nothing but silence, skip it until there is input again
+    if (nOr == 0)
+    {
+        if (pChorusData->m_bIdle)
+        {
+            pChorusData->m_nLfoPhase = ChorusAdvancePhase(pChorusData->m_nLfoPhase, pChorusData->m_nLfoIncrement, numSamples);
+            return;
+        }
+        pChorusData->m_nIdleCount += numSamples;
+    }
+    else
+    {
+        pChorusData->m_bIdle = EAS_FALSE;
+        pChorusData->m_nIdleCount = 0;
+    }
+
+    nWrite = pChorusData->m_nWrite;
+    nDelayL = ChorusLfoDelay(pChorusData, pChorusData->m_nLfoPhase);
+#if (NUM_OUTPUT_CHANNELS == 2)
+    nDelayR = ChorusLfoDelay(pChorusData, ChorusAdvancePhase(pChorusData->m_nLfoPhase, 0x40000000, 1));
+#endif
+
+    for (; numSamples > 0; numSamples -= n)
+    {
+        n = (numSamples < CHORUS_BLOCK_SIZE) ? numSamples : CHORUS_BLOCK_SIZE;
+        if (n > CHORUS_DELAY_LINE_SIZE - nWrite)
+            n = CHORUS_DELAY_LINE_SIZE - nWrite;
+
+        /* write the input for this span to both copies of the delay line */
+        pLine = &pChorusData->m_nDelayLine[nWrite];
+        for (i = 0; i < n; i++)
+        {
+#if (NUM_OUTPUT_CHANNELS == 2)
+            /*lint -e{702} use shift for performance */
+            tempValue = (pSend[2 * i] + pSend[2 * i + 1]) >> (nShift + 1);
+#else
+            /*lint -e{702} use shift for performance */
+            tempValue = pSend[i] >> nShift;
+#endif
+            tempValue = SATURATE(tempValue);
+            pLine[i] = (EAS_PCM) tempValue;
+            pLine[i + CHORUS_DELAY_LINE_SIZE] = (EAS_PCM) tempValue;
+        }
+
+        /* evaluate the LFO at the end of the span and ramp the taps to it */
+        pChorusData->m_nLfoPhase = ChorusAdvancePhase(pChorusData->m_nLfoPhase, pChorusData->m_nLfoIncrement, n);
+        pLine += CHORUS_DELAY_LINE_SIZE;
+        nTargetL = ChorusLfoDelay(pChorusData, pChorusData->m_nLfoPhase);
+        ChorusTap(pLine, pMix, nDelayL, (nTargetL - nDelayL) / n, pChorusData->m_nLevel, nShift, n);
+        nDelayL = nTargetL;
+#if (NUM_OUTPUT_CHANNELS == 2)
+        /* the right tap runs a quarter period ahead */
+        nTargetR = ChorusLfoDelay(pChorusData, ChorusAdvancePhase(pChorusData->m_nLfoPhase, 0x40000000, 1));
+        ChorusTap(pLine, pMix + 1, nDelayR, (nTargetR - nDelayR) / n, pChorusData->m_nLevel, nShift, n);
+        nDelayR = nTargetR;
+#endif
+
+        nWrite = (nWrite + n) & CHORUS_DELAY_LINE_MASK;
+        pSend += n * NUM_OUTPUT_CHANNELS;
+        pMix += n * NUM_OUTPUT_CHANNELS;
+    }
+
+    pChorusData->m_nWrite = nWrite;
+
+    // every sample the taps can reach is zero now
+    if (pChorusData->m_nIdleCount >= CHORUS_DELAY_LINE_SIZE)
+        pChorusData->m_bIdle = EAS_TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * ChorusTap()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Reads one tap of the delay line with linear interpolation and adds it,
+ * scaled by the wet level, to one channel of the mix buffer.
+ *
+ * Inputs:
+ * pLine            - upper copy of the delay line at the first sample of the span
+ * pMix             - first sample of the channel in the mix buffer
+ * nDelay           - tap delay at the start of the span, 16.16 samples
+ * nDelayInc        - change of the tap delay per sample
+ * nLevel           - wet level, 1.15 format
+ * nShift           - output scaling, see ChorusProcessBus
+ * numSamples       - number of samples
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ChorusTap (const EAS_PCM *pLine, EAS_I32 *pMix, EAS_I32 nDelay, EAS_I32 nDelayInc, EAS_I32 nLevel, EAS_I32 nShift, EAS_I32 numSamples)
+{
+    const EAS_PCM *pTap;
+    EAS_I32 nFrac;
+    EAS_I32 i;
+    EAS_I32 tempValue;
+
+    for (i = 0; i < numSamples; i++)
+    {
+        /*lint -e{704} use shift for performance */
+        pTap = pLine + i - (nDelay >> 16);
+        nFrac = (nDelay >> 1) & 0x7fff;
+
+        /* interpolate toward the older sample by the fraction of the delay */
+        /*lint -e{704} use shift for performance */
+        tempValue = pTap[0] + (((pTap[-1] - pTap[0]) * nFrac) >> 15);
+        /*lint -e{704} use shift for performance */
+        tempValue = (tempValue * nLevel) >> 15;
+        pMix[i * NUM_OUTPUT_CHANNELS] += tempValue * (1 << nShift);
+
+        nDelay += nDelayInc;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * ChorusLfoDelay()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns the tap delay for an LFO phase, in 16.16 samples. The triangle
+ * sweeps the delay from CHORUS_BASE_DELAY up by the depth and back.
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_I32 ChorusLfoDelay (const S_CHORUS_OBJECT *pChorusData, EAS_U32 nPhase)
+{
+    EAS_U32 nTriangle;
+
+    /* fold the phase into a 0 to 1 triangle, 0.16 format */
+    if (nPhase & 0x80000000UL)
+        nPhase = ~nPhase & 0x7fffffffUL;
+    nTriangle = nPhase >> 15;
+
+    return (EAS_I32) (CHORUS_BASE_DELAY << 16) +
+        (EAS_I32) ((pChorusData->m_nDepthSamples * nTriangle) >> 8);
+}
+
+/*----------------------------------------------------------------------------
+ * ChorusAdvancePhase()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Advances an LFO phase by numSamples increments. The phase wraps at 2^32,
+ * the sum is formed in 64 bits and masked so that it never overflows,
+ * whether EAS_U32 is 32 or 64 bits wide.
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_U32 ChorusAdvancePhase (EAS_U32 nPhase, EAS_U32 nIncrement, EAS_I32 numSamples)
+{
+    return (EAS_U32) (((uint64_t) nPhase + (uint64_t) nIncrement * (uint64_t) numSamples) & 0xffffffffUL);
+}
+
+/*----------------------------------------------------------------------------
+ * ChorusUpdateParams()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Converts the rate and depth parameters to the LFO increment and the sweep
+ * depth in samples. A change takes effect at the next span boundary, the
+ * tap delays ramp to the new sweep.
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ChorusUpdateParams (S_CHORUS_OBJECT *pChorusData)
+{
+    /* 2^32 per period, rate is in 0.1 Hz */
+    pChorusData->m_nLfoIncrement = (0xffffffffUL / _OUTPUT_SAMPLE_RATE) * (EAS_U32) pChorusData->m_nRate / 10;
+
+    /* depth is in 0.1 ms, 24.8 format */
+    pChorusData->m_nDepthSamples = ((EAS_U32) pChorusData->m_nDepth * _OUTPUT_SAMPLE_RATE * 256) / 10000;
+}
+
+/*----------------------------------------------------------------------------
+ * ChorusShutdown()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Shuts down the Chorus effect.
+ *
+ * Inputs:
+ * pInstData        - handle to instance data
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT ChorusShutdown (EAS_DATA_HANDLE pEASData, EAS_VOID_PTR pInstData)
+{
+    /* check Configuration Module for static memory allocation */
+    if (!pEASData->staticMemoryModel)
+        EAS_HWFree(pEASData->hwInstData, pInstData);
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * ChorusGetParam()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Get a Chorus parameter
+ *
+ * Inputs:
+ * pInstData        - handle to instance data
+ * param            - parameter index
+ * *pValue          - pointer to variable to hold retrieved value
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT ChorusGetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 *pValue)
+{
+    S_CHORUS_OBJECT *p;
+
+    p = (S_CHORUS_OBJECT*) pInstData;
+
+    switch (param)
+    {
+        case EAS_PARAM_CHORUS_BYPASS:
+            *pValue = (EAS_I32) p->m_bBypass;
+            break;
+        case EAS_PARAM_CHORUS_PRESET:
+            *pValue = p->m_nCurrentPreset;
+            break;
+        case EAS_PARAM_CHORUS_RATE:
+            *pValue = p->m_nRate;
+            break;
+        case EAS_PARAM_CHORUS_DEPTH:
+            *pValue = p->m_nDepth;
+            break;
+        case EAS_PARAM_CHORUS_LEVEL:
+            *pValue = p->m_nLevel;
+            break;
+        default:
+            return EAS_ERROR_INVALID_PARAMETER;
+    }
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * ChorusSetParam()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Set a Chorus parameter
+ *
+ * Inputs:
+ * pInstData        - handle to instance data
+ * param            - parameter index
+ * value            - new parameter value
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT ChorusSetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 value)
+{
+    S_CHORUS_OBJECT *p;
+
+    p = (S_CHORUS_OBJECT*) pInstData;
+
+    switch (param)
+    {
+        case EAS_PARAM_CHORUS_BYPASS:
+            p->m_bBypass = (EAS_BOOL) value;
+            break;
+        case EAS_PARAM_CHORUS_PRESET:
+            if ((value < EAS_PARAM_CHORUS_PRESET1) || (value >= CHORUS_MAX_TYPE))
+                return EAS_ERROR_INVALID_PARAMETER;
+            p->m_nCurrentPreset = (EAS_I16) value;
+            p->m_nRate = chorusPresets[value].m_nRate;
+            p->m_nDepth = chorusPresets[value].m_nDepth;
+            p->m_nLevel = chorusPresets[value].m_nLevel;
+            break;
+        case EAS_PARAM_CHORUS_RATE:
+            if ((value > EAS_CHORUS_RATE_MAX) || (value < EAS_CHORUS_RATE_MIN))
+                return EAS_ERROR_INVALID_PARAMETER;
+            p->m_nRate = (EAS_I16) value;
+            break;
+        case EAS_PARAM_CHORUS_DEPTH:
+            if ((value > EAS_CHORUS_DEPTH_MAX) || (value < EAS_CHORUS_DEPTH_MIN))
+                return EAS_ERROR_INVALID_PARAMETER;
+            p->m_nDepth = (EAS_I16) value;
+            break;
+        case EAS_PARAM_CHORUS_LEVEL:
+            if ((value > EAS_CHORUS_LEVEL_MAX) || (value < EAS_CHORUS_LEVEL_MIN))
+                return EAS_ERROR_INVALID_PARAMETER;
+            p->m_nLevel = (EAS_I16) value;
+            break;
+        default:
+            return EAS_ERROR_INVALID_PARAMETER;
+    }
+
+    ChorusUpdateParams(p);
+    return EAS_SUCCESS;
+}
+
@@ -0,0 +1,104 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * eas_chorusdata.h
+ *
+ * Contents and purpose:
+ * Contains the data structures and defines for the Chorus effect.
+ *
+ *
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#ifndef _EAS_CHORUSDATA_H
+#define _EAS_CHORUSDATA_H
+
+#include "eas_types.h"
+#include "eas_audioconst.h"
+
+/*------------------------------------
+ * defines
+ *------------------------------------
+*/
+
+// the delay line holds the longest modulated delay plus one block,
+// it MUST be a power of two
+#if (_OUTPUT_SAMPLE_RATE > 24000)
+#define CHORUS_DELAY_LINE_SIZE          1024
+#else
+#define CHORUS_DELAY_LINE_SIZE          512
+#endif
+#define CHORUS_DELAY_LINE_MASK          (CHORUS_DELAY_LINE_SIZE - 1)
+
+#define CHORUS_BLOCK_SIZE               32  // the LFO is computed once per block of this many samples
+
+// the tap delay sweeps from CHORUS_BASE_DELAY up to CHORUS_BASE_DELAY + depth
+#define CHORUS_BASE_DELAY               ((12 * _OUTPUT_SAMPLE_RATE) / 1000)    // 12 ms, in samples
+
+#ifdef _CHORUS
+// the send bus is in the 32-bit mix domain, which is about 2^5 times the 16-bit output
+#define CHORUS_SEND_SHIFT               5
+#endif
+
+/* parameter ranges */
+#define EAS_CHORUS_RATE_MIN             1       // LFO rate in 0.1 Hz
+#define EAS_CHORUS_RATE_MAX             50
+#define EAS_CHORUS_DEPTH_MIN            0       // sweep depth in 0.1 ms
+#define EAS_CHORUS_DEPTH_MAX            50
+#define EAS_CHORUS_LEVEL_MIN            0       // gain for the wet signal
+#define EAS_CHORUS_LEVEL_MAX            32767
+
+#define CHORUS_MAX_TYPE                 4       // any preset numbers larger than this are invalid
+
+/*------------------------------------
+ * data structures
+ *------------------------------------
+*/
+
+typedef struct
+{
+    EAS_I16             m_nRate;
+    EAS_I16             m_nDepth;
+    EAS_I16             m_nLevel;
+
+} S_CHORUS_PRESET;
+
+typedef struct
+{
+    EAS_BOOL            m_bBypass;                  // if EAS_TRUE, then bypass chorus and copy input to output
+
+    EAS_I16             m_nCurrentPreset;           // preset number last selected
+
+    EAS_I16             m_nRate;                    // LFO rate in 0.1 Hz
+    EAS_I16             m_nDepth;                   // sweep depth in 0.1 ms
+    EAS_I16             m_nLevel;                   // gain for wet (processed) signal
+
+    EAS_U32             m_nLfoPhase;                // LFO phase, one period is 2^32
+    EAS_U32             m_nLfoIncrement;            // LFO phase increment per sample
+    EAS_U32             m_nDepthSamples;            // sweep depth in samples, 24.8 fixed point
+
+    EAS_BOOL            m_bIdle;                    // if EAS_TRUE, the delay line is silent and processing is skipped
+    EAS_I32             m_nIdleCount;               // samples of silent input written to the delay line
+
+    EAS_I32             m_nWrite;                   // delay line write index
+
+    // each sample is written twice, SIZE apart, so the taps for a block never wrap
+    EAS_PCM             m_nDelayLine[2 * CHORUS_DELAY_LINE_SIZE];
+
+} S_CHORUS_OBJECT;
+
+#endif /* _EAS_CHORUSDATA_H */
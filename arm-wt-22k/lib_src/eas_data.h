@@ -96,6 +96,12 @@ typedef struct s_eas_data_tag
 
     S_EFFECTS_MODULE                effectsModules[NUM_EFFECTS_MODULES];
 
+    /* enabled effects modules in processing order, see EAS_MixEngineUpdateChain */
+    EAS_U8                          fxChain[NUM_EFFECTS_MODULES];
+    EAS_U8                          numFxSend;
+    EAS_U8                          numFx32;
+    EAS_U8                          numFx;
+
 #ifdef _METRICS_ENABLED
     S_METRICS_INTERFACE             *pMetricsModule;
     EAS_VOID_PTR                    pMetricsData;
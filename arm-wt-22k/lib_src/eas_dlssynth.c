@@ -65,10 +65,10 @@ void DLS_MuteVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoi
         VOICE_FLAG_DEFER_MUTE);
 
     /* set the envelope state */
-    pVoiceMgr->wtVoices[voiceNum].eg1State = eEnvelopeStateRelease;
-    pWTVoice->eg1Increment = pDLSArt->eg1ShutdownTime;
-    pVoiceMgr->wtVoices[voiceNum].eg2State = eEnvelopeStateRelease;
-    pWTVoice->eg2Increment = pDLSArt->eg2.releaseTime;
+    pVoiceMgr->wtControl.eg1State[voiceNum] = eEnvelopeStateRelease;
+    pVoiceMgr->wtControl.eg1Increment[voiceNum] = pDLSArt->eg1ShutdownTime;
+    pVoiceMgr->wtControl.eg2State[voiceNum] = eEnvelopeStateRelease;
+    pVoiceMgr->wtControl.eg2Increment[voiceNum] = pDLSArt->eg2.releaseTime;
 }
 
 /*----------------------------------------------------------------------------
@@ -80,25 +80,25 @@ void DLS_MuteVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoi
 /*lint -esym(715, pVoice) standard API, pVoice may be used by other synthesizers */
 void DLS_ReleaseVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, EAS_I32 voiceNum)
 {
-    S_WT_VOICE *pWTVoice;
+    S_WT_CONTROL *pControl;
     const S_DLS_ARTICULATION *pDLSArt;
 
-    pWTVoice = &pVoiceMgr->wtVoices[voiceNum];
-    pDLSArt = &pSynth->pDLS->pDLSArticulations[pWTVoice->artIndex];
+    pControl = &pVoiceMgr->wtControl;
+    pDLSArt = &pSynth->pDLS->pDLSArticulations[pVoiceMgr->wtVoices[voiceNum].artIndex];
 
     /* if still in attack phase, convert units to log */
     /*lint -e{732} eg1Value is never negative */
     /*lint -e{703} use shift for performance */
-    if (pWTVoice->eg1State == eEnvelopeStateAttack)
-        pWTVoice->eg1Value = (EAS_I16) ((EAS_flog2(pWTVoice->eg1Value) << 1) + 2048);
+    if (pControl->eg1State[voiceNum] == eEnvelopeStateAttack)
+        pControl->eg1Value[voiceNum] = (EAS_I16) ((EAS_flog2(pControl->eg1Value[voiceNum]) << 1) + 2048);
 
     /* release EG1 */
-    pWTVoice->eg1State = eEnvelopeStateRelease;
-    pWTVoice->eg1Increment = pDLSArt->eg1.releaseTime;
+    pControl->eg1State[voiceNum] = eEnvelopeStateRelease;
+    pControl->eg1Increment[voiceNum] = pDLSArt->eg1.releaseTime;
 
     /* release EG2 */
-    pWTVoice->eg2State = eEnvelopeStateRelease;
-    pWTVoice->eg2Increment = pDLSArt->eg2.releaseTime;
+    pControl->eg2State[voiceNum] = eEnvelopeStateRelease;
+    pControl->eg2Increment[voiceNum] = pDLSArt->eg2.releaseTime;
 }
 
 /*----------------------------------------------------------------------------
@@ -118,11 +118,11 @@ void DLS_SustainPedal (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *p
     pDLSArt = &pSynth->pDLS->pDLSArticulations[pWTVoice->artIndex];
 
     /* don't catch the voice if below the sustain level */
-    if (pWTVoice->eg1Value < pDLSArt->eg1.sustainLevel)
+    if (pVoiceMgr->wtControl.eg1Value[voiceNum] < pDLSArt->eg1.sustainLevel)
         return;
 
     /* defer releasing this note until the damper pedal is off */
-    pWTVoice->eg1State = eEnvelopeStateDecay;
+    pVoiceMgr->wtControl.eg1State[voiceNum] = eEnvelopeStateDecay;
     pVoice->voiceState = eVoiceStatePlay;
     pVoice->voiceFlags |= VOICE_FLAG_SUSTAIN_PEDAL_DEFER_NOTE_OFF;
 
@@ -137,7 +137,7 @@ void DLS_SustainPedal (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *p
  * Calculate the oscillator phase increment for the next frame
  *----------------------------------------------------------------------------
 */
-static EAS_I32 DLS_UpdatePhaseInc (S_WT_VOICE *pWTVoice, const S_DLS_ARTICULATION *pDLSArt, S_SYNTH_CHANNEL *pChannel, EAS_I32 pitchCents)
+static EAS_I32 DLS_UpdatePhaseInc (S_WT_CONTROL *pControl, EAS_I32 voiceNum, const S_DLS_ARTICULATION *pDLSArt, S_SYNTH_CHANNEL *pChannel, EAS_I32 pitchCents)
 {
     EAS_I32 temp;
 
@@ -153,7 +153,7 @@ static EAS_I32 DLS_UpdatePhaseInc (S_WT_VOICE *pWTVoice, const S_DLS_ARTICULATIO
     temp += ((pDLSArt->modLFOChanPressToPitch * pChannel->channelPressure) >> 7);
 
     /* add total mod LFO effect */
-    pitchCents += FMUL_15x15(temp, pWTVoice->modLFO.lfoValue);
+    pitchCents += FMUL_15x15(temp, pControl->modLFOValue[voiceNum]);
 
     /* start with base vib LFO modulation */
     temp = pDLSArt->vibLFOToPitch;
@@ -167,13 +167,18 @@ static EAS_I32 DLS_UpdatePhaseInc (S_WT_VOICE *pWTVoice, const S_DLS_ARTICULATIO
     temp += ((pDLSArt->vibLFOChanPressToPitch * pChannel->channelPressure) >> 7);
 
     /* add total vibrato LFO effect */
-    pitchCents += FMUL_15x15(temp, pWTVoice->vibLFO.lfoValue);
+    pitchCents += FMUL_15x15(temp, pControl->vibLFOValue[voiceNum]);
 
     /* add EG2 effect */
-    pitchCents += FMUL_15x15(pDLSArt->eg2ToPitch, pWTVoice->eg2Value);
+    pitchCents += FMUL_15x15(pDLSArt->eg2ToPitch, pControl->eg2Value[voiceNum]);
 
-    /* convert from cents to linear phase increment */
-    return EAS_Calculate2toX(pitchCents);
+    /* convert from cents to linear phase increment if the pitch has changed */
+    if (pitchCents != pControl->pitchCents[voiceNum])
+    {
+        pControl->pitchCents[voiceNum] = pitchCents;
+        pControl->phaseInc[voiceNum] = EAS_Calculate2toX(pitchCents);
+    }
+    return pControl->phaseInc[voiceNum];
 }
 
 /*----------------------------------------------------------------------------
@@ -182,7 +187,7 @@ static EAS_I32 DLS_UpdatePhaseInc (S_WT_VOICE *pWTVoice, const S_DLS_ARTICULATIO
  * Calculate the gain for the next frame
  *----------------------------------------------------------------------------
 */
-static EAS_I32 DLS_UpdateGain (S_WT_VOICE *pWTVoice, const S_DLS_ARTICULATION *pDLSArt, S_SYNTH_CHANNEL *pChannel, EAS_I32 gain, EAS_U8 velocity)
+static EAS_I32 DLS_UpdateGain (S_WT_CONTROL *pControl, EAS_I32 voiceNum, const S_DLS_ARTICULATION *pDLSArt, S_SYNTH_CHANNEL *pChannel, EAS_I32 gain, EAS_U8 velocity)
 {
     EAS_I32 temp;
 
@@ -198,21 +203,21 @@ static EAS_I32 DLS_UpdateGain (S_WT_VOICE *pWTVoice, const S_DLS_ARTICULATION *p
     temp += ((pDLSArt->modLFOChanPressToGain * pChannel->channelPressure) >> 7);
 
     /* add total mod LFO effect */
-    gain += FMUL_15x15(temp, pWTVoice->modLFO.lfoValue);
+    gain += FMUL_15x15(temp, pControl->modLFOValue[voiceNum]);
     if (gain > 0)
         gain = 0;
 
     /* convert to linear gain including EG1 */
-    if (pWTVoice->eg1State != eEnvelopeStateAttack)
+    if (pControl->eg1State[voiceNum] != eEnvelopeStateAttack)
     {
         gain = (DLS_GAIN_FACTOR * gain) >> DLS_GAIN_SHIFT;
         /*lint -e{702} use shift for performance */
 #if 1
-        gain += (pWTVoice->eg1Value - 32767) >> 1;
+        gain += (pControl->eg1Value[voiceNum] - 32767) >> 1;
         gain = EAS_LogToLinear16(gain);
 #else
         gain = EAS_LogToLinear16(gain);
-        temp = EAS_LogToLinear16((pWTVoice->eg1Value - 32767) >> 1);
+        temp = EAS_LogToLinear16((pControl->eg1Value[voiceNum] - 32767) >> 1);
         gain = FMUL_15x15(gain, temp);
 #endif
     }
@@ -220,7 +225,7 @@ static EAS_I32 DLS_UpdateGain (S_WT_VOICE *pWTVoice, const S_DLS_ARTICULATION *p
     {
         gain = (DLS_GAIN_FACTOR * gain) >> DLS_GAIN_SHIFT;
         gain = EAS_LogToLinear16(gain);
-        gain = FMUL_15x15(gain, pWTVoice->eg1Value);
+        gain = FMUL_15x15(gain, pControl->eg1Value[voiceNum]);
     }
 
     /* include MIDI channel gain */
@@ -244,7 +249,7 @@ static EAS_I32 DLS_UpdateGain (S_WT_VOICE *pWTVoice, const S_DLS_ARTICULATION *p
  * Update the Filter parameters
  *----------------------------------------------------------------------------
 */
-static void DLS_UpdateFilter (S_SYNTH_VOICE *pVoice, S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pIntFrame, S_SYNTH_CHANNEL *pChannel, const S_DLS_ARTICULATION *pDLSArt)
+static void DLS_UpdateFilter (S_SYNTH_VOICE *pVoice, S_WT_CONTROL *pControl, EAS_I32 voiceNum, S_WT_INT_FRAME *pIntFrame, S_SYNTH_CHANNEL *pChannel, const S_DLS_ARTICULATION *pDLSArt)
 {
     EAS_I32 cutoff;
     EAS_I32 temp;
@@ -271,10 +276,10 @@ static void DLS_UpdateFilter (S_SYNTH_VOICE *pVoice, S_WT_VOICE *pWTVoice, S_WT_
     temp += ((pDLSArt->modLFOChanPressToFc* pChannel->channelPressure) >> 7);
 
     /* add total mod LFO effect */
-    cutoff += FMUL_15x15(temp, pWTVoice->modLFO.lfoValue);
+    cutoff += FMUL_15x15(temp, pControl->modLFOValue[voiceNum]);
 
     /* add EG2 effect */
-    cutoff += FMUL_15x15(pWTVoice->eg2Value, pDLSArt->eg2ToFc);
+    cutoff += FMUL_15x15(pControl->eg2Value[voiceNum], pDLSArt->eg2ToFc);
 
     /* add velocity effect */
     /*lint -e{702} use shift for performance */
@@ -293,9 +298,14 @@ static void DLS_UpdateFilter (S_SYNTH_VOICE *pVoice, S_WT_VOICE *pWTVoice, S_WT_
     else if (cutoff < FILTER_CUTOFF_MIN_PITCH_CENTS)
         cutoff = FILTER_CUTOFF_MIN_PITCH_CENTS;
 
-    WT_SetFilterCoeffs(pIntFrame, cutoff, pDLSArt->filterQandFlags & FILTER_Q_MASK);
+    WT_UpdateFilterCoeffs(pControl, voiceNum, pIntFrame, cutoff, pDLSArt->filterQandFlags & FILTER_Q_MASK);
 }
 
+#ifdef _DLS_LAZY_LOAD
+/* played in place of a wave that was not loaded */
+static const EAS_SAMPLE dlsSilence[2] = { 0, 0 };
+#endif
+
 /*----------------------------------------------------------------------------
  * DLS_StartVoice()
  *----------------------------------------------------------------------------
@@ -305,6 +315,7 @@ static void DLS_UpdateFilter (S_SYNTH_VOICE *pVoice, S_WT_VOICE *pWTVoice, S_WT_
 EAS_RESULT DLS_StartVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, EAS_I32 voiceNum, EAS_U16 regionIndex)
 {
     S_WT_VOICE *pWTVoice;
+    S_WT_CONTROL *pControl;
     const S_DLS_REGION *pDLSRegion;
     const S_DLS_ARTICULATION *pDLSArt;
     S_SYNTH_CHANNEL *pChannel;
@@ -320,21 +331,29 @@ EAS_RESULT DLS_StartVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOIC
     pDLSArt = &pSynth->pDLS->pDLSArticulations[pWTVoice->artIndex];
 
     /* initialize the envelopes */
-    pWTVoice->eg1State = eEnvelopeStateInit;
-    DLS_UpdateEnvelope(pVoice, pChannel, &pDLSArt->eg1, &pWTVoice->eg1Value, &pWTVoice->eg1Increment, &pWTVoice->eg1State);
-    pWTVoice->eg2State = eEnvelopeStateInit;
-    DLS_UpdateEnvelope(pVoice, pChannel, &pDLSArt->eg2, &pWTVoice->eg2Value, &pWTVoice->eg2Increment, &pWTVoice->eg2State);
+    pControl = &pVoiceMgr->wtControl;
+    pControl->eg1State[voiceNum] = eEnvelopeStateInit;
+    DLS_UpdateEnvelope(pVoice, pChannel, &pDLSArt->eg1, &pControl->eg1Value[voiceNum], &pControl->eg1Increment[voiceNum], &pControl->eg1State[voiceNum]);
+    pControl->eg2State[voiceNum] = eEnvelopeStateInit;
+    DLS_UpdateEnvelope(pVoice, pChannel, &pDLSArt->eg2, &pControl->eg2Value[voiceNum], &pControl->eg2Increment[voiceNum], &pControl->eg2State[voiceNum]);
 
     /* initialize the LFOs */
-    pWTVoice->modLFO.lfoValue = 0;
-    pWTVoice->modLFO.lfoPhase = pDLSArt->modLFO.lfoDelay;
-    pWTVoice->vibLFO.lfoValue = 0;
-    pWTVoice->vibLFO.lfoPhase = pDLSArt->vibLFO.lfoDelay;
+    pControl->modLFOValue[voiceNum] = 0;
+    pControl->modLFOPhase[voiceNum] = pDLSArt->modLFO.lfoDelay;
+    pControl->modLFOPhaseInc[voiceNum] = pDLSArt->modLFO.lfoFreq;
+    pControl->vibLFOValue[voiceNum] = 0;
+    pControl->vibLFOPhase[voiceNum] = pDLSArt->vibLFO.lfoDelay;
+    pControl->vibLFOPhaseInc[voiceNum] = pDLSArt->vibLFO.lfoFreq;
+    pControl->pitchCents[voiceNum] = WT_PITCH_CENTS_NONE;
+    pControl->phaseInc[voiceNum] = 0;
+#ifdef _FILTER_ENABLED
+    pControl->filterCutoff[voiceNum] = WT_FILTER_CUTOFF_NONE;
+#endif
 
     /* initalize the envelopes and calculate initial gain */
-    DLS_UpdateEnvelope(pVoice, pChannel, &pDLSArt->eg1, &pWTVoice->eg1Value, &pWTVoice->eg1Increment, &pWTVoice->eg1State);
-    DLS_UpdateEnvelope(pVoice, pChannel, &pDLSArt->eg2, &pWTVoice->eg2Value, &pWTVoice->eg2Increment, &pWTVoice->eg2State);
-    pVoice->gain = (EAS_I16) DLS_UpdateGain(pWTVoice, pDLSArt, pChannel, pDLSRegion->wtRegion.gain, pVoice->velocity);
+    DLS_UpdateEnvelope(pVoice, pChannel, &pDLSArt->eg1, &pControl->eg1Value[voiceNum], &pControl->eg1Increment[voiceNum], &pControl->eg1State[voiceNum]);
+    DLS_UpdateEnvelope(pVoice, pChannel, &pDLSArt->eg2, &pControl->eg2Value[voiceNum], &pControl->eg2Increment[voiceNum], &pControl->eg2State[voiceNum]);
+    pVoice->gain = (EAS_I16) DLS_UpdateGain(pControl, voiceNum, pDLSArt, pChannel, pDLSRegion->wtRegion.gain, pVoice->velocity);
 
 #if (NUM_OUTPUT_CHANNELS == 2)
     EAS_CalcPanControl((EAS_INT) pChannel->pan - 64 + (EAS_INT) pDLSArt->pan, &pWTVoice->gainLeft, &pWTVoice->gainRight);
@@ -345,6 +364,24 @@ EAS_RESULT DLS_StartVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOIC
     pWTVoice->filter.z2 = 0;
 
     /* initialize the oscillator */
+#ifdef _DLS_LAZY_LOAD
+    if (pSynth->pDLS->pDLSWaves != NULL)
+    {
+        /* waves are loaded when the file is prepared, a wave that did not fit
+        in the cache is never read here; the voice ends on its first frame */
+        if (pSynth->pDLS->pDLSWaves[pDLSRegion->wtRegion.waveIndex].pSamples == NULL)
+        {
+            { /* dpp: EAS_ReportEx(_EAS_SEVERITY_WARNING, "DLS_StartVoice: wave %u not loaded\n", pDLSRegion->wtRegion.waveIndex); */ }
+            pWTVoice->phaseAccum = pWTVoice->loopStart = pWTVoice->loopEnd = (EAS_U32) &dlsSilence[0];
+#ifdef _ADPCM_SAMPLES
+            pWTVoice->flags = 0;
+#endif
+            return EAS_ERROR_MALLOC_FAILED;
+        }
+        pWTVoice->phaseAccum = (EAS_U32) pSynth->pDLS->pDLSWaves[pDLSRegion->wtRegion.waveIndex].pSamples;
+    }
+    else
+#endif
     pWTVoice->phaseAccum = (EAS_U32) pSynth->pDLS->pDLSSamples + pSynth->pDLS->pDLSSampleOffsets[pDLSRegion->wtRegion.waveIndex];
     if (pDLSRegion->wtRegion.region.keyGroupAndFlags & REGION_FLAG_IS_LOOPED)
     {
@@ -367,6 +404,16 @@ EAS_RESULT DLS_StartVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOIC
 #endif
     }
 
+#ifdef _ADPCM_SAMPLES
+    /* ADPCM samples are decoded as they are played */
+    pWTVoice->flags = 0;
+    if (pDLSRegion->wtRegion.region.keyGroupAndFlags & REGION_FLAG_USE_ADPCM)
+    {
+        pWTVoice->pADPCMData = (const EAS_U8*) pWTVoice->phaseAccum;
+        pWTVoice->flags = WT_FLAGS_USE_ADPCM;
+    }
+#endif
+
     return EAS_SUCCESS;
 }
 
@@ -391,6 +438,7 @@ EAS_RESULT DLS_StartVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOIC
 EAS_BOOL DLS_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, EAS_I32 voiceNum, EAS_I32 *pMixBuffer, EAS_I32 numSamples)
 {
     S_WT_VOICE *pWTVoice;
+    S_WT_CONTROL *pControl;
     S_SYNTH_CHANNEL *pChannel;
     const S_DLS_REGION *pDLSRegion;
     const S_DLS_ARTICULATION *pDLSArt;
@@ -403,14 +451,9 @@ EAS_BOOL DLS_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE
     pDLSRegion = &pSynth->pDLS->pDLSRegions[pVoice->regionIndex & REGION_INDEX_MASK];
     pChannel = &pSynth->channels[pVoice->channel & 15];
     pDLSArt = &pSynth->pDLS->pDLSArticulations[pWTVoice->artIndex];
+    pControl = &pVoiceMgr->wtControl;
 
-    /* update the envelopes */
-    DLS_UpdateEnvelope(pVoice, pChannel, &pDLSArt->eg1, &pWTVoice->eg1Value, &pWTVoice->eg1Increment, &pWTVoice->eg1State);
-    DLS_UpdateEnvelope(pVoice, pChannel, &pDLSArt->eg2, &pWTVoice->eg2Value, &pWTVoice->eg2Increment, &pWTVoice->eg2State);
-
-    /* update the LFOs using the EAS synth function */
-    WT_UpdateLFO(&pWTVoice->modLFO, pDLSArt->modLFO.lfoFreq);
-    WT_UpdateLFO(&pWTVoice->vibLFO, pDLSArt->vibLFO.lfoFreq);
+    /* the envelopes and LFOs have already been updated by the synth's pfUpdateControl */
 
     /* calculate base frequency */
     temp = pDLSArt->tuning + pChannel->staticPitch + pDLSRegion->wtRegion.tuning +
@@ -421,18 +464,38 @@ EAS_BOOL DLS_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE
         temp += pSynth->globalTranspose * 100;
 
     /* calculate phase increment including modulation effects */
-    intFrame.frame.phaseIncrement = DLS_UpdatePhaseInc(pWTVoice, pDLSArt, pChannel, temp);
+    intFrame.frame.phaseIncrement = DLS_UpdatePhaseInc(pControl, voiceNum, pDLSArt, pChannel, temp);
 
     /* calculate gain including modulation effects */
-    intFrame.frame.gainTarget = DLS_UpdateGain(pWTVoice, pDLSArt, pChannel, pDLSRegion->wtRegion.gain, pVoice->velocity);
+    intFrame.frame.gainTarget = DLS_UpdateGain(pControl, voiceNum, pDLSArt, pChannel, pDLSRegion->wtRegion.gain, pVoice->velocity);
     intFrame.prevGain = pVoice->gain;
 
-    DLS_UpdateFilter(pVoice, pWTVoice, &intFrame, pChannel, pDLSArt);
+    DLS_UpdateFilter(pVoice, pControl, voiceNum, &intFrame, pChannel, pDLSArt);
 
     /* call into engine to generate samples */
     intFrame.pAudioBuffer = pVoiceMgr->voiceBuffer;
     intFrame.pMixBuffer = pMixBuffer;
     intFrame.numSamples = numSamples;
+#ifdef _REVERB
+    /* reverb send is in 0.1% units, the articulation default plus the CC91 contribution */
+    temp = pDLSArt->reverbSend + ((pDLSArt->cc91ToReverbSend * (EAS_I32) pChannel->reverbSend) >> 7);
+    if (temp < 0)
+        temp = 0;
+    else if (temp > 1000)
+        temp = 1000;
+    intFrame.pReverbSend = pVoiceMgr->reverbSendBuffer;
+    intFrame.reverbSend = (temp * 32767) / 1000;
+#endif
+#ifdef _CHORUS
+    /* chorus send is in 0.1% units, the articulation default plus the CC93 contribution */
+    temp = pDLSArt->chorusSend + ((pDLSArt->cc93ToChorusSend * (EAS_I32) pChannel->chorusSend) >> 7);
+    if (temp < 0)
+        temp = 0;
+    else if (temp > 1000)
+        temp = 1000;
+    intFrame.pChorusSend = pVoiceMgr->chorusSendBuffer;
+    intFrame.chorusSend = (temp * 32767) / 1000;
+#endif
     if (numSamples < 0)
         return EAS_FALSE;
 
@@ -440,7 +503,12 @@ EAS_BOOL DLS_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE
     if ((pWTVoice->loopStart != WT_NOISE_GENERATOR) && (pWTVoice->loopStart == pWTVoice->loopEnd))
         done = WT_CheckSampleEnd(pWTVoice, &intFrame, EAS_FALSE);
 
-    WT_ProcessVoice(pWTVoice, &intFrame);
+#ifdef _FAST_STEAL
+    if (pVoice->voiceState == eVoiceStateStolen)
+        WT_RenderStealRamp(pWTVoice, &intFrame);
+    else
+#endif
+    WT_RenderVoice(pWTVoice, &intFrame);
 
     /* clear flag */
     pVoice->voiceFlags &= ~VOICE_FLAG_NO_SAMPLES_SYNTHESIZED_YET;
@@ -452,12 +520,43 @@ EAS_BOOL DLS_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE
     pVoice->gain = (EAS_I16) intFrame.frame.gainTarget;
 
     /* if voice has finished, set flag for voice manager */
-    if ((pVoice->voiceState != eVoiceStateStolen) && (pWTVoice->eg1State == eEnvelopeStateMuted))
+    if ((pVoice->voiceState != eVoiceStateStolen) && (pControl->eg1State[voiceNum] == eEnvelopeStateMuted))
         done = EAS_TRUE;
 
     return done;
 }
 
+/*----------------------------------------------------------------------------
+ * DLS_UpdateEnvelopes()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Update both envelopes of a DLS voice for the next frame. Called from
+ * the synth's control update before any voice is rendered.
+ *
+ * Inputs:
+ * pVoiceMgr    - pointer to voice manager
+ * pSynth       - pointer to virtual synth
+ * pVoice       - pointer to the voice
+ * voiceNum     - voice number
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+void DLS_UpdateEnvelopes (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, EAS_I32 voiceNum)
+{
+    S_WT_CONTROL *pControl;
+    S_SYNTH_CHANNEL *pChannel;
+    const S_DLS_ARTICULATION *pDLSArt;
+
+    pControl = &pVoiceMgr->wtControl;
+    pChannel = &pSynth->channels[pVoice->channel & 15];
+    pDLSArt = &pSynth->pDLS->pDLSArticulations[pVoiceMgr->wtVoices[voiceNum].artIndex];
+
+    DLS_UpdateEnvelope(pVoice, pChannel, &pDLSArt->eg1, &pControl->eg1Value[voiceNum], &pControl->eg1Increment[voiceNum], &pControl->eg1State[voiceNum]);
+    DLS_UpdateEnvelope(pVoice, pChannel, &pDLSArt->eg2, &pControl->eg2Value[voiceNum], &pControl->eg2Increment[voiceNum], &pControl->eg2State[voiceNum]);
+}
+
 /*----------------------------------------------------------------------------
  * DLS_UpdateEnvelope()
  *----------------------------------------------------------------------------
@@ -39,6 +39,16 @@ typedef struct
     EAS_RESULT  (*pfShutdown)(EAS_DATA_HANDLE pEASData, EAS_VOID_PTR pInstData);
     EAS_RESULT  (*pFGetParam)(EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 *pValue);
     EAS_RESULT  (*pFSetParam)(EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 value);
+    /* optional, processes the 32-bit mix buffer in place after the master gain */
+    void        (*pfProcess32)(EAS_VOID_PTR pInstData, EAS_I32 *pMix, EAS_I32 numSamples);
+    EAS_I32     bypassParam;        /* boolean parameter that bypasses the module, or -1 if none */
+#ifdef _INSTANCE_POOL
+    EAS_I32     instDataSize;       /* size of instance data, for cloning pristine state */
+#endif
+#if defined(_REVERB) || defined(_CHORUS)
+    /* optional, processes a 32-bit send bus and adds the result to the 32-bit mix buffer */
+    void        (*pfProcessSend)(EAS_VOID_PTR pInstData, EAS_I32 *pSend, EAS_I32 *pMix, EAS_I32 numSamples);
+#endif
 } S_EFFECTS_INTERFACE;
 
 typedef struct
@@ -36,6 +36,23 @@
 /* anything greater than this converts to a fraction too large to represent in 32-bits */
 #define MAX_CENTS    19200
 
+#ifdef _TABLE_2TOX
+/* 2^(n/64) for n = 0 to 64, in 1.15 format */
+#define POW2_TABLE_BITS     6
+static const EAS_I32 pow2Table[(1 << POW2_TABLE_BITS) + 1] =
+{
+    32768, 33125, 33486, 33850, 34219, 34591, 34968, 35349,
+    35734, 36123, 36516, 36914, 37316, 37722, 38133, 38548,
+    38968, 39392, 39821, 40255, 40693, 41136, 41584, 42037,
+    42495, 42958, 43425, 43898, 44376, 44859, 45348, 45842,
+    46341, 46846, 47356, 47871, 48393, 48920, 49452, 49991,
+    50535, 51085, 51642, 52204, 52773, 53347, 53928, 54515,
+    55109, 55709, 56316, 56929, 57549, 58176, 58809, 59449,
+    60097, 60751, 61413, 62081, 62757, 63441, 64132, 64830,
+    65536
+};
+#endif
+
 /*----------------------------------------------------------------------------
  * EAS_Calculate2toX()
  *----------------------------------------------------------------------------
@@ -75,12 +92,24 @@ EAS_I32 EAS_Calculate2toX (EAS_I32 nCents)
     nExponentInt = GET_DENTS_INT_PART(nDents);
     nExponentFrac = GET_DENTS_FRAC_PART(nDents);
 
+#ifdef _TABLE_2TOX
+    /*
+    implement 2^(fracPart) by linear interpolation in a table,
+    this is slightly more accurate than the power series but
+    does not produce the same bits
+    */
+    nTemp2 = nExponentFrac >> (NUM_DENTS_FRAC_BITS - POW2_TABLE_BITS);
+    nTemp1 = pow2Table[nTemp2];
+    /*lint -e{704} <avoid divide for performance>*/
+    nTemp1 += ((pow2Table[nTemp2 + 1] - nTemp1) * (nExponentFrac & ((1 << (NUM_DENTS_FRAC_BITS - POW2_TABLE_BITS)) - 1))) >> (NUM_DENTS_FRAC_BITS - POW2_TABLE_BITS);
+#else
     /*
     implement 2^(fracPart) as a power series
     */
     nTemp1 = GN2_TO_X2 + MULT_DENTS_COEF(nExponentFrac, GN2_TO_X3);
     nTemp2 = GN2_TO_X1 + MULT_DENTS_COEF(nExponentFrac, nTemp1);
     nTemp1 = GN2_TO_X0 + MULT_DENTS_COEF(nExponentFrac, nTemp2);
+#endif
 
     /*
     implement 2^(intPart) as
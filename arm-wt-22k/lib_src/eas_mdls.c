@@ -123,7 +123,6 @@
 #include "dls.h"
 #include "dls2.h"
 #include "eas_report.h"
-#include <string.h>
 
 //2 we should replace log10() function with fixed point routine in ConvertSampleRate()
 /* lint is choking on the ARM math.h file, so we declare the log10 function here */
@@ -136,7 +135,6 @@ extern double log10(double x);
 
 // #define _DEBUG_DLS
 
-#define DLS_MAX_WAVE_COUNT      1024
 #define DLS_MAX_ART_COUNT       2048
 #define DLS_MAX_REGION_COUNT    2048
 #define DLS_MAX_INST_COUNT      256
@@ -211,10 +209,10 @@ typedef enum
     PARAM_MOD_EG_TO_PITCH,
 
     PARAM_DEFAULT_PAN,
-    PARAM_MIDI_CC91_TO_REVERB_SEND,
     PARAM_DEFAULT_REVERB_SEND,
-    PARAM_MIDI_CC93_TO_CHORUS_SEND,
+    PARAM_MIDI_CC91_TO_REVERB_SEND,
     PARAM_DEFAULT_CHORUS_SEND,
+    PARAM_MIDI_CC93_TO_CHORUS_SEND,
     PARAM_TABLE_SIZE
 } E_ART_INDEX;
 
@@ -234,6 +232,10 @@ typedef struct
     EAS_U16 bitsPerSample;
     EAS_I16 fineTune;
     EAS_U8  unityNote;
+#ifdef _ADPCM_SAMPLES
+    EAS_BOOL loopedByRegion;
+    EAS_BOOL useADPCM;
+#endif
 } S_WSMP_DATA;
 
 /* temporary data structure used while parsing a DLS file */
@@ -319,7 +321,7 @@ static const S_CONNECTION connTable[] =
     { CONN_SRC_NONE, CONN_SRC_NONE, CONN_DST_REVERB, PARAM_DEFAULT_REVERB_SEND },
     { CONN_SRC_CC91, CONN_SRC_NONE, CONN_DST_REVERB, PARAM_MIDI_CC91_TO_REVERB_SEND },
     { CONN_SRC_NONE, CONN_SRC_NONE, CONN_DST_CHORUS, PARAM_DEFAULT_CHORUS_SEND },
-    { CONN_SRC_CC93, CONN_SRC_NONE, CONN_DST_REVERB, PARAM_MIDI_CC93_TO_CHORUS_SEND }
+    { CONN_SRC_CC93, CONN_SRC_NONE, CONN_DST_CHORUS, PARAM_MIDI_CC93_TO_CHORUS_SEND }
 };
 #define ENTRIES_IN_CONN_TABLE (sizeof(connTable)/sizeof(S_CONNECTION))
 
@@ -416,12 +418,17 @@ EAS_INLINE void *PtrOfs (void *p, EAS_I32 offset)
  * prototypes
  *------------------------------------
 */
+static EAS_RESULT ParseDLS (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle, EAS_I32 offset, EAS_DLSLIB_HANDLE *ppDLS, EAS_BOOL lazyLoad);
+static void BuildProgramHash (S_DLS *pDLS);
 static EAS_RESULT NextChunk (SDLS_SYNTHESIZER_DATA *pDLSData, EAS_I32 *pPos, EAS_U32 *pChunkType, EAS_I32 *pSize);
 static EAS_RESULT Parse_ptbl (SDLS_SYNTHESIZER_DATA *pDLSData, EAS_I32 pos, EAS_I32 wsmpPos, EAS_I32 wsmpSize);
 static EAS_RESULT Parse_wave (SDLS_SYNTHESIZER_DATA *pDLSData, EAS_I32 pos, EAS_U16 waveIndex);
 static EAS_RESULT Parse_wsmp (SDLS_SYNTHESIZER_DATA *pDLSData, EAS_I32 pos, S_WSMP_DATA *p);
 static EAS_RESULT Parse_fmt (SDLS_SYNTHESIZER_DATA *pDLSData, EAS_I32 pos, S_WSMP_DATA *p);
 static EAS_RESULT Parse_data (SDLS_SYNTHESIZER_DATA *pDLSData, EAS_I32 pos, EAS_I32 size, S_WSMP_DATA *p, EAS_SAMPLE *pSample, EAS_U32 sampleLen);
+#ifdef _ADPCM_SAMPLES
+static EAS_RESULT Encode_ADPCM (SDLS_SYNTHESIZER_DATA *pDLSData, EAS_I32 size, const S_WSMP_DATA *pWsmp, EAS_U8 *pOutput);
+#endif
 static EAS_RESULT Parse_lins(SDLS_SYNTHESIZER_DATA *pDLSData, EAS_I32 pos, EAS_I32 size);
 static EAS_RESULT Parse_ins (SDLS_SYNTHESIZER_DATA *pDLSData, EAS_I32 pos, EAS_I32 size);
 static EAS_RESULT Parse_insh (SDLS_SYNTHESIZER_DATA *pDLSData, EAS_I32 pos, EAS_U32 *pRgnCount, EAS_U32 *pLocale);
@@ -462,6 +469,45 @@ static void DumpDLS (S_EAS *pEAS);
  *----------------------------------------------------------------------------
 */
 EAS_RESULT DLSParser (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle, EAS_I32 offset, EAS_DLSLIB_HANDLE *ppDLS)
+{
+    return ParseDLS(hwInstData, fileHandle, offset, ppDLS, EAS_FALSE);
+}
+
+#ifdef _DLS_LAZY_LOAD
+/*----------------------------------------------------------------------------
+ * DLSLazyParser ()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Same as DLSParser, but the samples are not loaded. The collection keeps
+ * a duplicate of the file handle and the waves of each program are loaded
+ * by DLSLoadProgram before the file is played. The caller must keep the
+ * file open for the lifetime of the collection.
+ *
+ * Inputs:
+ * pEASData - pointer to over EAS data instance
+ * fileHandle - file handle for input file
+ * offset - offset into file where DLS data starts
+ *
+ * Outputs:
+ * EAS_RESULT
+ * ppEAS - address of pointer to alternate EAS wavetable
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT DLSLazyParser (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle, EAS_I32 offset, EAS_DLSLIB_HANDLE *ppDLS)
+{
+    return ParseDLS(hwInstData, fileHandle, offset, ppDLS, EAS_TRUE);
+}
+#endif
+
+/*----------------------------------------------------------------------------
+ * ParseDLS ()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Common code for DLSParser and DLSLazyParser
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT ParseDLS (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle, EAS_I32 offset, EAS_DLSLIB_HANDLE *ppDLS, EAS_BOOL lazyLoad)
 {
     EAS_RESULT result;
     SDLS_SYNTHESIZER_DATA dls;
@@ -474,6 +520,8 @@ EAS_RESULT DLSParser (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle,
     EAS_I32 rgnPoolSize;
     EAS_I32 artPoolSize;
     EAS_I32 waveLenSize;
+    EAS_I32 wavePoolSize;
+    EAS_I32 hashSize;
     EAS_I32 endDLS;
     EAS_I32 wvplPos;
     EAS_I32 wvplSize;
@@ -626,10 +674,25 @@ EAS_RESULT DLSParser (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle,
             return EAS_ERROR_FILE_FORMAT;
         }
 
+#ifdef _ADPCM_SAMPLES
+        /* now that we know which waves are looped by a region, size the wave pool again */
+        dls.wavePoolSize = 0;
+        if ((result = Parse_ptbl(&dls, ptblPos, wvplPos, wvplSize)) != EAS_SUCCESS)
+        {
+            EAS_HWFree(dls.hwInstData, dls.wsmpData);
+            return result;
+        }
+#endif
+
         /* Allocate memory for the converted DLS data */
         /* calculate size of instrument data */
         instSize = (EAS_I32) (sizeof(S_PROGRAM) * dls.instCount);
 
+        /* calculate size of program hash table, at least twice the number of programs */
+        hashSize = DLS_MIN_PROGRAM_HASH_SIZE;
+        while (hashSize < (EAS_I32) (2 * dls.instCount))
+            hashSize <<= 1;
+
         /* calculate size of region pool */
         rgnPoolSize = (EAS_I32) (sizeof(S_DLS_REGION) * dls.regionCount);
 
@@ -640,8 +703,15 @@ EAS_RESULT DLSParser (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle,
         /* calculate size of wave length and offset arrays */
         waveLenSize = (EAS_I32) (dls.waveCount * sizeof(EAS_U32));
 
+        /* calculate size of wave pool, or the wave cache table for lazy loading */
+        wavePoolSize = (EAS_I32) dls.wavePoolSize;
+#ifdef _DLS_LAZY_LOAD
+        if (lazyLoad)
+            wavePoolSize = (EAS_I32) (dls.waveCount * sizeof(S_DLS_WAVE));
+#endif
+
         /* calculate final memory size */
-        size = (EAS_I32) sizeof(S_EAS) + instSize + rgnPoolSize + artPoolSize + (2 * waveLenSize) + (EAS_I32) dls.wavePoolSize;
+        size = (EAS_I32) sizeof(S_DLS) + instSize + (hashSize * (EAS_I32) sizeof(EAS_U16)) + rgnPoolSize + artPoolSize + (2 * waveLenSize) + wavePoolSize;
         if (size <= 0) {
             EAS_HWFree(dls.hwInstData, dls.wsmpData);
             return EAS_ERROR_FILE_FORMAT;
@@ -657,13 +727,27 @@ EAS_RESULT DLSParser (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle,
         }
         EAS_HWMemSet(dls.pDLS, 0, size);
         dls.pDLS->refCount = 1;
-        p = PtrOfs(dls.pDLS, sizeof(S_EAS));
+        p = PtrOfs(dls.pDLS, sizeof(S_DLS));
 
         /* setup pointer to programs */
         dls.pDLS->numDLSPrograms = (EAS_U16) dls.instCount;
         dls.pDLS->pDLSPrograms = p;
         p = PtrOfs(p, instSize);
 
+        /* setup pointer to program hash table */
+        dls.pDLS->pDLSProgramHash = p;
+        dls.pDLS->programHashMask = (EAS_U16) (hashSize - 1);
+        p = PtrOfs(p, hashSize * (EAS_I32) sizeof(EAS_U16));
+
+#ifdef _DLS_LAZY_LOAD
+        /* the wave cache table holds pointers, keep it ahead of the 32-bit arrays */
+        if (lazyLoad)
+        {
+            dls.pDLS->pDLSWaves = p;
+            p = PtrOfs(p, wavePoolSize);
+        }
+#endif
+
         /* setup pointer to regions */
         dls.pDLS->pDLSRegions = p;
         dls.pDLS->numDLSRegions = (EAS_U16) dls.regionCount;
@@ -686,11 +770,23 @@ EAS_RESULT DLSParser (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle,
         /* setup pointer to wave pool */
         dls.pDLS->pDLSSamples = p;
 
+#ifdef _DLS_LAZY_LOAD
+        /* samples are loaded later, keep our own handle to the file */
+        if (lazyLoad)
+        {
+            dls.pDLS->pDLSSamples = NULL;
+            dls.pDLS->hwInstData = dls.hwInstData;
+            dls.pDLS->bigEndian = dls.bigEndian;
+            result = EAS_HWDupHandle(dls.hwInstData, dls.fileHandle, &dls.pDLS->fileHandle);
+        }
+#endif
+
         /* clear filter flag */
         dls.filterUsed = EAS_FALSE;
 
         /* parse the wave pool and load samples */
-        result = Parse_ptbl(&dls, ptblPos, wvplPos, wvplSize);
+        if (result == EAS_SUCCESS)
+            result = Parse_ptbl(&dls, ptblPos, wvplPos, wvplSize);
     }
 
     /* create the default articulation */
@@ -704,6 +800,10 @@ EAS_RESULT DLSParser (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle,
     if (result == EAS_SUCCESS)
         result = Parse_lins(&dls, linsPos, linsSize);
 
+    /* index the programs */
+    if (result == EAS_SUCCESS)
+        BuildProgramHash(dls.pDLS);
+
     /* clean up any temporary objects that were allocated */
     if (dls.wsmpData)
         EAS_HWFree(dls.hwInstData, dls.wsmpData);
@@ -747,7 +847,20 @@ EAS_RESULT DLSCleanup (EAS_HW_DATA_HANDLE hwInstData, S_DLS *pDLS)
         if (pDLS->refCount)
         {
             if (--pDLS->refCount == 0)
+            {
+#ifdef _DLS_LAZY_LOAD
+                /* free any cached waves and close our file handle */
+                if (pDLS->pDLSWaves)
+                {
+                    EAS_U16 waveIndex;
+                    for (waveIndex = 0; waveIndex < pDLS->numDLSSamples; waveIndex++)
+                        DLSUnloadWave(pDLS, waveIndex);
+                    if (pDLS->fileHandle)
+                        EAS_HWCloseFile(hwInstData, pDLS->fileHandle);
+                }
+#endif
                 EAS_HWFree(hwInstData, pDLS);
+            }
         }
     }
     return EAS_SUCCESS;
@@ -765,6 +878,186 @@ void DLSAddRef (S_DLS *pDLS)
         pDLS->refCount++;
 }
 
+#ifdef _DLS_LAZY_LOAD
+/*----------------------------------------------------------------------------
+ * DLSLoadWave ()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Reads and converts the samples for a wave in a lazily loaded collection.
+ * The caller is responsible for keeping the cache within its budget.
+ *
+ * Inputs:
+ * pDLS - pointer to DLS collection
+ * waveIndex - wave to load
+ *
+ * Outputs:
+ * EAS_RESULT
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT DLSLoadWave (S_DLS *pDLS, EAS_U16 waveIndex)
+{
+    SDLS_SYNTHESIZER_DATA dls;
+    S_WSMP_DATA wsmp;
+    S_DLS_WAVE *pWave;
+    EAS_SAMPLE *pSamples;
+    EAS_RESULT result;
+
+    if ((pDLS->pDLSWaves == NULL) || (waveIndex >= pDLS->numDLSSamples))
+        return EAS_ERROR_PARAMETER_RANGE;
+
+    /* already loaded? */
+    pWave = &pDLS->pDLSWaves[waveIndex];
+    if (pWave->pSamples != NULL)
+        return EAS_SUCCESS;
+
+    /* allocate a buffer for the samples */
+    if ((pSamples = EAS_HWMalloc(pDLS->hwInstData, (EAS_I32) pWave->size)) == NULL)
+        return EAS_ERROR_MALLOC_FAILED;
+    EAS_HWMemSet(pSamples, 0, (EAS_I32) pWave->size);
+
+    EAS_HWMemSet(&dls, 0, sizeof(dls));
+    dls.hwInstData = pDLS->hwInstData;
+    dls.fileHandle = pDLS->fileHandle;
+    dls.bigEndian = pDLS->bigEndian;
+
+    EAS_HWMemSet(&wsmp, 0, sizeof(wsmp));
+    wsmp.bitsPerSample = pWave->bitsPerSample;
+    wsmp.loopStart = pWave->loopStart;
+    wsmp.loopLength = pWave->loopLength;
+#ifdef _ADPCM_SAMPLES
+    wsmp.useADPCM = (pWave->flags & DLS_WAVE_FLAG_USE_ADPCM) ? EAS_TRUE : EAS_FALSE;
+#endif
+
+    if ((result = Parse_data(&dls, pWave->dataPos, pWave->dataSize, &wsmp, pSamples, pWave->size)) != EAS_SUCCESS)
+    {
+        EAS_HWFree(pDLS->hwInstData, pSamples);
+        return result;
+    }
+
+    pWave->pSamples = pSamples;
+    pDLS->cacheSize += pWave->size;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * DLSUnloadWave ()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Frees the samples for a wave in a lazily loaded collection. The caller
+ * must make sure that no voice is playing the wave.
+ *
+ * Inputs:
+ * pDLS - pointer to DLS collection
+ * waveIndex - wave to unload
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+void DLSUnloadWave (S_DLS *pDLS, EAS_U16 waveIndex)
+{
+    S_DLS_WAVE *pWave;
+
+    if ((pDLS->pDLSWaves == NULL) || (waveIndex >= pDLS->numDLSSamples))
+        return;
+
+    pWave = &pDLS->pDLSWaves[waveIndex];
+    if (pWave->pSamples != NULL)
+    {
+        EAS_HWFree(pDLS->hwInstData, pWave->pSamples);
+        pWave->pSamples = NULL;
+        pDLS->cacheSize -= pWave->size;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * DLSLoadProgram ()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Loads the waves for the regions of a program in a lazily loaded
+ * collection. Waves are loaded while they fit in DLS_SAMPLE_CACHE_SIZE
+ * (the first wave is always loaded), nothing is evicted, so the samples
+ * of a playing voice never go away.
+ * Called when the file is prepared, never while rendering.
+ *
+ * Inputs:
+ * pDLS - pointer to DLS collection
+ * regionIndex - first region of the program, as stored in the channel
+ *
+ * Outputs:
+ * EAS_RESULT
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT DLSLoadProgram (S_DLS *pDLS, EAS_U16 regionIndex)
+{
+    const S_DLS_REGION *pDLSRegion;
+    S_DLS_WAVE *pWave;
+    EAS_RESULT result;
+
+    /* ignore programs from the built-in library */
+    if ((pDLS == NULL) || (pDLS->pDLSWaves == NULL) || !(regionIndex & FLAG_RGN_IDX_DLS_SYNTH))
+        return EAS_SUCCESS;
+
+    regionIndex &= REGION_INDEX_MASK;
+    while (regionIndex < pDLS->numDLSRegions)
+    {
+        pDLSRegion = &pDLS->pDLSRegions[regionIndex++];
+        pWave = &pDLS->pDLSWaves[pDLSRegion->wtRegion.waveIndex];
+        if ((pWave->pSamples == NULL) && ((pDLS->cacheSize == 0) || (pDLS->cacheSize + pWave->size <= DLS_SAMPLE_CACHE_SIZE)))
+        {
+            if ((result = DLSLoadWave(pDLS, pDLSRegion->wtRegion.waveIndex)) != EAS_SUCCESS)
+                return result;
+        }
+        if (pDLSRegion->wtRegion.region.keyGroupAndFlags & REGION_FLAG_LAST_REGION)
+            break;
+    }
+    return EAS_SUCCESS;
+}
+#endif
+
+/*----------------------------------------------------------------------------
+ * BuildProgramHash ()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Fills the program hash table so the voice manager can find a program
+ * without searching the program list. Each entry is a program index plus
+ * one, zero marks an empty slot. Collisions use linear probing. When a
+ * locale appears twice, the first program wins, as it did with the
+ * linear search.
+ *
+ * Inputs:
+ * pDLS - pointer to DLS collection
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void BuildProgramHash (S_DLS *pDLS)
+{
+    EAS_U16 i;
+    EAS_U16 slot;
+    EAS_U16 entry;
+
+    for (i = 0; i < pDLS->numDLSPrograms; i++)
+    {
+        slot = DLS_PROGRAM_HASH(pDLS->pDLSPrograms[i].locale) & pDLS->programHashMask;
+        for (;;)
+        {
+            entry = pDLS->pDLSProgramHash[slot];
+            if (entry == 0)
+            {
+                pDLS->pDLSProgramHash[slot] = i + 1;
+                break;
+            }
+            if (pDLS->pDLSPrograms[entry - 1].locale == pDLS->pDLSPrograms[i].locale)
+                break;
+            slot = (slot + 1) & pDLS->programHashMask;
+        }
+    }
+}
+
 /*----------------------------------------------------------------------------
  * NextChunk ()
  *----------------------------------------------------------------------------
@@ -920,6 +1213,7 @@ static EAS_RESULT Parse_wave (SDLS_SYNTHESIZER_DATA *pDLSData, EAS_I32 pos, EAS_
     EAS_I32 fmtPos = 0;
     EAS_I32 dataPos = 0;
     EAS_I32 dataSize = 0;
+    EAS_U32 sampleLen;
     S_WSMP_DATA *p;
     void *pSample;
     S_WSMP_DATA wsmp;
@@ -1049,6 +1343,27 @@ static EAS_RESULT Parse_wave (SDLS_SYNTHESIZER_DATA *pDLSData, EAS_I32 pos, EAS_
         if (p->loopLength)
             size += 2;
     }
+    sampleLen = (EAS_U32) size;
+
+#ifdef _ADPCM_SAMPLES
+    /* Unlooped samples are stored as 4-bit ADPCM, but only once the
+     * first pass through the lins chunk has told us that no region
+     * adds a loop. The sample length is still the decoded size, the
+     * pool size is rounded to keep the next sample 16-bit aligned.
+     */
+    p->useADPCM = EAS_FALSE;
+    if ((p->loopLength == 0) && (pDLSData->wsmpData != NULL) && !pDLSData->wsmpData[waveIndex].loopedByRegion)
+    {
+        /*lint -e{704} use shift for performance */
+        EAS_I32 sampleCount = size >> 1;
+        if (sampleCount >= 2)
+        {
+            p->useADPCM = EAS_TRUE;
+            /*lint -e{703} -e{704} use shift for performance */
+            size = ((sampleCount + 3) >> 2) << 1;
+        }
+    }
+#endif
 
     /* for first pass, add size to wave pool size and return */
     if (pDLSData->pDLS == NULL)
@@ -1057,10 +1372,42 @@ static EAS_RESULT Parse_wave (SDLS_SYNTHESIZER_DATA *pDLSData, EAS_I32 pos, EAS_
         return EAS_SUCCESS;
     }
 
+#ifdef _DLS_LAZY_LOAD
+    /* lazy loading, just remember where the samples are */
+    if (pDLSData->pDLS->pDLSWaves != NULL)
+    {
+        S_DLS_WAVE *pWave;
+
+        if (p->loopLength
+            && (size < (EAS_I32) sizeof(EAS_SAMPLE)
+                || (p->loopStart + p->loopLength) * sizeof(EAS_SAMPLE) > (EAS_U32) size - sizeof(EAS_SAMPLE)))
+        {
+            return EAS_FAILURE;
+        }
+
+        pWave = &pDLSData->pDLS->pDLSWaves[waveIndex];
+        pWave->pSamples = NULL;
+        pWave->dataPos = dataPos;
+        pWave->dataSize = dataSize;
+        pWave->size = (EAS_U32) size;
+        pWave->loopStart = p->loopStart;
+        pWave->loopLength = p->loopLength;
+        pWave->bitsPerSample = p->bitsPerSample;
+        pWave->flags = 0;
+#ifdef _ADPCM_SAMPLES
+        if (p->useADPCM)
+            pWave->flags |= DLS_WAVE_FLAG_USE_ADPCM;
+#endif
+        pDLSData->pDLS->pDLSSampleOffsets[waveIndex] = 0;
+        pDLSData->pDLS->pDLSSampleLen[waveIndex] = sampleLen;
+        return EAS_SUCCESS;
+    }
+#endif
+
     /* allocate memory and read in the sample data */
     pSample = (EAS_U8*)pDLSData->pDLS->pDLSSamples + pDLSData->wavePoolOffset;
     pDLSData->pDLS->pDLSSampleOffsets[waveIndex] = pDLSData->wavePoolOffset;
-    pDLSData->pDLS->pDLSSampleLen[waveIndex] = (EAS_U32) size;
+    pDLSData->pDLS->pDLSSampleLen[waveIndex] = sampleLen;
     pDLSData->wavePoolOffset += (EAS_U32) size;
     if (pDLSData->wavePoolOffset > pDLSData->wavePoolSize)
     {
@@ -1241,6 +1588,81 @@ static EAS_RESULT Parse_fmt (SDLS_SYNTHESIZER_DATA *pDLSData, EAS_I32 pos, S_WSM
     return EAS_SUCCESS;
 }
 
+/*----------------------------------------------------------------------------
+ * Sample conversion kernels
+ *----------------------------------------------------------------------------
+ * These are plain loops with no dependency between iterations so the
+ * compiler can vectorize them. Source and destination must not overlap,
+ * except that the 8-bit sign flip may be done in place.
+ *----------------------------------------------------------------------------
+*/
+#if defined(_8_BIT_SAMPLES)
+/*----------------------------------------------------------------------------
+ * ConvertSamplesU8ToS8 ()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Converts unsigned 8-bit samples to signed 8-bit samples
+ *----------------------------------------------------------------------------
+*/
+static void ConvertSamplesU8ToS8 (EAS_U8 *pDst, const EAS_U8 *pSrc, EAS_I32 numSamples)
+{
+    EAS_I32 i;
+
+    for (i = 0; i < numSamples; i++)
+        pDst[i] = pSrc[i] ^ 0x80;
+}
+
+/*----------------------------------------------------------------------------
+ * ConvertSamples16To8 ()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Converts little-endian 16-bit samples to signed 8-bit samples by
+ * keeping the high byte
+ *----------------------------------------------------------------------------
+*/
+static void ConvertSamples16To8 (EAS_I8 *pDst, const EAS_U8 *pSrc, EAS_I32 numSamples)
+{
+    EAS_I32 i;
+
+    for (i = 0; i < numSamples; i++)
+        /*lint -e{734} convert from unsigned to signed audio */
+        pDst[i] = (EAS_I8) pSrc[2 * i + 1];
+}
+
+#elif defined(_16_BIT_SAMPLES)
+/*----------------------------------------------------------------------------
+ * ConvertSamples8To16 ()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Converts unsigned 8-bit samples to signed 16-bit samples
+ *----------------------------------------------------------------------------
+*/
+static void ConvertSamples8To16 (EAS_I16 *pDst, const EAS_U8 *pSrc, EAS_I32 numSamples)
+{
+    EAS_I32 i;
+
+    for (i = 0; i < numSamples; i++)
+        pDst[i] = (EAS_I16) ((pSrc[i] ^ 0x80) << 8);
+}
+
+/*----------------------------------------------------------------------------
+ * SwapSamples16 ()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Swaps the bytes of 16-bit samples in place
+ *----------------------------------------------------------------------------
+*/
+static void SwapSamples16 (EAS_I16 *pSamples, EAS_I32 numSamples)
+{
+    EAS_U16 *p;
+    EAS_I32 i;
+
+    p = (EAS_U16*) pSamples;
+    for (i = 0; i < numSamples; i++)
+        p[i] = (EAS_U16) ((p[i] >> 8) | (p[i] << 8));
+}
+#endif
+
 #if defined( _8_BIT_SAMPLES)
 /*----------------------------------------------------------------------------
  * Parse_data ()
@@ -1265,7 +1687,6 @@ static EAS_RESULT Parse_data (SDLS_SYNTHESIZER_DATA *pDLSData, EAS_I32 pos, EAS_
     EAS_RESULT result;
     EAS_U8 convBuf[SAMPLE_CONVERT_CHUNK_SIZE];
     EAS_I32 count;
-    EAS_I32 i;
     EAS_I8 *p;
 
     /* seek to start of chunk */
@@ -1273,43 +1694,27 @@ static EAS_RESULT Parse_data (SDLS_SYNTHESIZER_DATA *pDLSData, EAS_I32 pos, EAS_
         return result;
 
     /* 8-bit samples in an 8-bit synth, just copy the data, and flip bit 7 */
-    p = pSample;
     if (pWsmp->bitsPerSample == 8)
     {
         if ((result = EAS_HWReadFile(pDLSData->hwInstData, pDLSData->fileHandle, pSample, size, &count)) != EAS_SUCCESS)
             return result;
-        for (i = 0; i < size; i++)
-            /*lint -e{734} convert from unsigned to signed audio */
-            *p++ ^= 0x80;
+        ConvertSamplesU8ToS8((EAS_U8*) pSample, (EAS_U8*) pSample, count);
     }
 
     /* 16-bit samples, need to convert to 8-bit or ADPCM */
     else
     {
-
+        p = pSample;
         while (size)
         {
-            EAS_I8 *pInput;
-
-            /* for undithered conversion, we're just copying the 8-bit data */
-            if (pDLSData->bigEndian)
-                pInput = (EAS_I8*) convBuf;
-            else
-                pInput = (EAS_I8*) convBuf + 1;
-
-            /* read a small chunk of data and convert it */
+            /* read a chunk of data and convert it */
             count = (size < SAMPLE_CONVERT_CHUNK_SIZE ? size : SAMPLE_CONVERT_CHUNK_SIZE);
             if ((result = EAS_HWReadFile(pDLSData->hwInstData, pDLSData->fileHandle, convBuf, count, &count)) != EAS_SUCCESS)
                 return result;
             size -= count;
             /*lint -e{704} use shift for performance */
-            count = count >> 1;
-
-            while (count--)
-            {
-                *p++ = *pInput;
-                pInput += 2;
-            }
+            ConvertSamples16To8(p, convBuf, count >> 1);
+            p += count >> 1;
         }
     }
 
@@ -1333,52 +1738,54 @@ static EAS_RESULT Parse_data (SDLS_SYNTHESIZER_DATA *pDLSData, EAS_I32 pos, EAS_
     EAS_RESULT result;
     EAS_U8 convBuf[SAMPLE_CONVERT_CHUNK_SIZE];
     EAS_I32 count = 0;
-    EAS_I32 i;
     EAS_I16 *p;
 
     /* seek to start of chunk */
     if ((result = EAS_HWFileSeek(pDLSData->hwInstData, pDLSData->fileHandle, pos)) != EAS_SUCCESS)
         return result;
 
-    p = pSample;
+#ifdef _ADPCM_SAMPLES
+    if (pWsmp->useADPCM)
+        return Encode_ADPCM(pDLSData, size, pWsmp, (EAS_U8*) pSample);
+#endif
 
-    while (size)
+    /* 16-bit samples are read straight into the wave pool */
+    if (pWsmp->bitsPerSample == 16)
     {
-        /* read a small chunk of data and convert it */
-        count = (size < SAMPLE_CONVERT_CHUNK_SIZE ? size : SAMPLE_CONVERT_CHUNK_SIZE);
-        if ((result = EAS_HWReadFile(pDLSData->hwInstData, pDLSData->fileHandle, convBuf, count, &count)) != EAS_SUCCESS)
-        {
+        if ((result = EAS_HWReadFile(pDLSData->hwInstData, pDLSData->fileHandle, pSample, size, &count)) != EAS_SUCCESS)
             return result;
-        }
-        size -= count;
-        if (pWsmp->bitsPerSample == 16)
-        {
-            memcpy(p, convBuf, count);
-            p += count >> 1;
-        }
-        else
-        {
-            for(i=0; i<count; i++)
-            {
-                *p++ = (short)((convBuf[i] ^ 0x80) << 8);
-            }
-        }
 
+        /* DLS data is little-endian */
+        if (pDLSData->bigEndian)
+            /*lint -e{704} use shift for performance */
+            SwapSamples16(pSample, count >> 1);
     }
 
-    /* for looped samples, copy the last sample to the end */
-    if (pWsmp->loopLength)
+    /* 8-bit samples, need to convert to 16-bit */
+    else
     {
-        if( (pDLSData->wavePoolOffset + pWsmp->loopLength) >= pDLSData->wavePoolSize )
+        p = pSample;
+        while (size)
         {
-            return EAS_SUCCESS;
+            /* read a chunk of data and convert it */
+            count = (size < SAMPLE_CONVERT_CHUNK_SIZE ? size : SAMPLE_CONVERT_CHUNK_SIZE);
+            if ((result = EAS_HWReadFile(pDLSData->hwInstData, pDLSData->fileHandle, convBuf, count, &count)) != EAS_SUCCESS)
+                return result;
+            size -= count;
+            ConvertSamples8To16(p, convBuf, count);
+            p += count;
         }
+    }
+
+    /* for looped samples, copy the first sample of the loop to the end */
+    if (pWsmp->loopLength)
+    {
         if (sampleLen < sizeof(EAS_SAMPLE)
             || (pWsmp->loopStart + pWsmp->loopLength) * sizeof(EAS_SAMPLE) > sampleLen - sizeof(EAS_SAMPLE)) {
             return EAS_FAILURE;
         }
 
-        pSample[(pWsmp->loopStart + pWsmp->loopLength)>>1] = pSample[(pWsmp->loopStart)>>1];
+        pSample[pWsmp->loopStart + pWsmp->loopLength] = pSample[pWsmp->loopStart];
     }
 
     return EAS_SUCCESS;
@@ -1387,6 +1794,108 @@ static EAS_RESULT Parse_data (SDLS_SYNTHESIZER_DATA *pDLSData, EAS_I32 pos, EAS_
 #error "Must specifiy _8_BIT_SAMPLES or _16_BIT_SAMPLES"
 #endif
 
+#ifdef _ADPCM_SAMPLES
+/*----------------------------------------------------------------------------
+ * Encode_ADPCM ()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Reads the sample data and encodes it as 4-bit IMA ADPCM, two codes per
+ * byte, low nibble first. The encoder tracks the decoder with
+ * WT_DecodeADPCM so playback reconstructs exactly what was encoded.
+ *
+ * Inputs:
+ * size         - size of the data chunk in bytes
+ * pWsmp        - wave format
+ * pOutput      - destination in the wave pool (already zeroed)
+ *
+ * Outputs:
+ *
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT Encode_ADPCM (SDLS_SYNTHESIZER_DATA *pDLSData, EAS_I32 size, const S_WSMP_DATA *pWsmp, EAS_U8 *pOutput)
+{
+    EAS_RESULT result;
+    EAS_U8 convBuf[SAMPLE_CONVERT_CHUNK_SIZE];
+    EAS_I32 count;
+    EAS_I32 i;
+    EAS_I32 sample;
+    EAS_I32 diff;
+    EAS_I32 step;
+    EAS_I32 code;
+    EAS_I32 predictor;
+    EAS_I32 stepIndex;
+    EAS_BOOL highNibble;
+
+    predictor = stepIndex = 0;
+    highNibble = EAS_FALSE;
+    while (size)
+    {
+        /* read a small chunk of data and convert it */
+        count = (size < SAMPLE_CONVERT_CHUNK_SIZE ? size : SAMPLE_CONVERT_CHUNK_SIZE);
+        if ((result = EAS_HWReadFile(pDLSData->hwInstData, pDLSData->fileHandle, convBuf, count, &count)) != EAS_SUCCESS)
+            return result;
+        size -= count;
+
+        i = 0;
+        while (i < count)
+        {
+            /* DLS data is little-endian 16-bit or unsigned 8-bit */
+            if (pWsmp->bitsPerSample == 16)
+            {
+                if (i + 1 >= count)
+                    break;
+                sample = (EAS_I16) (convBuf[i] | (convBuf[i + 1] << 8));
+                i += 2;
+            }
+            else
+            {
+                sample = (EAS_I16) ((convBuf[i] ^ 0x80) << 8);
+                i++;
+            }
+
+            /* quantize the difference from the predicted value */
+            code = 0;
+            diff = sample - predictor;
+            if (diff < 0)
+            {
+                code = 8;
+                diff = -diff;
+            }
+            step = wtADPCMStepSize[stepIndex];
+            if (diff >= step)
+            {
+                code |= 4;
+                diff -= step;
+            }
+            /*lint -e{704} use shift for performance */
+            step >>= 1;
+            if (diff >= step)
+            {
+                code |= 2;
+                diff -= step;
+            }
+            /*lint -e{704} use shift for performance */
+            step >>= 1;
+            if (diff >= step)
+                code |= 1;
+
+            /* update the predictor the same way the decoder will */
+            (void) WT_DecodeADPCM(code, &predictor, &stepIndex);
+
+            /* pack two codes per byte */
+            if (highNibble)
+                *pOutput++ |= (EAS_U8) (code << 4);
+            else
+                *pOutput = (EAS_U8) code;
+            highNibble = !highNibble;
+        }
+    }
+
+    return EAS_SUCCESS;
+}
+#endif
+
 /*----------------------------------------------------------------------------
  * Parse_lins ()
  *----------------------------------------------------------------------------
@@ -1863,6 +2372,18 @@ static EAS_RESULT Parse_rgn (SDLS_SYNTHESIZER_DATA *pDLSData, EAS_I32 pos, EAS_I
         }
     }
 
+#ifdef _ADPCM_SAMPLES
+    /* first pass, note waves that a region loops so they are not stored as ADPCM */
+    else if (wsmpPos)
+    {
+        wsmp.loopLength = 0;
+        if ((result = Parse_wsmp(pDLSData, wsmpPos, &wsmp)) != EAS_SUCCESS)
+            return result;
+        if (wsmp.loopLength)
+            pWsmp->loopedByRegion = EAS_TRUE;
+    }
+#endif
+
     /* if local articulation, bump count */
     if (art.values[PARAM_MODIFIED])
         pDLSData->artCount++;
@@ -2458,6 +2979,10 @@ static void Convert_rgn (SDLS_SYNTHESIZER_DATA *pDLSData, EAS_U16 regionIndex, E
     pRgn->wtRegion.tuning = pWsmp->fineTune -(pWsmp->unityNote * 100) + ConvertSampleRate(pWsmp->sampleRate);
     if (pWsmp->loopLength != 0)
         pRgn->wtRegion.region.keyGroupAndFlags |= REGION_FLAG_IS_LOOPED;
+#ifdef _ADPCM_SAMPLES
+    else if (pWsmp->useADPCM)
+        pRgn->wtRegion.region.keyGroupAndFlags |= REGION_FLAG_USE_ADPCM;
+#endif
 }
 
 /*----------------------------------------------------------------------------
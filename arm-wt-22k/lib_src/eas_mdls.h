@@ -68,14 +68,22 @@ typedef struct
 #define MAX_DLS_MEMORY 65536
 #endif
 
+/* maximum number of waves in a DLS collection */
+#define DLS_MAX_WAVE_COUNT      1024
+
 /* size of conditional chunk stack */
 #ifndef CDL_STACK_SIZE
 #define CDL_STACK_SIZE 8
 #endif
 
-/* size of read buffer for sample conversion */
+/* size of read buffer for sample conversion, must be even */
 #ifndef SAMPLE_CONVERT_CHUNK_SIZE
-#define SAMPLE_CONVERT_CHUNK_SIZE 32
+#define SAMPLE_CONVERT_CHUNK_SIZE 512
+#endif
+
+/* maximum sample memory for lazily loaded DLS collections */
+#if defined(_DLS_LAZY_LOAD) && !defined(DLS_SAMPLE_CACHE_SIZE)
+#define DLS_SAMPLE_CACHE_SIZE (512*1024)
 #endif
 
 
@@ -283,6 +291,12 @@ typedef struct s_dls_params
 EAS_RESULT DLSParser (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle, EAS_I32 offset, S_DLS **pDLS);
 EAS_RESULT DLSCleanup (EAS_HW_DATA_HANDLE hwInstData, S_DLS *pDLS);
 void DLSAddRef (S_DLS *pDLS);
+#ifdef _DLS_LAZY_LOAD
+EAS_RESULT DLSLazyParser (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle, EAS_I32 offset, S_DLS **pDLS);
+EAS_RESULT DLSLoadWave (S_DLS *pDLS, EAS_U16 waveIndex);
+void DLSUnloadWave (S_DLS *pDLS, EAS_U16 waveIndex);
+EAS_RESULT DLSLoadProgram (S_DLS *pDLS, EAS_U16 regionIndex);
+#endif
 EAS_I16 ConvertDelay (EAS_I32 timeCents);
 EAS_I16 ConvertRate (EAS_I32 timeCents);
 
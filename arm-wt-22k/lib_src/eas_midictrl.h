@@ -49,6 +49,8 @@
 #define MIDI_CONTROLLER_BANK_SELECT_LSB     32
 #define MIDI_CONTROLLER_ENTER_DATA_LSB      38      /* 0x26 */
 #define MIDI_CONTROLLER_SUSTAIN_PEDAL       64
+#define MIDI_CONTROLLER_REVERB_SEND         91      /* 0x5B */
+#define MIDI_CONTROLLER_CHORUS_SEND         93      /* 0x5D */
 #define MIDI_CONTROLLER_SELECT_NRPN_LSB     98
 #define MIDI_CONTROLLER_SELECT_NRPN_MSB     99
 #define MIDI_CONTROLLER_SELECT_RPN_LSB      100     /* 0x64 */
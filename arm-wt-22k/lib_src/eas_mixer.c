@@ -54,6 +54,34 @@ EAS_I32 MaximizerProcess (EAS_VOID_PTR pInstData, EAS_I32 *pSrc, EAS_I32 *pDst,
 /* need to boost stereo by ~3dB to compensate for the panner */
 #define STEREO_3DB_GAIN_BOOST       512
 
+/*------------------------------------
+ * local data
+ *------------------------------------
+*/
+
+/* processing order of the effects chain, the maximizer adjusts the master gain instead */
+static const EAS_U8 fxChainOrder[] =
+{
+    EAS_MODULE_ENHANCER,
+    EAS_MODULE_GRAPHIC_EQ,
+    EAS_MODULE_COMPRESSOR,
+    EAS_MODULE_WOW,
+    EAS_MODULE_TONECONTROLEQ,
+    EAS_MODULE_REVERB,
+    EAS_MODULE_CHORUS,
+    EAS_MODULE_WIDENER
+};
+
+/*------------------------------------
+ * prototypes
+ *------------------------------------
+*/
+#if defined(_REVERB) || defined(_CHORUS)
+static EAS_I32 *MixEngineSendBus (S_EAS_DATA *pEASData, EAS_INT module);
+#endif
+static void MixEngineGain32 (EAS_I32 *pMixBuffer, EAS_U16 nGain, EAS_I32 numSamples);
+static void MixEngineSaturate (const EAS_I32 *pMixBuffer, EAS_PCM *pOutputBuffer, EAS_I32 numSamples);
+
 /*----------------------------------------------------------------------------
  * EAS_MixEngineInit()
  *----------------------------------------------------------------------------
@@ -114,7 +142,15 @@ void EAS_MixEnginePrep (S_EAS_DATA *pEASData, EAS_I32 numSamples)
     EAS_HWMemSet(pEASData->pMixBuffer, 0, (EAS_I32) numSamples * (EAS_I32) sizeof(long));
 #endif
 
-    /* need to clear other side-chain effect buffers (chorus & reverb) */
+#ifdef _REVERB
+    /* clear the reverb send bus */
+    EAS_HWMemSet(pEASData->pVoiceMgr->reverbSendBuffer, 0, numSamples * NUM_OUTPUT_CHANNELS * (EAS_I32) sizeof(EAS_I32));
+#endif
+
+#ifdef _CHORUS
+    /* clear the chorus send bus */
+    EAS_HWMemSet(pEASData->pVoiceMgr->chorusSendBuffer, 0, numSamples * NUM_OUTPUT_CHANNELS * (EAS_I32) sizeof(EAS_I32));
+#endif
 }
 
 /*----------------------------------------------------------------------------
@@ -134,13 +170,15 @@ void EAS_MixEnginePrep (S_EAS_DATA *pEASData, EAS_I32 numSamples)
 */
 void EAS_MixEnginePost (S_EAS_DATA *pEASData, EAS_I32 numSamples)
 {
+    S_EFFECTS_MODULE *pModule;
+    EAS_INT i;
     EAS_U16 gain;
 
 //3 dls: Need to restore the mix engine metrics
 
     /* calculate the gain multiplier */
 #ifdef _MAXIMIZER_ENABLED
-    if (pEASData->effectsModules[EAS_MODULE_MAXIMIZER].effect)
+    if (pEASData->effectsModules[EAS_MODULE_MAXIMIZER].effectData)
     {
         EAS_I32 temp;
         temp = MaximizerProcess(pEASData->effectsModules[EAS_MODULE_MAXIMIZER].effectData, pEASData->pMixBuffer, pEASData->pMixBuffer, numSamples);
@@ -168,89 +206,48 @@ void EAS_MixEnginePost (S_EAS_DATA *pEASData, EAS_I32 numSamples)
     gain = gain >> 4;
 #endif
 
-    /* convert 32-bit mix buffer to 16-bit output format */
-#if (NUM_OUTPUT_CHANNELS == 2)
-    SynthMasterGain(pEASData->pMixBuffer, pEASData->pOutputAudioBuffer, gain, (EAS_U16) ((EAS_U16) numSamples * 2));
-#else
-    SynthMasterGain(pEASData->pMixBuffer, pEASData->pOutputAudioBuffer, gain, (EAS_U16) numSamples);
-#endif
-
-#ifdef _ENHANCER_ENABLED
-    /* enhancer effect */
-    if (pEASData->effectsModules[EAS_MODULE_ENHANCER].effectData)
-        (*pEASData->effectsModules[EAS_MODULE_ENHANCER].effect->pfProcess)
-            (pEASData->effectsModules[EAS_MODULE_ENHANCER].effectData,
-            pEASData->pOutputAudioBuffer,
-            pEASData->pOutputAudioBuffer,
-            numSamples);
-#endif
-
-#ifdef _GRAPHIC_EQ_ENABLED
-    /* graphic EQ effect */
-    if (pEASData->effectsModules[EAS_MODULE_GRAPHIC_EQ].effectData)
-        (*pEASData->effectsModules[EAS_MODULE_GRAPHIC_EQ].effect->pfProcess)
-            (pEASData->effectsModules[EAS_MODULE_GRAPHIC_EQ].effectData,
-            pEASData->pOutputAudioBuffer,
-            pEASData->pOutputAudioBuffer,
-            numSamples);
-#endif
-
-#ifdef _COMPRESSOR_ENABLED
-    /* compressor effect */
-    if (pEASData->effectsModules[EAS_MODULE_COMPRESSOR].effectData)
-        (*pEASData->effectsModules[EAS_MODULE_COMPRESSOR].effect->pfProcess)
-            (pEASData->effectsModules[EAS_MODULE_COMPRESSOR].effectData,
-            pEASData->pOutputAudioBuffer,
-            pEASData->pOutputAudioBuffer,
-            numSamples);
-#endif
-
-#ifdef _WOW_ENABLED
-    /* WOW requires a 32-bit buffer, borrow the mix buffer and
-     * pass it as the destination buffer
-     */
-    /*lint -e{740} temporarily passing a parameter through an existing I/F */
-    if (pEASData->effectsModules[EAS_MODULE_WOW].effectData)
-        (*pEASData->effectsModules[EAS_MODULE_WOW].effect->pfProcess)
-            (pEASData->effectsModules[EAS_MODULE_WOW].effectData,
-            pEASData->pOutputAudioBuffer,
-            (EAS_PCM*) pEASData->pMixBuffer,
-            numSamples);
-#endif
-
-#ifdef _TONECONTROLEQ_ENABLED
-    /* ToneControlEQ effect */
-    if (pEASData->effectsModules[EAS_MODULE_TONECONTROLEQ].effectData)
-        (*pEASData->effectsModules[EAS_MODULE_TONECONTROLEQ].effect->pfProcess)
-            (pEASData->effectsModules[EAS_MODULE_TONECONTROLEQ].effectData,
-            pEASData->pOutputAudioBuffer,
-            pEASData->pOutputAudioBuffer,
-            numSamples);
+#if defined(_REVERB) || defined(_CHORUS)
+    /* send effects add their wet signal to the mix buffer before the master gain */
+    for (i = 0; i < pEASData->numFxSend; i++)
+    {
+        pModule = &pEASData->effectsModules[pEASData->fxChain[i]];
+        (*pModule->effect->pfProcessSend)(pModule->effectData, MixEngineSendBus(pEASData, pEASData->fxChain[i]), pEASData->pMixBuffer, numSamples);
+    }
 #endif
 
-#ifdef _REVERB_ENABLED
-    /* Reverb effect */
-    if (pEASData->effectsModules[EAS_MODULE_REVERB].effectData)
-        (*pEASData->effectsModules[EAS_MODULE_REVERB].effect->pfProcess)
-            (pEASData->effectsModules[EAS_MODULE_REVERB].effectData,
-            pEASData->pOutputAudioBuffer,
-            pEASData->pOutputAudioBuffer,
-            numSamples);
-#endif
+    /* convert 32-bit mix buffer to 16-bit output format */
+    if (pEASData->numFx32 == pEASData->numFxSend)
+        SynthMasterGain(pEASData->pMixBuffer, pEASData->pOutputAudioBuffer, gain, (EAS_U16) (numSamples * NUM_OUTPUT_CHANNELS));
 
-#ifdef _CHORUS_ENABLED
-    /* Chorus effect */
-    if (pEASData->effectsModules[EAS_MODULE_CHORUS].effectData)
-        (*pEASData->effectsModules[EAS_MODULE_CHORUS].effect->pfProcess)
-            (pEASData->effectsModules[EAS_MODULE_CHORUS].effectData,
-            pEASData->pOutputAudioBuffer,
-            pEASData->pOutputAudioBuffer,
-            numSamples);
-#endif
+    /* run the 32-bit effects between the master gain and the final saturation */
+    else
+    {
+        MixEngineGain32(pEASData->pMixBuffer, gain, numSamples * NUM_OUTPUT_CHANNELS);
+        for (i = pEASData->numFxSend; i < pEASData->numFx32; i++)
+        {
+            pModule = &pEASData->effectsModules[pEASData->fxChain[i]];
+            (*pModule->effect->pfProcess32)(pModule->effectData, pEASData->pMixBuffer, numSamples);
+        }
+        MixEngineSaturate(pEASData->pMixBuffer, pEASData->pOutputAudioBuffer, numSamples * NUM_OUTPUT_CHANNELS);
+    }
 
+    /* 16-bit effects process the output buffer in place */
+    for (i = pEASData->numFx32; i < pEASData->numFx; i++)
+    {
+        pModule = &pEASData->effectsModules[pEASData->fxChain[i]];
+
+        /* WOW requires a 32-bit buffer, borrow the mix buffer and
+         * pass it as the destination buffer
+         */
+        /*lint -e{740} temporarily passing a parameter through an existing I/F */
+        if (pEASData->fxChain[i] == EAS_MODULE_WOW)
+            (*pModule->effect->pfProcess)(pModule->effectData, pEASData->pOutputAudioBuffer, (EAS_PCM*) pEASData->pMixBuffer, numSamples);
+        else
+            (*pModule->effect->pfProcess)(pModule->effectData, pEASData->pOutputAudioBuffer, pEASData->pOutputAudioBuffer, numSamples);
+    }
 }
 
-#ifndef NATIVE_EAS_KERNEL
+#if !defined(NATIVE_EAS_KERNEL) && !defined(NATIVE_MASTER_GAIN)
 /*----------------------------------------------------------------------------
  * SynthMasterGain
  *----------------------------------------------------------------------------
@@ -292,6 +289,164 @@ void SynthMasterGain (long *pInputBuffer, EAS_PCM *pOutputBuffer, EAS_U16 nGain,
 }
 #endif
 
+/*----------------------------------------------------------------------------
+ * MixEngineGain32
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Applies the master gain to the 32-bit mix buffer in place, scaling it to
+ * the 16-bit output level without saturating. Matches SynthMasterGain.
+ *
+ * Inputs:
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void MixEngineGain32 (EAS_I32 *pMixBuffer, EAS_U16 nGain, EAS_I32 numSamples)
+{
+    EAS_I32 s;
+
+    while (numSamples--)
+    {
+        /*lint -e{704} <avoid divide for performance>*/
+        s = *pMixBuffer >> 7;
+        s *= (EAS_I32) nGain;
+        /*lint -e{704} <avoid divide for performance>*/
+        *pMixBuffer++ = s >> 9;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * MixEngineSaturate
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Saturates the scaled 32-bit mix buffer into the 16-bit output buffer
+ *
+ * Inputs:
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void MixEngineSaturate (const EAS_I32 *pMixBuffer, EAS_PCM *pOutputBuffer, EAS_I32 numSamples)
+{
+    EAS_I32 s;
+
+    while (numSamples--)
+    {
+        s = *pMixBuffer++;
+        s = SATURATE(s);
+        *pOutputBuffer++ = (EAS_PCM) s;
+    }
+}
+
+#if defined(_REVERB) || defined(_CHORUS)
+/*----------------------------------------------------------------------------
+ * MixEngineSendBus
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns the send bus of an effects module, or NULL if it has none
+ *
+ * Inputs:
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_I32 *MixEngineSendBus (S_EAS_DATA *pEASData, EAS_INT module)
+{
+#ifdef _REVERB
+    if (module == EAS_MODULE_REVERB)
+        return pEASData->pVoiceMgr->reverbSendBuffer;
+#endif
+#ifdef _CHORUS
+    if (module == EAS_MODULE_CHORUS)
+        return pEASData->pVoiceMgr->chorusSendBuffer;
+#endif
+    return NULL;
+}
+#endif
+
+/*----------------------------------------------------------------------------
+ * EAS_MixEngineUpdateChain()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Rebuilds the list of effects modules run by EAS_MixEnginePost, so that
+ * modules that are not allocated or are bypassed cost nothing per buffer.
+ * The list holds the send effects first, then the modules that process the
+ * 32-bit mix buffer and last the ones that process the 16-bit output, each
+ * group in the order of fxChainOrder.
+ *
+ * Inputs:
+ * pEASData         - instance data
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_MixEngineUpdateChain (S_EAS_DATA *pEASData)
+{
+    S_EFFECTS_MODULE *pModule;
+    EAS_U8 enabled[NUM_EFFECTS_MODULES];
+    EAS_I32 bypass;
+    EAS_INT module;
+    EAS_INT i;
+
+    /* find the modules that are allocated and not bypassed */
+    for (i = 0; i < (EAS_INT) sizeof(fxChainOrder); i++)
+    {
+        module = fxChainOrder[i];
+        pModule = &pEASData->effectsModules[module];
+        enabled[module] = EAS_FALSE;
+        if ((pModule->effect == NULL) || (pModule->effectData == NULL))
+            continue;
+        bypass = EAS_FALSE;
+        if (pModule->effect->bypassParam >= 0)
+        {
+            if ((*pModule->effect->pFGetParam)(pModule->effectData, pModule->effect->bypassParam, &bypass) != EAS_SUCCESS)
+                bypass = EAS_FALSE;
+        }
+        enabled[module] = (EAS_U8) (bypass == EAS_FALSE);
+    }
+
+    pEASData->numFx = 0;
+
+#if defined(_REVERB) || defined(_CHORUS)
+    /* send effects */
+    for (i = 0; i < (EAS_INT) sizeof(fxChainOrder); i++)
+    {
+        module = fxChainOrder[i];
+        if (enabled[module] && pEASData->effectsModules[module].effect->pfProcessSend &&
+            (MixEngineSendBus(pEASData, module) != NULL))
+        {
+            pEASData->fxChain[pEASData->numFx++] = (EAS_U8) module;
+            enabled[module] = EAS_FALSE;
+        }
+    }
+#endif
+    pEASData->numFxSend = pEASData->numFx;
+
+    /* 32-bit effects */
+    for (i = 0; i < (EAS_INT) sizeof(fxChainOrder); i++)
+    {
+        module = fxChainOrder[i];
+        if (enabled[module] && pEASData->effectsModules[module].effect->pfProcess32)
+        {
+            pEASData->fxChain[pEASData->numFx++] = (EAS_U8) module;
+            enabled[module] = EAS_FALSE;
+        }
+    }
+    pEASData->numFx32 = pEASData->numFx;
+
+    /* 16-bit effects */
+    for (i = 0; i < (EAS_INT) sizeof(fxChainOrder); i++)
+    {
+        module = fxChainOrder[i];
+        if (enabled[module])
+            pEASData->fxChain[pEASData->numFx++] = (EAS_U8) module;
+    }
+}
+
 /*----------------------------------------------------------------------------
  * EAS_MixEngineShutdown()
  *----------------------------------------------------------------------------
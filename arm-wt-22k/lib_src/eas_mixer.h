@@ -113,6 +113,22 @@ void EAS_MixEnginePost (EAS_DATA_HANDLE pEASData, EAS_I32 nNumSamplesToAdd);
 */
 EAS_RESULT EAS_MixEngineShutdown (EAS_DATA_HANDLE pEASData);
 
+/*----------------------------------------------------------------------------
+ * EAS_MixEngineUpdateChain()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Rebuilds the list of effects modules run by EAS_MixEnginePost. Must be
+ * called whenever a module is allocated, freed, bypassed or enabled.
+ *
+ * Inputs:
+ * pEASData         - instance data
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+void EAS_MixEngineUpdateChain (EAS_DATA_HANDLE pEASData);
+
 #ifdef UNIFIED_MIXER
 /*----------------------------------------------------------------------------
  * EAS_MixStream
@@ -0,0 +1,296 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * eas_mixer_sse2.c
+ *
+ * Contents and purpose:
+ * SSE2 versions of SynthMasterGain and EAS_MixStream for x86 targets,
+ * selected with NATIVE_MASTER_GAIN and NATIVE_MIX_STREAM. The output is
+ * bit-exact with the C versions in eas_mixer.c.
+ *
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+#if defined(NATIVE_MASTER_GAIN) || (defined(UNIFIED_MIXER) && defined(NATIVE_MIX_STREAM))
+
+/*------------------------------------
+ * includes
+ *------------------------------------
+*/
+#include <emmintrin.h>
+#include "eas_data.h"
+#include "eas_math.h"
+#include "eas_mixer.h"
+
+#ifdef NATIVE_MASTER_GAIN
+/*----------------------------------------------------------------------------
+ * MixLoad4
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Loads four samples of the mix buffer as 32-bit lanes. EAS_I32 is a long,
+ * so on 64-bit targets each sample is narrowed with saturation.
+ *
+ *----------------------------------------------------------------------------
+*/
+static __m128i MixLoad4 (const EAS_I32 *pMixBuffer)
+{
+    __m128i a, b, lo, hi, fits, sat;
+
+    if (sizeof(EAS_I32) == 4)
+        return _mm_loadu_si128((const __m128i*) pMixBuffer);
+
+    /* gather the low and high halves of the four samples */
+    a = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) pMixBuffer), _MM_SHUFFLE(3, 1, 2, 0));
+    b = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) (pMixBuffer + 2)), _MM_SHUFFLE(3, 1, 2, 0));
+    lo = _mm_unpacklo_epi64(a, b);
+    hi = _mm_unpackhi_epi64(a, b);
+
+    /* a sample fits in 32 bits if the high half is the sign of the low half */
+    fits = _mm_cmpeq_epi32(hi, _mm_srai_epi32(lo, 31));
+    sat = _mm_xor_si128(_mm_srai_epi32(hi, 31), _mm_set1_epi32(0x7fffffff));
+    return _mm_or_si128(_mm_and_si128(fits, lo), _mm_andnot_si128(fits, sat));
+}
+
+/*----------------------------------------------------------------------------
+ * SynthMasterGain
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Mixes down audio from 32-bit to 16-bit target buffer
+ *
+ * Each sample is ((s >> 7) * nGain) >> 9, saturated to 16 bits. With
+ * t = s >> 7 split into (t >> 9) and (t & 511), this is
+ * (t >> 9) * nGain + (((t & 511) * nGain) >> 9), two 16 x 16-bit products
+ * that pmaddwd computes exactly. Samples beyond 32 bits saturate in the
+ * output either way, so narrowing them first does not change the result.
+ *
+ * Inputs:
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+void SynthMasterGain (long *pInputBuffer, EAS_PCM *pOutputBuffer, EAS_U16 nGain, EAS_U16 numSamples)
+{
+    __m128i gain, mask, t0, t1, s0, s1;
+    long s;
+
+    /* the gain must fit a signed 16-bit multiplier */
+    if (nGain <= 32767)
+    {
+        /* (nGain, 0) pairs, the high half of each lane contributes nothing */
+        gain = _mm_set1_epi32(nGain);
+        mask = _mm_set1_epi32(511);
+        for ( ; numSamples >= 8; numSamples -= 8)
+        {
+            t0 = _mm_srai_epi32(MixLoad4(pInputBuffer), 7);
+            t1 = _mm_srai_epi32(MixLoad4(pInputBuffer + 4), 7);
+            s0 = _mm_add_epi32(_mm_madd_epi16(_mm_srai_epi32(t0, 9), gain),
+                _mm_srli_epi32(_mm_madd_epi16(_mm_and_si128(t0, mask), gain), 9));
+            s1 = _mm_add_epi32(_mm_madd_epi16(_mm_srai_epi32(t1, 9), gain),
+                _mm_srli_epi32(_mm_madd_epi16(_mm_and_si128(t1, mask), gain), 9));
+            _mm_storeu_si128((__m128i*) pOutputBuffer, _mm_packs_epi32(s0, s1));
+            pInputBuffer += 8;
+            pOutputBuffer += 8;
+        }
+    }
+
+    /* remaining samples */
+    while (numSamples)
+    {
+        numSamples--;
+        /*lint -e{704} <avoid divide for performance>*/
+        s = *pInputBuffer++ >> 7;
+        s *= (long) nGain;
+        /*lint -e{704} <avoid divide for performance>*/
+        s = s >> 9;
+        s = SATURATE(s);
+        *pOutputBuffer++ = (EAS_PCM) s;
+    }
+}
+#endif
+
+#if defined(UNIFIED_MIXER) && defined(NATIVE_MIX_STREAM)
+/*----------------------------------------------------------------------------
+ * MixAdd4
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Adds four 32-bit lanes to four samples of the mix buffer
+ *
+ *----------------------------------------------------------------------------
+*/
+static void MixAdd4 (EAS_I32 *pMixBuffer, __m128i v)
+{
+    __m128i sign;
+
+    if (sizeof(EAS_I32) == 4)
+    {
+        _mm_storeu_si128((__m128i*) pMixBuffer, _mm_add_epi32(_mm_loadu_si128((const __m128i*) pMixBuffer), v));
+        return;
+    }
+
+    /* sign extend to 64 bits */
+    sign = _mm_srai_epi32(v, 31);
+    _mm_storeu_si128((__m128i*) pMixBuffer,
+        _mm_add_epi64(_mm_loadu_si128((const __m128i*) pMixBuffer), _mm_unpacklo_epi32(v, sign)));
+    _mm_storeu_si128((__m128i*) (pMixBuffer + 2),
+        _mm_add_epi64(_mm_loadu_si128((const __m128i*) (pMixBuffer + 2)), _mm_unpackhi_epi32(v, sign)));
+}
+
+/*----------------------------------------------------------------------------
+ * MixGain4
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns (in * (gain >> 15)) >> NUM_MIXER_GUARD_BITS for four lanes. The
+ * input is given as (in, in) 16-bit pairs. The 17-bit gain is split into
+ * (g >> 1) and g - (g >> 1) so that pmaddwd forms the product exactly.
+ *
+ *----------------------------------------------------------------------------
+*/
+static __m128i MixGain4 (__m128i in, __m128i gain)
+{
+    __m128i g, gh;
+
+    g = _mm_srai_epi32(gain, 15);
+    gh = _mm_srai_epi32(g, 1);
+    g = _mm_or_si128(_mm_and_si128(gh, _mm_set1_epi32(0xffff)), _mm_slli_epi32(_mm_sub_epi32(g, gh), 16));
+    return _mm_srai_epi32(_mm_madd_epi16(in, g), NUM_MIXER_GUARD_BITS);
+}
+
+/*----------------------------------------------------------------------------
+ * MixGainInRange
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns EAS_TRUE if every gain of a ramp fits the vector loop, which
+ * needs (gain >> 15) within [-65535, 65534]. That also keeps the gain in
+ * 32 bits. The ramp is linear, so it is enough to check both ends.
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_BOOL MixGainInRange (EAS_I32 gain, EAS_I32 gainInc, EAS_I32 numSamples)
+{
+    int64_t end;
+
+    end = (int64_t) gain + (int64_t) gainInc * numSamples;
+    return (EAS_BOOL) (((gain >> 15) >= -65535) && ((gain >> 15) <= 65534) &&
+        ((end >> 15) >= -65535) && ((end >> 15) <= 65534));
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_MixStream
+ *----------------------------------------------------------------------------
+ * Mix a 16-bit stream into a 32-bit buffer
+ *
+ * Mono sources, which is what the synthesizer mixes, run four samples at a
+ * time with the gain ramp in the vector lanes. Stereo sources and gains out
+ * of the range of the vector loop use the same arithmetic one sample at a
+ * time, as does the C version in eas_mixer.c.
+ *
+ * pInputBuffer 16-bit input buffer
+ * pMixBuffer   32-bit mix buffer
+ * numSamples   number of samples to mix
+ * gainLeft     initial gain left or mono
+ * gainRight    initial gain right
+ * gainLeft     left gain increment per sample
+ * gainRight    right gain increment per sample
+ * flags        bit 0 = stereo source
+ *              bit 1 = stereo output
+ *----------------------------------------------------------------------------
+*/
+void EAS_MixStream (EAS_PCM *pInputBuffer, EAS_I32 *pMixBuffer, EAS_I32 numSamples, EAS_I32 gainLeft, EAS_I32 gainRight, EAS_I32 gainIncLeft, EAS_I32 gainIncRight, EAS_I32 flags)
+{
+    __m128i in, gainL, gainR, incL, incR, outL, outR;
+    EAS_I32 temp;
+    EAS_INT src, dest;
+    EAS_INT n;
+
+    src = dest = 0;
+    flags &= MIX_FLAGS_STEREO_SOURCE | MIX_FLAGS_STEREO_OUTPUT;
+
+    /* mono source, four samples at a time */
+    if (!(flags & MIX_FLAGS_STEREO_SOURCE) && (numSamples >= 4) &&
+        MixGainInRange(gainLeft, gainIncLeft, numSamples) &&
+        (!(flags & MIX_FLAGS_STEREO_OUTPUT) || MixGainInRange(gainRight, gainIncRight, numSamples)))
+    {
+        /* gains of the next four samples, the ramp steps before each sample */
+        gainL = _mm_set_epi32((int) (gainLeft + 4 * gainIncLeft), (int) (gainLeft + 3 * gainIncLeft),
+            (int) (gainLeft + 2 * gainIncLeft), (int) (gainLeft + gainIncLeft));
+        gainR = _mm_set_epi32((int) (gainRight + 4 * gainIncRight), (int) (gainRight + 3 * gainIncRight),
+            (int) (gainRight + 2 * gainIncRight), (int) (gainRight + gainIncRight));
+        incL = _mm_set1_epi32((int) (4 * gainIncLeft));
+        incR = _mm_set1_epi32((int) (4 * gainIncRight));
+
+        for (n = numSamples & ~3; src < n; src += 4)
+        {
+            in = _mm_loadl_epi64((const __m128i*) &pInputBuffer[src]);
+            in = _mm_unpacklo_epi16(in, in);
+            outL = MixGain4(in, gainL);
+            gainL = _mm_add_epi32(gainL, incL);
+
+            if (flags & MIX_FLAGS_STEREO_OUTPUT)
+            {
+                outR = MixGain4(in, gainR);
+                gainR = _mm_add_epi32(gainR, incR);
+                MixAdd4(&pMixBuffer[dest], _mm_unpacklo_epi32(outL, outR));
+                MixAdd4(&pMixBuffer[dest + 4], _mm_unpackhi_epi32(outL, outR));
+                dest += 8;
+            }
+            else
+            {
+                MixAdd4(&pMixBuffer[dest], outL);
+                dest += 4;
+            }
+        }
+        gainLeft += gainIncLeft * src;
+        gainRight += gainIncRight * src;
+    }
+
+    /* remaining samples */
+    while (src < numSamples)
+    {
+        gainLeft += gainIncLeft;
+        gainRight += gainIncRight;
+        switch (flags)
+        {
+            /* mono to mono */
+            case 0:
+                pMixBuffer[dest++] += (pInputBuffer[src++] * (gainLeft >> 15)) >> NUM_MIXER_GUARD_BITS;
+                break;
+
+            /* mono to stereo */
+            case MIX_FLAGS_STEREO_OUTPUT:
+                pMixBuffer[dest++] += (pInputBuffer[src] * (gainLeft >> 15)) >> NUM_MIXER_GUARD_BITS;
+                pMixBuffer[dest++] += (pInputBuffer[src++] * (gainRight >> 15)) >> NUM_MIXER_GUARD_BITS;
+                break;
+
+            /* stereo to mono */
+            case MIX_FLAGS_STEREO_SOURCE:
+                temp = (pInputBuffer[src++] * (gainLeft >> 15)) >> NUM_MIXER_GUARD_BITS;
+                temp += ((pInputBuffer[src++] * (gainRight >> 15)) >> NUM_MIXER_GUARD_BITS);
+                pMixBuffer[dest++] += temp;
+                break;
+
+            /* stereo to stereo */
+            default:
+                pMixBuffer[dest++] += (pInputBuffer[src++] * (gainLeft >> 15)) >> NUM_MIXER_GUARD_BITS;
+                pMixBuffer[dest++] += (pInputBuffer[src++] * (gainRight >> 15)) >> NUM_MIXER_GUARD_BITS;
+                break;
+        }
+    }
+}
+#endif
+
+#endif
@@ -55,6 +55,20 @@
 /* number of events to parse before calling EAS_HWYield function */
 #define YIELD_EVENT_COUNT       10
 
+#ifdef _HW_MEMORY_ARENA
+/* memory reserved for each instance: the instance data and voice manager,
+ * plus room for the mix buffer, effects and the data of each open stream
+ * (parser, virtual synth and a small DLS collection)
+ */
+#ifndef EAS_ARENA_ENGINE_SIZE
+#define EAS_ARENA_ENGINE_SIZE   (16 * 1024)
+#endif
+#ifndef EAS_ARENA_STREAM_SIZE
+#define EAS_ARENA_STREAM_SIZE   (32 * 1024)
+#endif
+#define EAS_ARENA_SIZE  ((EAS_I32) (sizeof(S_EAS_DATA) + sizeof(S_VOICE_MGR)) + EAS_ARENA_ENGINE_SIZE + (MAX_NUMBER_STREAMS * EAS_ARENA_STREAM_SIZE))
+#endif
+
 /*----------------------------------------------------------------------------
  * easLibConfig
  *
@@ -85,6 +99,7 @@ static const S_EAS_LIB_CONFIG easLibConfig =
 
 /* local prototypes */
 static EAS_RESULT EAS_ParseEvents (S_EAS_DATA *pEASData, S_EAS_STREAM *pStream, EAS_U32 endTime, EAS_INT parseMode);
+static EAS_RESULT EAS_AllocEffect (S_EAS_DATA *pEASData, EAS_INT module);
 
 /*----------------------------------------------------------------------------
  * EAS_SetStreamParameter
@@ -327,6 +342,15 @@ EAS_PUBLIC EAS_RESULT EAS_Init (EAS_DATA_HANDLE *ppEASData)
     if ((result = EAS_HWInit(&pHWInstData)) != EAS_SUCCESS)
         return result;
 
+#ifdef _HW_MEMORY_ARENA
+    /* reserve the instance memory, without it we just use the heap */
+    if (!staticMemoryModel)
+    {
+        if ((result = EAS_HWReserveMemory(pHWInstData, EAS_ARENA_SIZE)) != EAS_SUCCESS)
+            { /* dpp: EAS_ReportEx(_EAS_SEVERITY_WARNING, "EAS_Init: Could not reserve %ld bytes for arena, error %ld\n", EAS_ARENA_SIZE, result); */ }
+    }
+#endif
+
     /* check Configuration Module for S_EAS_DATA allocation */
     if (staticMemoryModel)
         pEASData = EAS_CMEnumData(EAS_CM_EAS_DATA);
@@ -376,19 +400,18 @@ EAS_PUBLIC EAS_RESULT EAS_Init (EAS_DATA_HANDLE *ppEASData)
         return result;
     }
 
-    /* initialize effects modules */
+    /* locate effects modules, they are allocated by EAS_AllocEffect when first used */
     for (module = 0; module < NUM_EFFECTS_MODULES; module++)
-    {
         pEASData->effectsModules[module].effect = EAS_CMEnumFXModules(module);
-        if (pEASData->effectsModules[module].effect != NULL)
-        {
-            if ((result = (*pEASData->effectsModules[module].effect->pfInit)(pEASData, &pEASData->effectsModules[module].effectData)) != EAS_SUCCESS)
-            {
-                { /* dpp: EAS_ReportEx(_EAS_SEVERITY_FATAL, "Initialization of effects module %d returned %d\n", module, result); */ }
-                return result;
-            }
-        }
+
+#ifdef _CHORUS
+    /* CC93 reaches the chorus through its send bus, so it must be running before any MIDI arrives */
+    if (pEASData->effectsModules[EAS_MODULE_CHORUS].effect != NULL)
+    {
+        if ((result = EAS_AllocEffect(pEASData, EAS_MODULE_CHORUS)) != EAS_SUCCESS)
+            return result;
     }
+#endif
 
     /* initialize PCM engine */
     if ((result = EAS_PEInit(pEASData)) != EAS_SUCCESS)
@@ -462,7 +485,7 @@ EAS_PUBLIC EAS_RESULT EAS_Shutdown (EAS_DATA_HANDLE pEASData)
     /* shutdown effects modules */
     for (i = 0; i < NUM_EFFECTS_MODULES; i++)
     {
-        if (pEASData->effectsModules[i].effect)
+        if (pEASData->effectsModules[i].effect && pEASData->effectsModules[i].effectData)
         {
             if ((result = (*pEASData->effectsModules[i].effect->pfShutdown)(pEASData, pEASData->effectsModules[i].effectData)) != EAS_SUCCESS)
             {
@@ -507,6 +530,357 @@ EAS_PUBLIC EAS_RESULT EAS_Shutdown (EAS_DATA_HANDLE pEASData)
     return reportResult;
 }
 
+#ifdef _INSTANCE_POOL
+/* idle instances and the pristine state they are restored to */
+typedef struct s_eas_pool_tag
+{
+    EAS_HW_DATA_HANDLE  hwInstData;
+    EAS_DATA_HANDLE     idle[EAS_MAX_POOL_INSTANCES];
+    EAS_INT             numIdle;
+    S_EAS_DATA          easData;
+    S_VOICE_MGR         voiceMgr;
+    EAS_VOID_PTR        effectsData[NUM_EFFECTS_MODULES];
+} S_EAS_POOL;
+
+/*----------------------------------------------------------------------------
+ * EAS_PoolSaveTemplate()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Saves the state of a freshly initialized instance so that used
+ * instances can be restored with block copies.
+ *
+ * Inputs:
+ *  pPool           - pool handle
+ *  pEASData        - instance that has just been returned by EAS_Init
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT EAS_PoolSaveTemplate (S_EAS_POOL *pPool, S_EAS_DATA *pEASData)
+{
+    S_EFFECTS_MODULE *pModule;
+    EAS_RESULT result;
+    EAS_INT i;
+
+    /* allocate all effects modules now so that a reset never has to */
+    for (i = 0; i < NUM_EFFECTS_MODULES; i++)
+    {
+        if (pEASData->effectsModules[i].effect == NULL)
+            continue;
+        if ((result = EAS_AllocEffect(pEASData, i)) != EAS_SUCCESS)
+            return result;
+    }
+
+    EAS_HWMemCpy(&pPool->easData, pEASData, sizeof(S_EAS_DATA));
+    EAS_HWMemCpy(&pPool->voiceMgr, pEASData->pVoiceMgr, sizeof(S_VOICE_MGR));
+
+    for (i = 0; i < NUM_EFFECTS_MODULES; i++)
+    {
+        pModule = &pEASData->effectsModules[i];
+        if ((pModule->effect == NULL) || (pModule->effectData == NULL))
+            continue;
+        pPool->effectsData[i] = EAS_HWMalloc(pPool->hwInstData, pModule->effect->instDataSize);
+        if (pPool->effectsData[i] == NULL)
+            return EAS_ERROR_MALLOC_FAILED;
+        EAS_HWMemCpy(pPool->effectsData[i], pModule->effectData, pModule->effect->instDataSize);
+    }
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_PoolResetInstance()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Closes any open streams and restores the instance to the state it had
+ * right after EAS_Init, without freeing or allocating its memory.
+ *
+ * Inputs:
+ *  pPool           - pool handle
+ *  pEASData        - handle to data for this instance
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT EAS_PoolResetInstance (S_EAS_POOL *pPool, S_EAS_DATA *pEASData)
+{
+    S_EFFECTS_MODULE effectsModules[NUM_EFFECTS_MODULES];
+    EAS_HW_DATA_HANDLE hwInstData;
+    S_VOICE_MGR *pVoiceMgr;
+    EAS_I32 *pMixBuffer;
+#ifdef _METRICS_ENABLED
+    EAS_VOID_PTR pMetricsData;
+#endif
+    EAS_RESULT result;
+    EAS_INT i;
+
+#ifdef JET_INTERFACE
+    /* JET owns streams and libraries of its own, it must be shut down first */
+    if (pEASData->jetHandle != NULL)
+        return EAS_ERROR_NOT_VALID_IN_THIS_STATE;
+#endif
+
+    /* if there are streams open, close them */
+    for (i = 0; i < MAX_NUMBER_STREAMS; i++)
+    {
+        if (pEASData->streams[i].pParserModule && pEASData->streams[i].handle)
+        {
+            if ((result = (*((S_FILE_PARSER_INTERFACE*)(pEASData->streams[i].pParserModule))->pfClose)(pEASData, pEASData->streams[i].handle)) != EAS_SUCCESS)
+                return result;
+            /* clear the slot so that a failed reset never closes it twice */
+            pEASData->streams[i].pParserModule = NULL;
+            pEASData->streams[i].handle = NULL;
+        }
+    }
+
+    /* restore the voice manager and effects modules */
+    VMRestore(pEASData, &pPool->voiceMgr);
+    for (i = 0; i < NUM_EFFECTS_MODULES; i++)
+    {
+        if ((pPool->effectsData[i] != NULL) && (pEASData->effectsModules[i].effectData != NULL))
+            EAS_HWMemCpy(pEASData->effectsModules[i].effectData, pPool->effectsData[i], pEASData->effectsModules[i].effect->instDataSize);
+    }
+
+    /* restore the instance data, keeping the memory that belongs to this instance */
+    hwInstData = pEASData->hwInstData;
+    pVoiceMgr = pEASData->pVoiceMgr;
+    pMixBuffer = pEASData->pMixBuffer;
+    EAS_HWMemCpy(effectsModules, pEASData->effectsModules, sizeof(effectsModules));
+#ifdef _METRICS_ENABLED
+    pMetricsData = pEASData->pMetricsData;
+#endif
+
+    EAS_HWMemCpy(pEASData, &pPool->easData, sizeof(S_EAS_DATA));
+
+    pEASData->hwInstData = hwInstData;
+    pEASData->pVoiceMgr = pVoiceMgr;
+    pEASData->pMixBuffer = pMixBuffer;
+    EAS_HWMemCpy(pEASData->effectsModules, effectsModules, sizeof(effectsModules));
+#ifdef _METRICS_ENABLED
+    pEASData->pMetricsData = pMetricsData;
+#endif
+    EAS_MixEngineUpdateChain(pEASData);
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_PoolInit()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Creates a pool of initialized instances (dynamic memory model only)
+ *
+ * Inputs:
+ *  ppPool          - pointer to pool handle variable
+ *  numInstances    - number of instances to initialize now
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_PoolInit (EAS_POOL_HANDLE *ppPool, EAS_INT numInstances)
+{
+    EAS_HW_DATA_HANDLE hwInstData;
+    S_EAS_POOL *pPool;
+    EAS_DATA_HANDLE pEASData;
+    EAS_RESULT result;
+
+    *ppPool = NULL;
+    if ((numInstances < 1) || (numInstances > EAS_MAX_POOL_INSTANCES))
+        return EAS_ERROR_PARAMETER_RANGE;
+
+    /* the static memory model only has room for one instance */
+    if (EAS_CMStaticMemoryModel())
+        return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+
+    /* the pool has its own host wrapper instance for its memory */
+    if ((result = EAS_HWInit(&hwInstData)) != EAS_SUCCESS)
+        return result;
+    pPool = EAS_HWMalloc(hwInstData, sizeof(S_EAS_POOL));
+    if (pPool == NULL)
+    {
+        EAS_HWShutdown(hwInstData);
+        return EAS_ERROR_MALLOC_FAILED;
+    }
+    EAS_HWMemSet(pPool, 0, sizeof(S_EAS_POOL));
+    pPool->hwInstData = hwInstData;
+
+    /* the first instance is the template for all the others */
+    while (pPool->numIdle < numInstances)
+    {
+        if ((result = EAS_Init(&pEASData)) != EAS_SUCCESS)
+            break;
+        pPool->idle[pPool->numIdle++] = pEASData;
+        if ((pPool->numIdle == 1) && ((result = EAS_PoolSaveTemplate(pPool, pEASData)) != EAS_SUCCESS))
+            break;
+    }
+    if (result != EAS_SUCCESS)
+    {
+        { /* dpp: EAS_ReportEx(_EAS_SEVERITY_ERROR, "EAS_PoolInit: Failed to initialize instance %d, error %ld\n", pPool->numIdle, result); */ }
+        EAS_PoolShutdown(pPool);
+        return result;
+    }
+
+    *ppPool = pPool;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_PoolGet()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Hands out an idle instance from the pool. If the pool is empty, a new
+ * instance is initialized.
+ *
+ * Inputs:
+ *  pPool           - pool handle
+ *  ppEASData       - pointer to data handle variable
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_PoolGet (EAS_POOL_HANDLE pPool, EAS_DATA_HANDLE *ppEASData)
+{
+    if (pPool->numIdle == 0)
+        return EAS_Init(ppEASData);
+
+    *ppEASData = pPool->idle[--pPool->numIdle];
+    pPool->idle[pPool->numIdle] = NULL;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_PoolRelease()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns an instance to the pool. Open streams are closed and the
+ * instance is restored to its initial state. If the pool is full or the
+ * instance cannot be reset, it is shut down instead.
+ *
+ * Inputs:
+ *  pPool           - pool handle
+ *  pEASData        - handle to data for this instance
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_PoolRelease (EAS_POOL_HANDLE pPool, EAS_DATA_HANDLE pEASData)
+{
+    /* check for NULL handle */
+    if (!pEASData)
+        return EAS_ERROR_HANDLE_INTEGRITY;
+
+    if ((pPool->numIdle < EAS_MAX_POOL_INSTANCES) && (EAS_PoolResetInstance(pPool, pEASData) == EAS_SUCCESS))
+    {
+        pPool->idle[pPool->numIdle++] = pEASData;
+        return EAS_SUCCESS;
+    }
+    return EAS_Shutdown(pEASData);
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_PoolShutdown()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Shuts down all idle instances and frees the pool. Instances that are
+ * still in use must be released or shut down by the caller.
+ *
+ * Inputs:
+ *  pPool           - pool handle
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_PoolShutdown (EAS_POOL_HANDLE pPool)
+{
+    EAS_HW_DATA_HANDLE hwInstData;
+    EAS_RESULT reportResult = EAS_SUCCESS;
+    EAS_RESULT result;
+    EAS_INT i;
+
+    /* check for NULL handle */
+    if (!pPool)
+        return EAS_ERROR_HANDLE_INTEGRITY;
+
+    while (pPool->numIdle > 0)
+    {
+        if ((result = EAS_Shutdown(pPool->idle[--pPool->numIdle])) != EAS_SUCCESS)
+            reportResult = result;
+    }
+
+    for (i = 0; i < NUM_EFFECTS_MODULES; i++)
+    {
+        if (pPool->effectsData[i] != NULL)
+            EAS_HWFree(pPool->hwInstData, pPool->effectsData[i]);
+    }
+
+    hwInstData = pPool->hwInstData;
+    EAS_HWFree(hwInstData, pPool);
+    if ((result = EAS_HWShutdown(hwInstData)) != EAS_SUCCESS)
+        reportResult = result;
+    return reportResult;
+}
+
+#else
+/*----------------------------------------------------------------------------
+ * EAS_PoolInit()
+ *----------------------------------------------------------------------------
+ * Instance pools are not available in this build
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_PoolInit (EAS_POOL_HANDLE *ppPool, EAS_INT numInstances)
+{
+    (void) numInstances;
+
+    *ppPool = NULL;
+    return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_PoolGet()
+ *----------------------------------------------------------------------------
+ * Instance pools are not available in this build
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_PoolGet (EAS_POOL_HANDLE pPool, EAS_DATA_HANDLE *ppEASData)
+{
+    (void) pPool;
+
+    *ppEASData = NULL;
+    return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_PoolRelease()
+ *----------------------------------------------------------------------------
+ * Instance pools are not available in this build
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_PoolRelease (EAS_POOL_HANDLE pPool, EAS_DATA_HANDLE pEASData)
+{
+    (void) pPool;
+    (void) pEASData;
+
+    return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_PoolShutdown()
+ *----------------------------------------------------------------------------
+ * Instance pools are not available in this build
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_PoolShutdown (EAS_POOL_HANDLE pPool)
+{
+    (void) pPool;
+
+    return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+}
+#endif
+
 #ifdef JET_INTERFACE
 /*----------------------------------------------------------------------------
  * EAS_OpenJETStream()
@@ -701,13 +1075,23 @@ EAS_PUBLIC EAS_RESULT EAS_Prepare (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream)
  *
  *----------------------------------------------------------------------------
 */
+#ifdef _HW_ALLOC_GUARD
+static EAS_RESULT EAS_RenderFrame (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I32 numRequested, EAS_I32 *pNumGenerated)
+#else
 EAS_PUBLIC EAS_RESULT EAS_Render (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I32 numRequested, EAS_I32 *pNumGenerated)
+#endif
 {
     S_FILE_PARSER_INTERFACE *pParserModule;
     EAS_RESULT result;
     EAS_I32 voicesRendered;
     EAS_STATE parserState;
     EAS_INT streamNum;
+#ifdef _ADAPTIVE_POLYPHONY
+    uint64_t startTime;
+    uint64_t frameTime;
+
+    startTime = EAS_HWGetTime(pEASData->hwInstData);
+#endif
 
     /* assume no samples generated and reset workload */
     *pNumGenerated = 0;
@@ -903,6 +1287,16 @@ EAS_PUBLIC EAS_RESULT EAS_Render (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I
     /* advance render time */
     pEASData->renderTime += AUDIO_FRAME_LENGTH;
 
+#ifdef _ADAPTIVE_POLYPHONY
+    /* adjust polyphony to the time this frame took, a clock that failed or
+     * went back counts as no time and a huge delta is limited to fit */
+    frameTime = EAS_HWGetTime(pEASData->hwInstData);
+    frameTime = (frameTime > startTime) ? frameTime - startTime : 0;
+    if (frameTime > 0x7fffffff)
+        frameTime = 0x7fffffff;
+    VMUpdateRenderLoad(pEASData->pVoiceMgr, (EAS_I32) frameTime);
+#endif
+
 #if 0
     /* dump workload for debug */
     if (pEASData->pVoiceMgr->workload)
@@ -939,6 +1333,38 @@ EAS_PUBLIC EAS_RESULT EAS_Render (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I
     return EAS_SUCCESS;
 }
 
+#ifdef _HW_ALLOC_GUARD
+/*----------------------------------------------------------------------------
+ * EAS_Render()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Debug version of EAS_Render. All memory needed for playback must be
+ * allocated by EAS_OpenFile, EAS_Prepare and the JET queueing calls, and
+ * released by EAS_CloseFile and the JET calls, so any allocation while a
+ * frame is rendered is reported and fails, and any release is reported.
+ *
+ * Inputs:
+ *  pEASData        - buffer for internal EAS data
+ *  pOut            - output buffer pointer
+ *  nNumRequested   - requested num samples to generate
+ *  pnNumGenerated  - actual number of samples generated
+ *
+ * Outputs:
+ *  EAS_SUCCESS if PCM data was successfully rendered
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_Render (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I32 numRequested, EAS_I32 *pNumGenerated)
+{
+    EAS_RESULT result;
+
+    EAS_HWSetAllocGuard(pEASData->hwInstData, EAS_TRUE);
+    result = EAS_RenderFrame(pEASData, pOut, numRequested, pNumGenerated);
+    EAS_HWSetAllocGuard(pEASData->hwInstData, EAS_FALSE);
+    return result;
+}
+#endif
+
 #ifdef JET_INTERFACE
 /*----------------------------------------------------------------------------
  * EAS_SetTransposition)
@@ -1567,15 +1993,61 @@ EAS_PUBLIC EAS_RESULT EAS_Resume (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream)
 */
 EAS_PUBLIC EAS_RESULT EAS_SetParameter (EAS_DATA_HANDLE pEASData, EAS_I32 module, EAS_I32 param, EAS_I32 value)
 {
+    S_EFFECTS_MODULE *pModule;
+    EAS_RESULT result;
 
-    if (module >= NUM_EFFECTS_MODULES)
+    if ((module < 0) || (module >= NUM_EFFECTS_MODULES))
         return EAS_ERROR_INVALID_MODULE;
 
-    if (pEASData->effectsModules[module].effectData == NULL)
+    if ((result = EAS_AllocEffect(pEASData, (EAS_INT) module)) != EAS_SUCCESS)
+        return result;
+
+    pModule = &pEASData->effectsModules[module];
+    if ((result = (*pModule->effect->pFSetParam)(pModule->effectData, param, value)) != EAS_SUCCESS)
+        return result;
+
+    /* add or remove the module from the effects chain */
+    if (param == pModule->effect->bypassParam)
+        EAS_MixEngineUpdateChain(pEASData);
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_AllocEffect()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Allocates and initializes an effects module the first time it is used,
+ * so that modules an application never enables cost no memory.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * module           - enumerated module number
+ *
+ * Outputs:
+ * EAS_ERROR_INVALID_MODULE if the module is not in this build
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT EAS_AllocEffect (S_EAS_DATA *pEASData, EAS_INT module)
+{
+    S_EFFECTS_MODULE *pModule;
+    EAS_RESULT result;
+
+    pModule = &pEASData->effectsModules[module];
+    if (pModule->effect == NULL)
         return EAS_ERROR_INVALID_MODULE;
+    if (pModule->effectData != NULL)
+        return EAS_SUCCESS;
 
-    return (*pEASData->effectsModules[module].effect->pFSetParam)
-        (pEASData->effectsModules[module].effectData, param, value);
+    if ((result = (*pModule->effect->pfInit)(pEASData, &pModule->effectData)) != EAS_SUCCESS)
+    {
+        { /* dpp: EAS_ReportEx(_EAS_SEVERITY_ERROR, "Initialization of effects module %d returned %d\n", module, result); */ }
+        pModule->effectData = NULL;
+        return result;
+    }
+
+    EAS_MixEngineUpdateChain(pEASData);
+    return EAS_SUCCESS;
 }
 
 #ifdef _METRICS_ENABLED
@@ -1629,6 +2101,64 @@ EAS_PUBLIC EAS_RESULT EAS_MetricsReset (EAS_DATA_HANDLE pEASData)
 }
 #endif
 
+/*----------------------------------------------------------------------------
+ * EAS_GetMemoryUsage()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns the dynamic memory used by this instance.
+ *
+ * Inputs:
+ * pEASData         - instance data handle
+ *
+ * Outputs:
+ * pCurrent         - bytes allocated now
+ * pPeak            - most bytes allocated at one time
+ * pHighWater       - highest offset used in the instance arena
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_GetMemoryUsage (EAS_DATA_HANDLE pEASData, EAS_I32 *pCurrent, EAS_I32 *pPeak, EAS_I32 *pHighWater)
+{
+    if (!pEASData)
+        return EAS_ERROR_HANDLE_INTEGRITY;
+
+#ifdef _HW_MEMORY_ARENA
+    return EAS_HWGetMemoryUsage(pEASData->hwInstData, pCurrent, pPeak, pHighWater);
+#else
+    (void) pCurrent;
+    (void) pPeak;
+    (void) pHighWater;
+    return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ * EAS_SetRenderBudget()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Sets the render time budget for this instance.
+ *
+ * Inputs:
+ * pEASData         - instance data handle
+ * budget           - render budget in microseconds per buffer, 0 = off
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_SetRenderBudget (EAS_DATA_HANDLE pEASData, EAS_I32 budget)
+{
+    if (!pEASData || !pEASData->pVoiceMgr)
+        return EAS_ERROR_HANDLE_INTEGRITY;
+
+#ifdef _ADAPTIVE_POLYPHONY
+    return VMSetRenderBudget(pEASData->pVoiceMgr, budget);
+#else
+    (void) budget;
+    return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+#endif
+}
+
 #ifdef FILE_HEADER_SEARCH
 /*----------------------------------------------------------------------------
  * EAS_SearchFile
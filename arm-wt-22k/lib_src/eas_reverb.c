@@ -48,6 +48,26 @@ static void ReverbProcess (EAS_VOID_PTR pInstData, EAS_PCM *pSrc, EAS_PCM *pDst,
 static EAS_RESULT ReverbShutdown (EAS_DATA_HANDLE pEASData, EAS_VOID_PTR pInstData);
 static EAS_RESULT ReverbGetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 *pValue);
 static EAS_RESULT ReverbSetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32 value);
+static void ReverbProcess32 (EAS_VOID_PTR pInstData, EAS_I32 *pMix, EAS_I32 numSamples);
+
+#ifdef _REVERB
+static void ReverbProcessSend (EAS_VOID_PTR pInstData, EAS_I32 *pSend, EAS_I32 *pMix, EAS_I32 numSamples);
+#endif
+
+/* 32-bit processing */
+static void ReverbProcessBus (S_REVERB_OBJECT *pReverbData, const EAS_I32 *pSend, EAS_I32 *pMix, EAS_I32 numSamples, EAS_I32 nShift);
+
+/* per call bookkeeping and idle detection */
+static EAS_BOOL ReverbStart (S_REVERB_OBJECT *pReverbData, EAS_BOOL bSilent, EAS_I32 numSamples);
+static void ReverbFinish (S_REVERB_OBJECT *pReverbData, EAS_I32 numSamples);
+static EAS_BOOL ReverbInputSilent (const EAS_PCM *pSrc, EAS_I32 numSamples);
+static void ReverbCheckIdle (S_REVERB_OBJECT *pReverbData, EAS_BOOL bSilent, EAS_I32 numSamples);
+static void ReverbClear (S_REVERB_OBJECT *pReverbData);
+
+/* half rate mode */
+static void ReverbSetRate (S_REVERB_OBJECT *pReverbData, EAS_I16 nRateShift);
+static void ReverbRun (S_REVERB_OBJECT *pReverbData, EAS_INT numSamples, EAS_PCM *pOutputBuffer, EAS_PCM *pInputBuffer);
+static EAS_I32 ReverbRunPairs (S_REVERB_OBJECT *pReverbData, EAS_INT numPairs, EAS_PCM *pOutputBuffer, const EAS_PCM *pInputBuffer);
 
 /* common effects interface for configuration module */
 const S_EFFECTS_INTERFACE EAS_Reverb =
@@ -56,7 +76,53 @@ const S_EFFECTS_INTERFACE EAS_Reverb =
     ReverbProcess,
     ReverbShutdown,
     ReverbGetParam,
-    ReverbSetParam
+    ReverbSetParam,
+    ReverbProcess32,
+    EAS_PARAM_REVERB_BYPASS
+#ifdef _INSTANCE_POOL
+    , sizeof(S_REVERB_OBJECT)
+#endif
+#if defined(_REVERB) || defined(_CHORUS)
+#ifdef _REVERB
+    , ReverbProcessSend
+#else
+    , NULL
+#endif
+#endif
+};
+
+/* preset bank, indexed by E_REVERB_PRESETS */
+#define REVERB_PRESET(fbk, fwd, wet, xfade, ap0Gain, ap0Out, ap1Gain, ap1Out) \
+    { fbk, fwd, REVERB_HALF_RATE_FBK(fbk), REVERB_HALF_RATE_FWD(fwd, fbk), \
+      0, wet, 32767, 127, REVERB_TIME_TO_SAMPLES(xfade), \
+      ap0Gain, REVERB_TIME_TO_SAMPLES(ap0Out), ap1Gain, REVERB_TIME_TO_SAMPLES(ap1Out) }
+
+static const S_REVERB_PRESET reverbPresets[REVERB_MAX_ROOM_TYPE] =
+{
+    /*            lpf fbk  lpf fwd  wet    xfade  ap0 gain ap0 out ap1 gain ap1 out */
+    REVERB_PRESET(8307,    14768,   27690, 6388,  15691,   711,    17999,   1113),     /* large hall */
+    REVERB_PRESET(6461,    14307,   27690, 6391,  15230,   708,    9692,    1113),     /* hall */
+    REVERB_PRESET(5077,    12922,   24460, 6449,  15691,   774,    15691,   1113),     /* chamber */
+    REVERB_PRESET(5077,    11076,   23075, 6470,  14768,   792,    15783,   1113)      /* room */
+};
+
+/* crossfade sin and cos for each step of m_nPhase, [phase decreasing/increasing][step][sin/cos] */
+#define REVERB_XFADE_ROW(up) \
+    { \
+        REVERB_XFADE_ENTRY(up, 0),  REVERB_XFADE_ENTRY(up, 1),  REVERB_XFADE_ENTRY(up, 2),  REVERB_XFADE_ENTRY(up, 3), \
+        REVERB_XFADE_ENTRY(up, 4),  REVERB_XFADE_ENTRY(up, 5),  REVERB_XFADE_ENTRY(up, 6),  REVERB_XFADE_ENTRY(up, 7), \
+        REVERB_XFADE_ENTRY(up, 8),  REVERB_XFADE_ENTRY(up, 9),  REVERB_XFADE_ENTRY(up, 10), REVERB_XFADE_ENTRY(up, 11), \
+        REVERB_XFADE_ENTRY(up, 12), REVERB_XFADE_ENTRY(up, 13), REVERB_XFADE_ENTRY(up, 14), REVERB_XFADE_ENTRY(up, 15), \
+        REVERB_XFADE_ENTRY(up, 16), REVERB_XFADE_ENTRY(up, 17), REVERB_XFADE_ENTRY(up, 18), REVERB_XFADE_ENTRY(up, 19), \
+        REVERB_XFADE_ENTRY(up, 20), REVERB_XFADE_ENTRY(up, 21), REVERB_XFADE_ENTRY(up, 22), REVERB_XFADE_ENTRY(up, 23), \
+        REVERB_XFADE_ENTRY(up, 24), REVERB_XFADE_ENTRY(up, 25), REVERB_XFADE_ENTRY(up, 26), REVERB_XFADE_ENTRY(up, 27), \
+        REVERB_XFADE_ENTRY(up, 28), REVERB_XFADE_ENTRY(up, 29), REVERB_XFADE_ENTRY(up, 30), REVERB_XFADE_ENTRY(up, 31)  \
+    }
+
+static const EAS_I16 reverbXfadeSinCos[2][REVERB_XFADE_STEPS][2] =
+{
+    REVERB_XFADE_ROW(0),
+    REVERB_XFADE_ROW(1)
 };
 
 
@@ -74,12 +140,8 @@ const S_EFFECTS_INTERFACE EAS_Reverb =
 */
 static EAS_RESULT ReverbInit(EAS_DATA_HANDLE pEASData, EAS_VOID_PTR *pInstData)
 {
-    EAS_I32 i;
     EAS_U16 nOffset;
-    EAS_INT temp;
-
     S_REVERB_OBJECT *pReverbData;
-    S_REVERB_PRESET *pPreset;
 
     /* check Configuration Module for data allocation */
     if (pEASData->staticMemoryModel)
@@ -95,38 +157,18 @@ static EAS_RESULT ReverbInit(EAS_DATA_HANDLE pEASData, EAS_VOID_PTR *pInstData)
         return EAS_ERROR_MALLOC_FAILED;
     }
 
-    /* clear the structure */
+    /* clear the structure, this also clears the delay line and the filter state */
     EAS_HWMemSet(pReverbData, 0, sizeof(S_REVERB_OBJECT));
 
-    ReverbReadInPresets(pReverbData);
-
-    pReverbData->m_nMinSamplesToAdd = REVERB_UPDATE_PERIOD_IN_SAMPLES;
-
-    pReverbData->m_nRevOutFbkR = 0;
-    pReverbData->m_nRevOutFbkL = 0;
+    // full rate, using the whole delay line
+    pReverbData->m_nBufferMask = REVERB_BUFFER_MASK;
+    pReverbData->m_nIdleGain = REVERB_IDLE_FADE_SAMPLES;
 
     pReverbData->m_sAp0.m_zApIn  = AP0_IN;
-    pReverbData->m_sAp0.m_zApOut = AP0_IN + DEFAULT_AP0_LENGTH;
-    pReverbData->m_sAp0.m_nApGain = DEFAULT_AP0_GAIN;
-
-    pReverbData->m_zD0In = DELAY0_IN;
-
     pReverbData->m_sAp1.m_zApIn  = AP1_IN;
-    pReverbData->m_sAp1.m_zApOut = AP1_IN + DEFAULT_AP1_LENGTH;
-    pReverbData->m_sAp1.m_nApGain = DEFAULT_AP1_GAIN;
-
+    pReverbData->m_zD0In = DELAY0_IN;
     pReverbData->m_zD1In = DELAY1_IN;
 
-    pReverbData->m_zLpf0    = 0;
-    pReverbData->m_zLpf1    = 0;
-    pReverbData->m_nLpfFwd  = 8837;
-    pReverbData->m_nLpfFbk  = 6494;
-
-    pReverbData->m_nSin     = 0;
-    pReverbData->m_nCos     = 0;
-    pReverbData->m_nSinIncrement    = 0;
-    pReverbData->m_nCosIncrement    = 0;
-
     // set xfade parameters
     pReverbData->m_nXfadeInterval = (EAS_U16)REVERB_XFADE_PERIOD_IN_SAMPLES;
     pReverbData->m_nXfadeCounter = pReverbData->m_nXfadeInterval + 1;   // force update on first iteration
@@ -162,88 +204,24 @@ static EAS_RESULT ReverbInit(EAS_DATA_HANDLE pEASData, EAS_VOID_PTR *pInstData)
     pReverbData->m_zD1Self  =
         DELAY1_OUT - pReverbData->m_nMaxExcursion + nOffset;
 
-    // for debugging purposes, allow noise generator
-    pReverbData->m_bUseNoise = EAS_FALSE;
-
     // for debugging purposes, allow bypass
     pReverbData->m_bBypass = EAS_TRUE;  //EAS_FALSE;
 
-    pReverbData->m_nNextRoom = 1;
-
-    pReverbData->m_nCurrentRoom = pReverbData->m_nNextRoom + 1; // force update on first iteration
-
-    pReverbData->m_nWet = REVERB_DEFAULT_WET;
-
-    pReverbData->m_nDry = REVERB_DEFAULT_DRY;
-
-    // set base index into circular buffer
-    pReverbData->m_nBaseIndex = 0;
-
-    // set the early reflections, L
+    // the early reflections are not used by the presets, their gains stay at zero
     pReverbData->m_sEarlyL.m_nLpfFbk = 4915;
     pReverbData->m_sEarlyL.m_nLpfFwd = 27852;
-    pReverbData->m_sEarlyL.m_zLpf = 0;
-
-    for (i=0; i < REVERB_MAX_NUM_REFLECTIONS; i++)
-    {
-        pReverbData->m_sEarlyL.m_nGain[i] = 0;
-        pReverbData->m_sEarlyL.m_zDelay[i] = 0;
-    }
-
-    // set the early reflections, R
     pReverbData->m_sEarlyR.m_nLpfFbk = 4915;
     pReverbData->m_sEarlyR.m_nLpfFwd = 27852;
-    pReverbData->m_sEarlyR.m_zLpf = 0;
-
-    for (i=0; i < REVERB_MAX_NUM_REFLECTIONS; i++)
-    {
-        pReverbData->m_sEarlyR.m_nGain[i] = 0;
-        pReverbData->m_sEarlyR.m_zDelay[i] = 0;
-    }
-
-    // clear the reverb delay line
-    for (i=0; i < REVERB_BUFFER_SIZE_IN_SAMPLES; i++)
-    {
-        pReverbData->m_nDelayLine[i] = 0;
-    }
-
-    ////////////////////////////////
-    ///code from the EAS DEMO Reverb
-    //now copy from the new preset into the reverb
-    pPreset = &pReverbData->m_sPreset.m_sPreset[pReverbData->m_nNextRoom];
-
-    pReverbData->m_nLpfFbk = pPreset->m_nLpfFbk;
-    pReverbData->m_nLpfFwd = pPreset->m_nLpfFwd;
-
-    pReverbData->m_nEarly = pPreset->m_nEarly;
-    pReverbData->m_nWet = pPreset->m_nWet;
-    pReverbData->m_nDry = pPreset->m_nDry;
-
-    pReverbData->m_nMaxExcursion = pPreset->m_nMaxExcursion;
-    //stored as time based, convert to sample based
-    temp = pPreset->m_nXfadeInterval;
-    /*lint -e{702} shift for performance */
-    temp = (temp * _OUTPUT_SAMPLE_RATE) >> 16;
-    pReverbData->m_nXfadeInterval = (EAS_U16) temp;
-    //gsReverbObject.m_nXfadeInterval = pPreset->m_nXfadeInterval;
 
-    pReverbData->m_sAp0.m_nApGain = pPreset->m_nAp0_ApGain;
-    //stored as time based, convert to absolute sample value
-    temp = pPreset->m_nAp0_ApOut;
-    /*lint -e{702} shift for performance */
-    temp = (temp * _OUTPUT_SAMPLE_RATE) >> 16;
-    pReverbData->m_sAp0.m_zApOut = (EAS_U16) (pReverbData->m_sAp0.m_zApIn + temp);
-    //gsReverbObject.m_sAp0.m_zApOut = pPreset->m_nAp0_ApOut;
+#ifdef _REVERB_HALF_RATE
+    // the delay line only has room for the half rate layout
+    pReverbData->m_nNextRateShift = 1;
+    ReverbSetRate(pReverbData, 1);
+#endif
 
-    pReverbData->m_sAp1.m_nApGain = pPreset->m_nAp1_ApGain;
-    //stored as time based, convert to absolute sample value
-    temp = pPreset->m_nAp1_ApOut;
-    /*lint -e{702} shift for performance */
-    temp = (temp * _OUTPUT_SAMPLE_RATE) >> 16;
-    pReverbData->m_sAp1.m_zApOut = (EAS_U16) (pReverbData->m_sAp1.m_zApIn + temp);
-    //gsReverbObject.m_sAp1.m_zApOut = pPreset->m_nAp1_ApOut;
-    ///code from the EAS DEMO Reverb
-    ////////////////////////////////
+    // load the default room, a different preset set before the first buffer is loaded by ReverbStart
+    pReverbData->m_nNextRoom = REVERB_DEFAULT_ROOM_NUMBER;
+    ReverbUpdateRoom(pReverbData);
 
     *pInstData = pReverbData;
 
@@ -275,6 +253,7 @@ static EAS_RESULT ReverbInit(EAS_DATA_HANDLE pEASData, EAS_VOID_PTR *pInstData)
 static void ReverbProcess(EAS_VOID_PTR pInstData, EAS_PCM *pSrc, EAS_PCM *pDst, EAS_I32 numSamples)
 {
     S_REVERB_OBJECT *pReverbData;
+    EAS_BOOL bSilent;
 
     pReverbData = (S_REVERB_OBJECT*) pInstData;
 
@@ -287,6 +266,171 @@ static void ReverbProcess(EAS_VOID_PTR pInstData, EAS_PCM *pSrc, EAS_PCM *pDst,
         return;
     }
 
+    bSilent = ReverbInputSilent(pSrc, numSamples);
+    if (ReverbStart(pReverbData, bSilent, numSamples))
+    {
+        ReverbRun(pReverbData, numSamples, pDst, pSrc);
+        ReverbCheckIdle(pReverbData, bSilent, numSamples);
+    }
+
+    ReverbFinish(pReverbData, numSamples);
+
+}   /* end ComputeReverb */
+
+/*----------------------------------------------------------------------------
+ * ReverbProcess32()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Reverberate the 32-bit mix buffer in place, after the master gain and
+ * before the final conversion to 16 bits. The mix buffer is at the 16-bit
+ * output level here, so the wet signal is added without any scaling and
+ * only the final conversion saturates.
+ *
+ * Inputs:
+ * pMix             - mix buffer, interleaved stereo
+ * numSamples       - number of samples per channel
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ * - wet signal is added to the mix buffer
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ReverbProcess32(EAS_VOID_PTR pInstData, EAS_I32 *pMix, EAS_I32 numSamples)
+{
+    ReverbProcessBus((S_REVERB_OBJECT*) pInstData, pMix, pMix, numSamples, 0);
+}
+
+#ifdef _REVERB
+/*----------------------------------------------------------------------------
+ * ReverbProcessSend()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Reverberate the reverb send bus and add the wet signal to the mix buffer.
+ * Both buffers are in the 32-bit mix domain, before the master gain. The
+ * send is scaled down by REVERB_SEND_SHIFT for the 16-bit network, and the
+ * wet output scaled back up, so it is summed with the dry voices before the
+ * final conversion to 16 bits. The dry level does not apply, the voices
+ * reach the mix buffer directly.
+ *
+ * Inputs:
+ * pSend            - reverb send bus, interleaved stereo
+ * pMix             - mix buffer, interleaved stereo
+ * numSamples       - number of samples per channel
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ * - wet signal is added to the mix buffer
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ReverbProcessSend(EAS_VOID_PTR pInstData, EAS_I32 *pSend, EAS_I32 *pMix, EAS_I32 numSamples)
+{
+    ReverbProcessBus((S_REVERB_OBJECT*) pInstData, pSend, pMix, numSamples, REVERB_SEND_SHIFT);
+}
+#endif
+
+/*----------------------------------------------------------------------------
+ * ReverbProcessBus()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Runs a 32-bit input through the 16-bit reverb network in blocks of
+ * REVERB_BLOCK_SIZE and adds the wet signal to a 32-bit mix buffer. The
+ * input is scaled down by nShift and saturated, the wet signal scaled back
+ * up. pSend and pMix may be the same buffer.
+ *
+ * Inputs:
+ * pSend            - input, interleaved stereo
+ * pMix             - mix buffer, interleaved stereo
+ * numSamples       - number of samples per channel
+ * nShift           - level of the input relative to the 16-bit network
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ReverbProcessBus(S_REVERB_OBJECT *pReverbData, const EAS_I32 *pSend, EAS_I32 *pMix, EAS_I32 numSamples, EAS_I32 nShift)
+{
+    EAS_PCM nIn[NUM_OUTPUT_CHANNELS * REVERB_BLOCK_SIZE];
+    EAS_PCM nOut[NUM_OUTPUT_CHANNELS * REVERB_BLOCK_SIZE];
+    EAS_BOOL bSilent;
+    EAS_I32 nOr;
+    EAS_I32 nLevel;
+    EAS_I32 nRemaining;
+    EAS_I32 n;
+    EAS_I32 i;
+    EAS_I32 tempValue;
+
+    // nothing to add if bypassed or the preset has no wet signal
+    if (pReverbData->m_bBypass || (pReverbData->m_nWet == 0))
+        return;
+
+    nOr = 0;
+    for (i = 0; i < numSamples * NUM_OUTPUT_CHANNELS; i++)
+        nOr |= pSend[i];
+    bSilent = (EAS_BOOL) (nOr == 0);
+
+    if (ReverbStart(pReverbData, bSilent, numSamples))
+    {
+        nLevel = 0;
+        for (nRemaining = numSamples; nRemaining > 0; nRemaining -= n)
+        {
+            n = (nRemaining < REVERB_BLOCK_SIZE) ? nRemaining : REVERB_BLOCK_SIZE;
+
+            for (i = 0; i < n * NUM_OUTPUT_CHANNELS; i++)
+            {
+                /*lint -e{702} use shift for performance */
+                tempValue = pSend[i] >> nShift;
+                nIn[i] = (EAS_PCM) SATURATE(tempValue);
+                nOut[i] = 0;
+            }
+
+            ReverbRun(pReverbData, (EAS_INT) n, nOut, nIn);
+            nLevel |= pReverbData->m_nTailLevel;
+
+            for (i = 0; i < n * NUM_OUTPUT_CHANNELS; i++)
+                pMix[i] += (EAS_I32) nOut[i] * (1 << nShift);
+
+            pSend += n * NUM_OUTPUT_CHANNELS;
+            pMix += n * NUM_OUTPUT_CHANNELS;
+        }
+
+        pReverbData->m_nTailLevel = nLevel;
+        ReverbCheckIdle(pReverbData, bSilent, numSamples);
+    }
+
+    ReverbFinish(pReverbData, numSamples);
+}
+
+/*----------------------------------------------------------------------------
+ * ReverbStart
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Applies any pending room change and crossfade update for the next
+ * numSamples. Returns EAS_FALSE if the reverb is idle and its input is
+ * silent, in which case only the tap modulation is advanced and the
+ * network does not need to run.
+ *
+ * Inputs:
+ * bSilent          - EAS_TRUE if the input for this call is silent
+ * numSamples       - number of samples to process
+ *
+ * Outputs:
+ * EAS_TRUE if Reverb() must be called
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_BOOL ReverbStart(S_REVERB_OBJECT *pReverbData, EAS_BOOL bSilent, EAS_I32 numSamples)
+{
+    EAS_I32 nNetworkSamples;
+
+    if (pReverbData->m_nNextRateShift != pReverbData->m_nRateShift)
+    {
+        ReverbSetRate(pReverbData, pReverbData->m_nNextRateShift);
+    }
+
     if (pReverbData->m_nNextRoom != pReverbData->m_nCurrentRoom)
     {
         ReverbUpdateRoom(pReverbData);
@@ -294,8 +438,35 @@ static void ReverbProcess(EAS_VOID_PTR pInstData, EAS_PCM *pSrc, EAS_PCM *pDst,
 
     ReverbUpdateXfade(pReverbData, numSamples);
 
-    Reverb(pReverbData, numSamples, pDst, pSrc);
+    //once the tail has died away, skip the reverb until there is input again
+    if (pReverbData->m_bIdle && bSilent)
+    {
+        // keep the tap modulation running so the reverb resumes where it would have been,
+        // at half rate a sample left over from the last call pairs with the first one
+        nNetworkSamples = (numSamples + pReverbData->m_nPending) >> pReverbData->m_nRateShift;
+        pReverbData->m_nPending = (EAS_I16) ((numSamples + pReverbData->m_nPending) & pReverbData->m_nRateShift);
+        pReverbData->m_nPendingL = 0;
+        pReverbData->m_nPendingR = 0;
+        pReverbData->m_nSin = (EAS_I16) (pReverbData->m_nSin + pReverbData->m_nSinIncrement * nNetworkSamples);
+        pReverbData->m_nCos = (EAS_I16) (pReverbData->m_nCos + pReverbData->m_nCosIncrement * nNetworkSamples);
+        pReverbData->m_nBaseIndex = (EAS_U16) (pReverbData->m_nBaseIndex - nNetworkSamples);
+        return EAS_FALSE;
+    }
 
+    pReverbData->m_bIdle = EAS_FALSE;
+    return EAS_TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * ReverbFinish
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Advances the update counter by the samples processed in this call
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ReverbFinish(S_REVERB_OBJECT *pReverbData, EAS_I32 numSamples)
+{
     /* check if update counter needs to be reset */
     if (pReverbData->m_nUpdateCounter >= REVERB_MODULO_UPDATE_PERIOD_IN_SAMPLES)
     {
@@ -305,8 +476,305 @@ static void ReverbProcess(EAS_VOID_PTR pInstData, EAS_PCM *pSrc, EAS_PCM *pDst,
 
     /* increment update counter */
     pReverbData->m_nUpdateCounter += (EAS_I16)numSamples;
+}
 
-}   /* end ComputeReverb */
+/*----------------------------------------------------------------------------
+ * ReverbInputSilent
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns EAS_TRUE if the input buffer is digital silence
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_BOOL ReverbInputSilent(const EAS_PCM *pSrc, EAS_I32 numSamples)
+{
+    EAS_I32 i;
+    EAS_I32 nOr;
+
+    nOr = 0;
+    for (i = 0; i < numSamples * NUM_OUTPUT_CHANNELS; i++)
+        nOr |= pSrc[i];
+    return (EAS_BOOL) (nOr == 0);
+}
+
+/*----------------------------------------------------------------------------
+ * ReverbCheckIdle
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Puts the reverb into the idle state once the input has been silent and
+ * the tail below REVERB_IDLE_LEVEL for REVERB_IDLE_SAMPLES. The wet signal
+ * is faded out first, then the delay line and filter state are cleared, so
+ * when input returns the reverb starts from silence exactly as a new
+ * instance would. If input returns during the fade, the wet signal is
+ * faded back in.
+ *
+ * Inputs:
+ * bSilent          - EAS_TRUE if the input to this call was silent
+ * numSamples       - number of samples processed by this call
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ * - m_bIdle may be set
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ReverbCheckIdle(S_REVERB_OBJECT *pReverbData, EAS_BOOL bSilent, EAS_I32 numSamples)
+{
+    if (!bSilent || (pReverbData->m_nTailLevel > REVERB_IDLE_LEVEL))
+    {
+        pReverbData->m_nIdleCount = 0;
+        if (pReverbData->m_nIdleStep < 0)
+            pReverbData->m_nIdleStep = 1;
+        return;
+    }
+
+    pReverbData->m_nIdleCount += numSamples;
+    if (pReverbData->m_nIdleCount < REVERB_IDLE_SAMPLES)
+        return;
+
+    // fade out the remains of the tail before clearing them
+    if (pReverbData->m_nIdleGain > 0)
+    {
+        pReverbData->m_nIdleStep = -1;
+        return;
+    }
+
+    ReverbClear(pReverbData);
+
+    pReverbData->m_nIdleCount = 0;
+    pReverbData->m_nIdleGain = REVERB_IDLE_FADE_SAMPLES;
+    pReverbData->m_nIdleStep = 0;
+    pReverbData->m_bIdle = EAS_TRUE;
+}
+
+/*----------------------------------------------------------------------------
+ * ReverbClear
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Clears the delay line and the filter and feedback state
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ReverbClear(S_REVERB_OBJECT *pReverbData)
+{
+    EAS_I32 i;
+
+    for (i = 0; i <= pReverbData->m_nBufferMask; i++)
+        pReverbData->m_nDelayLine[i] = 0;
+    pReverbData->m_zLpf0 = 0;
+    pReverbData->m_zLpf1 = 0;
+    pReverbData->m_nRevOutFbkL = 0;
+    pReverbData->m_nRevOutFbkR = 0;
+    pReverbData->m_sEarlyL.m_zLpf = 0;
+    pReverbData->m_sEarlyR.m_zLpf = 0;
+    pReverbData->m_nDecimL = 0;
+    pReverbData->m_nDecimR = 0;
+    pReverbData->m_nInterpL = 0;
+    pReverbData->m_nInterpR = 0;
+    pReverbData->m_nPendingL = 0;
+    pReverbData->m_nPendingR = 0;
+}
+
+/*----------------------------------------------------------------------------
+ * ReverbSetRate
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Switches the reverb network between the full and half output rate.
+ * At half rate the delay line layout is scaled down so the delay times
+ * are unchanged, and only the lower half of the delay line is used.
+ *
+ * Inputs:
+ * nRateShift       - 0 for full rate, 1 for half rate
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ * - the reverb state is cleared and the room is reloaded for the new rate
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ReverbSetRate(S_REVERB_OBJECT *pReverbData, EAS_I16 nRateShift)
+{
+    pReverbData->m_nRateShift = nRateShift;
+    pReverbData->m_nBufferMask = (EAS_U16) ((REVERB_BUFFER_SIZE_IN_SAMPLES >> nRateShift) - 1);
+
+    pReverbData->m_sAp0.m_zApIn = AP0_IN >> nRateShift;
+    pReverbData->m_sAp1.m_zApIn = AP1_IN >> nRateShift;
+    pReverbData->m_zD0In = DELAY0_IN >> nRateShift;
+    pReverbData->m_zD1In = DELAY1_IN >> nRateShift;
+
+    // the crossfade moves the output taps on from here
+    pReverbData->m_zD0Self = (EAS_U16) ((DELAY0_OUT >> nRateShift) - pReverbData->m_nMaxExcursion);
+    pReverbData->m_zD1Cross = (EAS_U16) ((DELAY1_OUT >> nRateShift) - pReverbData->m_nMaxExcursion);
+    pReverbData->m_zD1Self = (EAS_U16) ((DELAY1_OUT >> nRateShift) - pReverbData->m_nMaxExcursion);
+    pReverbData->m_zD0Cross = (EAS_U16) ((DELAY0_OUT >> nRateShift) - pReverbData->m_nMaxExcursion);
+
+    // the delay line holds samples at the old rate
+    ReverbClear(pReverbData);
+    pReverbData->m_nPending = 0;
+    pReverbData->m_nIdleCount = 0;
+    pReverbData->m_nIdleGain = REVERB_IDLE_FADE_SAMPLES;
+    pReverbData->m_nIdleStep = 0;
+
+    // force the allpass lengths and filters to be reloaded
+    pReverbData->m_nCurrentRoom = pReverbData->m_nNextRoom + 1;
+}
+
+/*----------------------------------------------------------------------------
+ * ReverbRun
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Runs the reverb network over the given samples and adds the wet signal
+ * to the output buffer.
+ *
+ * At half rate the network runs once for each pair of input samples, see
+ * ReverbRunPairs. When numSamples is odd, the last input sample is kept
+ * for the next call, which completes its pair. The output for it only
+ * needs the network output so far, so it is written in this call.
+ *
+ * Inputs:
+ * numSamples       - number of samples at the output rate
+ * pOutputBuffer    - dst buffer, the wet signal is added to it
+ * pInputBuffer     - src buffer, may be the same as pOutputBuffer
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ReverbRun(S_REVERB_OBJECT *pReverbData, EAS_INT numSamples, EAS_PCM *pOutputBuffer, EAS_PCM *pInputBuffer)
+{
+    EAS_PCM nPairIn[2 * NUM_OUTPUT_CHANNELS];
+    EAS_PCM nPairOut[2 * NUM_OUTPUT_CHANNELS];
+    EAS_I32 nLevel;
+    EAS_I32 tempValue;
+
+    if (pReverbData->m_nRateShift == 0)
+    {
+        Reverb(pReverbData, numSamples, pOutputBuffer, pInputBuffer);
+        return;
+    }
+
+    nLevel = 0;
+
+    // complete the pair left over from the last call, its first output sample was written then
+    if (pReverbData->m_nPending && (numSamples > 0))
+    {
+        nPairIn[0] = pReverbData->m_nPendingL;
+        nPairIn[1] = pReverbData->m_nPendingR;
+        nPairIn[2] = pInputBuffer[0];
+        nPairIn[3] = pInputBuffer[1];
+        nPairOut[2] = nPairOut[3] = 0;
+        nLevel |= ReverbRunPairs(pReverbData, 1, nPairOut, nPairIn);
+
+        tempValue = pOutputBuffer[0] + nPairOut[2];
+        pOutputBuffer[0] = (EAS_PCM) SATURATE(tempValue);
+        tempValue = pOutputBuffer[1] + nPairOut[3];
+        pOutputBuffer[1] = (EAS_PCM) SATURATE(tempValue);
+
+        pReverbData->m_nPending = 0;
+        pInputBuffer += NUM_OUTPUT_CHANNELS;
+        pOutputBuffer += NUM_OUTPUT_CHANNELS;
+        numSamples--;
+    }
+
+    nLevel |= ReverbRunPairs(pReverbData, numSamples >> 1, pOutputBuffer, pInputBuffer);
+
+    // keep the last sample of an odd length call for the next call
+    if (numSamples & 1)
+    {
+        pInputBuffer += (numSamples - 1) * NUM_OUTPUT_CHANNELS;
+        pOutputBuffer += (numSamples - 1) * NUM_OUTPUT_CHANNELS;
+        pReverbData->m_nPendingL = pInputBuffer[0];
+        pReverbData->m_nPendingR = pInputBuffer[1];
+        pReverbData->m_nPending = 1;
+
+        tempValue = pOutputBuffer[0] + pReverbData->m_nInterpL;
+        pOutputBuffer[0] = (EAS_PCM) SATURATE(tempValue);
+        tempValue = pOutputBuffer[1] + pReverbData->m_nInterpR;
+        pOutputBuffer[1] = (EAS_PCM) SATURATE(tempValue);
+    }
+
+    pReverbData->m_nTailLevel = nLevel;
+}
+
+/*----------------------------------------------------------------------------
+ * ReverbRunPairs
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Runs the reverb network at half the output rate over pairs of samples
+ * and adds the wet signal to the output buffer.
+ *
+ * The input is decimated with a [1 2 1]/4 lowpass and the network runs
+ * once per pair. Its output is linearly interpolated back to the output
+ * rate, half a network sample late, so the first sample of a pair only
+ * needs the network output of the pair before. The preset's own lowpass
+ * keeps most of the reverb below the half rate Nyquist frequency.
+ *
+ * Inputs:
+ * numPairs         - number of pairs of samples at the output rate
+ * pOutputBuffer    - dst buffer, the wet signal is added to it
+ * pInputBuffer     - src buffer, may be the same as pOutputBuffer
+ *
+ * Outputs:
+ * level of the network output, see REVERB_IDLE_LEVEL
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_I32 ReverbRunPairs(S_REVERB_OBJECT *pReverbData, EAS_INT numPairs, EAS_PCM *pOutputBuffer, const EAS_PCM *pInputBuffer)
+{
+    EAS_PCM nIn[NUM_OUTPUT_CHANNELS * REVERB_BLOCK_SIZE];
+    EAS_PCM nOut[NUM_OUTPUT_CHANNELS * REVERB_BLOCK_SIZE];
+    EAS_I32 nLevel;
+    EAS_I32 tempValue;
+    EAS_INT n;
+    EAS_INT i;
+
+    nLevel = 0;
+    while (numPairs > 0)
+    {
+        n = (numPairs < REVERB_BLOCK_SIZE) ? numPairs : REVERB_BLOCK_SIZE;
+
+        // decimate, the odd input sample is shared with the next output sample
+        for (i = 0; i < n; i++)
+        {
+            /*lint -e{702} use shift for performance */
+            nIn[2*i] = (EAS_PCM) ((pReverbData->m_nDecimL + 2 * pInputBuffer[4*i] + pInputBuffer[4*i+2]) >> 2);
+            /*lint -e{702} use shift for performance */
+            nIn[2*i+1] = (EAS_PCM) ((pReverbData->m_nDecimR + 2 * pInputBuffer[4*i+1] + pInputBuffer[4*i+3]) >> 2);
+            pReverbData->m_nDecimL = pInputBuffer[4*i+2];
+            pReverbData->m_nDecimR = pInputBuffer[4*i+3];
+            nOut[2*i] = 0;
+            nOut[2*i+1] = 0;
+        }
+
+        Reverb(pReverbData, n, nOut, nIn);
+        nLevel |= pReverbData->m_nTailLevel;
+
+        // interpolate back to the output rate and add to the output
+        for (i = 0; i < n; i++)
+        {
+            tempValue = pOutputBuffer[4*i] + pReverbData->m_nInterpL;
+            pOutputBuffer[4*i] = (EAS_PCM) SATURATE(tempValue);
+            tempValue = pOutputBuffer[4*i+1] + pReverbData->m_nInterpR;
+            pOutputBuffer[4*i+1] = (EAS_PCM) SATURATE(tempValue);
+            /*lint -e{702} use shift for performance */
+            tempValue = pOutputBuffer[4*i+2] + ((pReverbData->m_nInterpL + nOut[2*i]) >> 1);
+            pOutputBuffer[4*i+2] = (EAS_PCM) SATURATE(tempValue);
+            /*lint -e{702} use shift for performance */
+            tempValue = pOutputBuffer[4*i+3] + ((pReverbData->m_nInterpR + nOut[2*i+1]) >> 1);
+            pOutputBuffer[4*i+3] = (EAS_PCM) SATURATE(tempValue);
+            pReverbData->m_nInterpL = nOut[2*i];
+            pReverbData->m_nInterpR = nOut[2*i+1];
+        }
+
+        pInputBuffer += 4 * n;
+        pOutputBuffer += 4 * n;
+        numPairs -= n;
+    }
+
+    return nLevel;
+}
 
 /*----------------------------------------------------------------------------
  * ReverbUpdateXfade
@@ -346,17 +814,18 @@ static EAS_RESULT ReverbUpdateXfade(S_REVERB_OBJECT *pReverbData, EAS_INT nNumSa
 
             // reset the phase to match the sin, cos values
             pReverbData->m_nPhase = 32767;
+            pReverbData->m_nXfadeStep = 0;
 
             // modulate the cross taps because their tap coefs are zero
             nOffset = ReverbCalculateNoise( pReverbData->m_nMaxExcursion, &pReverbData->m_nNoise );
 
             pReverbData->m_zD1Cross =
-                DELAY1_OUT - pReverbData->m_nMaxExcursion + nOffset;
+                (DELAY1_OUT >> pReverbData->m_nRateShift) - pReverbData->m_nMaxExcursion + nOffset;
 
             nOffset = ReverbCalculateNoise( pReverbData->m_nMaxExcursion, &pReverbData->m_nNoise );
 
             pReverbData->m_zD0Cross =
-                DELAY0_OUT - pReverbData->m_nMaxExcursion - nOffset;
+                (DELAY0_OUT >> pReverbData->m_nRateShift) - pReverbData->m_nMaxExcursion - nOffset;
         }
         else
         {
@@ -366,17 +835,18 @@ static EAS_RESULT ReverbUpdateXfade(S_REVERB_OBJECT *pReverbData, EAS_INT nNumSa
 
             // reset the phase to match the sin, cos values
             pReverbData->m_nPhase = -32768;
+            pReverbData->m_nXfadeStep = 0;
 
             // modulate the self taps because their tap coefs are zero
             nOffset = ReverbCalculateNoise( pReverbData->m_nMaxExcursion, &pReverbData->m_nNoise );
 
             pReverbData->m_zD0Self  =
-                DELAY0_OUT - pReverbData->m_nMaxExcursion - nOffset;
+                (DELAY0_OUT >> pReverbData->m_nRateShift) - pReverbData->m_nMaxExcursion - nOffset;
 
             nOffset = ReverbCalculateNoise( pReverbData->m_nMaxExcursion, &pReverbData->m_nNoise );
 
             pReverbData->m_zD1Self  =
-                DELAY1_OUT - pReverbData->m_nMaxExcursion + nOffset;
+                (DELAY1_OUT >> pReverbData->m_nRateShift) - pReverbData->m_nMaxExcursion + nOffset;
 
         }   // end if-else (pReverbData->m_nPhaseIncrement > 0)
 
@@ -389,18 +859,28 @@ static EAS_RESULT ReverbUpdateXfade(S_REVERB_OBJECT *pReverbData, EAS_INT nNumSa
 
     //compute what phase will be next time
     pReverbData->m_nPhase += pReverbData->m_nPhaseIncrement;
+    pReverbData->m_nXfadeStep++;
 
-    //calculate what the new sin and cos need to reach by the next update
-    ReverbCalculateSinCos(pReverbData->m_nPhase, &tempSin, &tempCos);
+    //look up what the new sin and cos need to reach by the next update,
+    //only calls shorter than the update period run past the table
+    if (pReverbData->m_nXfadeStep < REVERB_XFADE_STEPS)
+    {
+        tempSin = reverbXfadeSinCos[pReverbData->m_nPhaseIncrement > 0][pReverbData->m_nXfadeStep][0];
+        tempCos = reverbXfadeSinCos[pReverbData->m_nPhaseIncrement > 0][pReverbData->m_nXfadeStep][1];
+    }
+    else
+    {
+        ReverbCalculateSinCos(pReverbData->m_nPhase, &tempSin, &tempCos);
+    }
 
     //calculate the per-sample increment required to get there by the next update
     /*lint -e{702} shift for performance */
     pReverbData->m_nSinIncrement =
-            (tempSin - pReverbData->m_nSin) >> REVERB_UPDATE_PERIOD_IN_BITS;
+            (tempSin - pReverbData->m_nSin) >> (REVERB_UPDATE_PERIOD_IN_BITS - pReverbData->m_nRateShift);
 
     /*lint -e{702} shift for performance */
     pReverbData->m_nCosIncrement =
-            (tempCos - pReverbData->m_nCos) >> REVERB_UPDATE_PERIOD_IN_BITS;
+            (tempCos - pReverbData->m_nCos) >> (REVERB_UPDATE_PERIOD_IN_BITS - pReverbData->m_nRateShift);
 
 
     /* increment update counter */
@@ -504,19 +984,194 @@ static EAS_RESULT ReverbCalculateSinCos(EAS_I16 nPhase, EAS_I16 *pnSin, EAS_I16
     return EAS_SUCCESS;
 }   /* end ReverbCalculateSinCos */
 
+/*----------------------------------------------------------------------------
+ * ReverbTapSpan
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Limits a span so the tap at the given offset does not wrap around the
+ * start of the delay line. The base index decrements every sample, so a
+ * tap at address a can be read as a[-i] for i = 0..a.
+ *
+ * Inputs:
+ * nBase            - base index for this span
+ * nOffset          - tap offset
+ * nMask            - delay line mask
+ * n                - span length so far
+ *
+ * Outputs:
+ * new span length
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_INT ReverbTapSpan(EAS_U16 nBase, EAS_U16 nOffset, EAS_U16 nMask, EAS_INT n)
+{
+    EAS_INT nSpan;
+
+    nSpan = (EAS_INT) CIRCULAR(nBase, nOffset, nMask) + 1;
+    return (nSpan < n) ? nSpan : n;
+}
+
+/*----------------------------------------------------------------------------
+ * ReverbEarlyActive
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns EAS_TRUE if the early reflections can contribute to the output
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_BOOL ReverbEarlyActive(const S_EARLY_REFLECTION_OBJECT *pEarly)
+{
+    EAS_INT j;
+
+    if (pEarly->m_zLpf != 0)
+        return EAS_TRUE;
+    for (j = 0; j < REVERB_MAX_NUM_REFLECTIONS; j++)
+        if (pEarly->m_nGain[j] != 0)
+            return EAS_TRUE;
+    return EAS_FALSE;
+}
+
+/*----------------------------------------------------------------------------
+ * ReverbSpan
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Returns the number of samples that can be processed before any tap
+ * wraps around the delay line, up to REVERB_BLOCK_SIZE.
+ *
+ * The early reflections are computed after the rest of the span, so
+ * when they are active the span is also kept short enough that they
+ * never read a sample written later in the same span.
+ *
+ * Inputs:
+ * pReverbData      - reverb state
+ * nBase            - base index for this span
+ * n                - number of samples left to process
+ * bEarly           - EAS_TRUE if the early reflections are active
+ *
+ * Outputs:
+ * span length
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_INT ReverbSpan(const S_REVERB_OBJECT *pReverbData, EAS_U16 nBase, EAS_INT n, EAS_BOOL bEarly)
+{
+    const S_EARLY_REFLECTION_OBJECT *pEarly;
+    EAS_I32 nWrites[4];
+    EAS_I32 nDist;
+    EAS_INT i, j, k;
+    EAS_U16 nMask;
+
+    nMask = pReverbData->m_nBufferMask;
+    if (n > REVERB_BLOCK_SIZE)
+        n = REVERB_BLOCK_SIZE;
+
+    n = ReverbTapSpan(nBase, pReverbData->m_sAp0.m_zApOut, nMask, n);
+    n = ReverbTapSpan(nBase, pReverbData->m_sAp0.m_zApIn, nMask, n);
+    n = ReverbTapSpan(nBase, pReverbData->m_zD0In, nMask, n);
+    n = ReverbTapSpan(nBase, pReverbData->m_sAp1.m_zApOut, nMask, n);
+    n = ReverbTapSpan(nBase, pReverbData->m_sAp1.m_zApIn, nMask, n);
+    n = ReverbTapSpan(nBase, pReverbData->m_zD1In, nMask, n);
+    n = ReverbTapSpan(nBase, pReverbData->m_zD0Self, nMask, n);
+    n = ReverbTapSpan(nBase, pReverbData->m_zD1Cross, nMask, n);
+    n = ReverbTapSpan(nBase, pReverbData->m_zD1Self, nMask, n);
+    n = ReverbTapSpan(nBase, pReverbData->m_zD0Cross, nMask, n);
+
+    if (!bEarly)
+        return n;
+
+    nWrites[0] = pReverbData->m_sAp0.m_zApIn;
+    nWrites[1] = pReverbData->m_zD0In;
+    nWrites[2] = pReverbData->m_sAp1.m_zApIn;
+    nWrites[3] = pReverbData->m_zD1In;
+    for (i = 0; i < 2; i++)
+    {
+        pEarly = i ? &pReverbData->m_sEarlyR : &pReverbData->m_sEarlyL;
+        for (j = 0; j < REVERB_MAX_NUM_REFLECTIONS; j++)
+        {
+            n = ReverbTapSpan(nBase, pEarly->m_zDelay[j], nMask, n);
+
+            /* a write at offset w reaches this tap (w - offset) samples later */
+            for (k = 0; k < 4; k++)
+            {
+                nDist = (nWrites[k] - pEarly->m_zDelay[j]) & nMask;
+                if ((nDist > 0) && (nDist < n))
+                    n = (EAS_INT) nDist;
+            }
+        }
+    }
+    return n;
+}
+
+/*----------------------------------------------------------------------------
+ * ReverbEarly
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Calculates the filtered early reflections for one channel over a span
+ *
+ * Inputs:
+ * pEarly           - early reflection state for the channel
+ * pDelayLine       - reverb delay line
+ * nBase            - base index at the start of the span
+ * nMask            - delay line mask
+ * n                - span length
+ * pEarlyOut        - receives the filtered reflections
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ * - the early reflection filter state is updated
+ *
+ *----------------------------------------------------------------------------
+*/
+static void ReverbEarly(S_EARLY_REFLECTION_OBJECT *pEarly, const EAS_PCM *pDelayLine, EAS_U16 nBase, EAS_U16 nMask, EAS_INT n, EAS_I32 *pEarlyOut)
+{
+    const EAS_PCM *pTap;
+    EAS_I32 nTemp1;
+    EAS_I32 nTemp2;
+    EAS_INT i, j;
+
+    for (i = 0; i < n; i++)
+        pEarlyOut[i] = 0;
+
+    // sum the reflections one tap at a time, in the same order as per sample
+    for (j = 0; j < REVERB_MAX_NUM_REFLECTIONS; j++)
+    {
+        pTap = &pDelayLine[CIRCULAR(nBase, pEarly->m_zDelay[j], nMask)];
+        for (i = 0; i < n; i++)
+        {
+            nTemp1 = pEarlyOut[i] + MULT_EG1_EG1(pTap[-i], pEarly->m_nGain[j]);
+            pEarlyOut[i] = SATURATE(nTemp1);
+        }
+    }
+
+    // apply lowpass to early reflections
+    for (i = 0; i < n; i++)
+    {
+        nTemp1 = MULT_EG1_EG1(pEarlyOut[i], pEarly->m_nLpfFwd);
+        nTemp2 = MULT_EG1_EG1(pEarly->m_zLpf, pEarly->m_nLpfFbk);
+        pEarly->m_zLpf = (EAS_PCM) SATURATE(nTemp1 + nTemp2);
+        pEarlyOut[i] = pEarly->m_zLpf;
+    }
+}   /* end ReverbEarly */
+
 /*----------------------------------------------------------------------------
  * Reverb
  *----------------------------------------------------------------------------
  * Purpose:
  * apply reverb to the given signal
  *
+ * The buffer is processed in spans during which no delay line tap wraps,
+ * so the taps are plain pointers. Within a span, the allpass, delay and
+ * lowpass feedback network runs one sample at a time. The early
+ * reflections and the wet mix into the output run afterwards as separate
+ * loops over the span.
+ *
  * Inputs:
- * nNu
- * pnSin    - input old value, output new value
- * pnCos    - input old value, output new value
+ * nNumSamplesToAdd - number of stereo samples to process
+ * pOutputBuffer    - wet signal is added to this buffer
+ * pInputBuffer     - interleaved stereo input
  *
  * Outputs:
- * number of samples actually reverberated
  *
  * Side Effects:
  *
@@ -524,250 +1179,214 @@ static EAS_RESULT ReverbCalculateSinCos(EAS_I16 nPhase, EAS_I16 *pnSin, EAS_I16
 */
 static EAS_RESULT Reverb(S_REVERB_OBJECT *pReverbData, EAS_INT nNumSamplesToAdd, EAS_PCM *pOutputBuffer, EAS_PCM *pInputBuffer)
 {
+    EAS_I32 nOutL[REVERB_BLOCK_SIZE];
+    EAS_I32 nOutR[REVERB_BLOCK_SIZE];
+    EAS_I32 nEarlyL[REVERB_BLOCK_SIZE];
+    EAS_I32 nEarlyR[REVERB_BLOCK_SIZE];
+    EAS_PCM *pDelayLine;
+    EAS_PCM *pAp0Out, *pAp0In, *pD0In;
+    EAS_PCM *pAp1Out, *pAp1In, *pD1In;
+    EAS_PCM *pD0Self, *pD1Cross, *pD1Self, *pD0Cross;
     EAS_I32 i;
+    EAS_I32 n;
     EAS_I32 nDelayOut;
     EAS_U16 nBase;
+    EAS_U16 nMask;
+    EAS_BOOL bEarly;
 
-    EAS_U32 nAddr;
     EAS_I32 nTemp1;
     EAS_I32 nTemp2;
     EAS_I32 nApIn;
     EAS_I32 nApOut;
-
-    EAS_I32 j;
-    EAS_I32 nEarlyOut;
+    EAS_I32 nWet;
+    EAS_I32 nFullWet;
+    EAS_I32 nLevel;
 
     EAS_I32 tempValue;
 
 
     // get the base address
     nBase = pReverbData->m_nBaseIndex;
+    nMask = pReverbData->m_nBufferMask;
+    pDelayLine = pReverbData->m_nDelayLine;
 
-    for (i=0; i < nNumSamplesToAdd; i++)
-    {
-        // ********** Left Allpass - start
-        // left input = (left dry/4) + right feedback from previous period
-        /*lint -e{702} use shift for performance */
-        nApIn = ((*pInputBuffer++)>>2) + pReverbData->m_nRevOutFbkR;
-//      nApIn = *pInputBuffer++;    // 1xxx test and debug ap
-
-        // fetch allpass delay line out
-        //nAddr = CIRCULAR(nBase, psAp0->m_zApOut, REVERB_BUFFER_MASK);
-        nAddr = CIRCULAR(nBase, pReverbData->m_sAp0.m_zApOut, REVERB_BUFFER_MASK);
-        nDelayOut = pReverbData->m_nDelayLine[nAddr];
-
-        // calculate allpass feedforward; subtract the feedforward result
-        nTemp1 = MULT_EG1_EG1(nApIn, pReverbData->m_sAp0.m_nApGain);
-        nApOut = SATURATE(nDelayOut - nTemp1);          // allpass output
-
-        // calculate allpass feedback; add the feedback result
-        nTemp1 = MULT_EG1_EG1(nApOut, pReverbData->m_sAp0.m_nApGain);
-        nTemp1 = SATURATE(nApIn + nTemp1);
-
-        // inject into allpass delay
-        nAddr = CIRCULAR(nBase, pReverbData->m_sAp0.m_zApIn, REVERB_BUFFER_MASK);
-        pReverbData->m_nDelayLine[nAddr] = (EAS_PCM) nTemp1;
-
-        // inject allpass output into delay line
-        nAddr = CIRCULAR(nBase, pReverbData->m_zD0In, REVERB_BUFFER_MASK);
-        pReverbData->m_nDelayLine[nAddr] = (EAS_PCM) nApOut;
-
-        // ********** Left Allpass - end
-
-        // ********** Right Allpass - start
-        // right input = (right dry/4) + left feedback from previous period
-        /*lint -e{702} use shift for performance */
-        nApIn = ((*pInputBuffer++)>>2) + pReverbData->m_nRevOutFbkL;
-//      nApIn = *pInputBuffer++;    // 1xxx test and debug ap
-
-        // fetch allpass delay line out
-        nAddr = CIRCULAR(nBase, pReverbData->m_sAp1.m_zApOut, REVERB_BUFFER_MASK);
-        nDelayOut = pReverbData->m_nDelayLine[nAddr];
-
-        // calculate allpass feedforward; subtract the feedforward result
-        nTemp1 = MULT_EG1_EG1(nApIn, pReverbData->m_sAp1.m_nApGain);
-        nApOut = SATURATE(nDelayOut - nTemp1);          // allpass output
-
-        // calculate allpass feedback; add the feedback result
-        nTemp1 = MULT_EG1_EG1(nApOut, pReverbData->m_sAp1.m_nApGain);
-        nTemp1 = SATURATE(nApIn + nTemp1);
+    bEarly = ReverbEarlyActive(&pReverbData->m_sEarlyL) || ReverbEarlyActive(&pReverbData->m_sEarlyR);
 
-        // inject into allpass delay
-        nAddr = CIRCULAR(nBase, pReverbData->m_sAp1.m_zApIn, REVERB_BUFFER_MASK);
-        pReverbData->m_nDelayLine[nAddr] = (EAS_PCM) nTemp1;
+    /*lint -e{701} use shift for performance */
+    nFullWet = pReverbData->m_nWet << 1;
+    /*lint -e{704} use shift for performance */
+    nWet = (nFullWet * pReverbData->m_nIdleGain) >> REVERB_IDLE_FADE_BITS;
+    nLevel = 0;
 
-        // inject allpass output into delay line
-        nAddr = CIRCULAR(nBase, pReverbData->m_zD1In, REVERB_BUFFER_MASK);
-        pReverbData->m_nDelayLine[nAddr] = (EAS_PCM) nApOut;
-
-        // ********** Right Allpass - end
-
-        // ********** D0 output - start
-        // fetch delay line self out
-        nAddr = CIRCULAR(nBase, pReverbData->m_zD0Self, REVERB_BUFFER_MASK);
-        nDelayOut = pReverbData->m_nDelayLine[nAddr];
-
-        // calculate delay line self out
-        nTemp1 = MULT_EG1_EG1(nDelayOut, pReverbData->m_nSin);
-
-        // fetch delay line cross out
-        nAddr = CIRCULAR(nBase, pReverbData->m_zD1Cross, REVERB_BUFFER_MASK);
-        nDelayOut = pReverbData->m_nDelayLine[nAddr];
-
-        // calculate delay line self out
-        nTemp2 = MULT_EG1_EG1(nDelayOut, pReverbData->m_nCos);
-
-        // calculate unfiltered delay out
-        nDelayOut = SATURATE(nTemp1 + nTemp2);
+    while (nNumSamplesToAdd > 0)
+    {
+        n = ReverbSpan(pReverbData, nBase, nNumSamplesToAdd, bEarly);
+
+        pAp0Out = &pDelayLine[CIRCULAR(nBase, pReverbData->m_sAp0.m_zApOut, nMask)];
+        pAp0In = &pDelayLine[CIRCULAR(nBase, pReverbData->m_sAp0.m_zApIn, nMask)];
+        pD0In = &pDelayLine[CIRCULAR(nBase, pReverbData->m_zD0In, nMask)];
+        pAp1Out = &pDelayLine[CIRCULAR(nBase, pReverbData->m_sAp1.m_zApOut, nMask)];
+        pAp1In = &pDelayLine[CIRCULAR(nBase, pReverbData->m_sAp1.m_zApIn, nMask)];
+        pD1In = &pDelayLine[CIRCULAR(nBase, pReverbData->m_zD1In, nMask)];
+        pD0Self = &pDelayLine[CIRCULAR(nBase, pReverbData->m_zD0Self, nMask)];
+        pD1Cross = &pDelayLine[CIRCULAR(nBase, pReverbData->m_zD1Cross, nMask)];
+        pD1Self = &pDelayLine[CIRCULAR(nBase, pReverbData->m_zD1Self, nMask)];
+        pD0Cross = &pDelayLine[CIRCULAR(nBase, pReverbData->m_zD0Cross, nMask)];
+
+        for (i = 0; i < n; i++)
+        {
+            // ********** Left Allpass - start
+            // left input = (left dry/4) + right feedback from previous period
+            /*lint -e{702} use shift for performance */
+            nApIn = (pInputBuffer[2*i] >> 2) + pReverbData->m_nRevOutFbkR;
 
-        // calculate lowpass filter (mixer scale factor included in LPF feedforward)
-        nTemp1 = MULT_EG1_EG1(nDelayOut, pReverbData->m_nLpfFwd);
+            // calculate allpass feedforward; subtract the feedforward result
+            nDelayOut = pAp0Out[-i];
+            nTemp1 = MULT_EG1_EG1(nApIn, pReverbData->m_sAp0.m_nApGain);
+            nApOut = SATURATE(nDelayOut - nTemp1);          // allpass output
 
-        nTemp2 = MULT_EG1_EG1(pReverbData->m_zLpf0, pReverbData->m_nLpfFbk);
+            // calculate allpass feedback; add the feedback result
+            nTemp1 = MULT_EG1_EG1(nApOut, pReverbData->m_sAp0.m_nApGain);
+            nTemp1 = SATURATE(nApIn + nTemp1);
 
-        // calculate filtered delay out and simultaneously update LPF state variable
-        // filtered delay output is stored in m_zLpf0
-        pReverbData->m_zLpf0 = (EAS_PCM) SATURATE(nTemp1 + nTemp2);
+            // inject into allpass delay, and allpass output into delay line
+            pAp0In[-i] = (EAS_PCM) nTemp1;
+            pD0In[-i] = (EAS_PCM) nApOut;
 
-        // ********** D0 output - end
+            // ********** Left Allpass - end
 
-        // ********** D1 output - start
-        // fetch delay line self out
-        nAddr = CIRCULAR(nBase, pReverbData->m_zD1Self, REVERB_BUFFER_MASK);
-        nDelayOut = pReverbData->m_nDelayLine[nAddr];
+            // ********** Right Allpass - start
+            // right input = (right dry/4) + left feedback from previous period
+            /*lint -e{702} use shift for performance */
+            nApIn = (pInputBuffer[2*i+1] >> 2) + pReverbData->m_nRevOutFbkL;
 
-        // calculate delay line self out
-        nTemp1 = MULT_EG1_EG1(nDelayOut, pReverbData->m_nSin);
+            // calculate allpass feedforward; subtract the feedforward result
+            nDelayOut = pAp1Out[-i];
+            nTemp1 = MULT_EG1_EG1(nApIn, pReverbData->m_sAp1.m_nApGain);
+            nApOut = SATURATE(nDelayOut - nTemp1);          // allpass output
 
-        // fetch delay line cross out
-        nAddr = CIRCULAR(nBase, pReverbData->m_zD0Cross, REVERB_BUFFER_MASK);
-        nDelayOut = pReverbData->m_nDelayLine[nAddr];
+            // calculate allpass feedback; add the feedback result
+            nTemp1 = MULT_EG1_EG1(nApOut, pReverbData->m_sAp1.m_nApGain);
+            nTemp1 = SATURATE(nApIn + nTemp1);
 
-        // calculate delay line self out
-        nTemp2 = MULT_EG1_EG1(nDelayOut, pReverbData->m_nCos);
+            // inject into allpass delay, and allpass output into delay line
+            pAp1In[-i] = (EAS_PCM) nTemp1;
+            pD1In[-i] = (EAS_PCM) nApOut;
 
-        // calculate unfiltered delay out
-        nDelayOut = SATURATE(nTemp1 + nTemp2);
+            // ********** Right Allpass - end
 
-        // calculate lowpass filter (mixer scale factor included in LPF feedforward)
-        nTemp1 = MULT_EG1_EG1(nDelayOut, pReverbData->m_nLpfFwd);
+            // ********** D0 output - start
+            // calculate delay line self and cross out
+            nTemp1 = MULT_EG1_EG1(pD0Self[-i], pReverbData->m_nSin);
+            nTemp2 = MULT_EG1_EG1(pD1Cross[-i], pReverbData->m_nCos);
 
-        nTemp2 = MULT_EG1_EG1(pReverbData->m_zLpf1, pReverbData->m_nLpfFbk);
+            // calculate unfiltered delay out
+            nDelayOut = SATURATE(nTemp1 + nTemp2);
 
-        // calculate filtered delay out and simultaneously update LPF state variable
-        // filtered delay output is stored in m_zLpf1
-        pReverbData->m_zLpf1 = (EAS_PCM)SATURATE(nTemp1 + nTemp2);
+            // calculate lowpass filter (mixer scale factor included in LPF feedforward)
+            nTemp1 = MULT_EG1_EG1(nDelayOut, pReverbData->m_nLpfFwd);
 
-        // ********** D1 output - end
+            nTemp2 = MULT_EG1_EG1(pReverbData->m_zLpf0, pReverbData->m_nLpfFbk);
 
-        // ********** mixer and feedback - start
-        // sum is fedback to right input (R + L)
-        pReverbData->m_nRevOutFbkL =
-            (EAS_PCM)SATURATE((EAS_I32)pReverbData->m_zLpf1 + (EAS_I32)pReverbData->m_zLpf0);
+            // calculate filtered delay out and simultaneously update LPF state variable
+            // filtered delay output is stored in m_zLpf0
+            pReverbData->m_zLpf0 = (EAS_PCM) SATURATE(nTemp1 + nTemp2);
 
-        // difference is feedback to left input (R - L)
-        /*lint -e{685} lint complains that it can't saturate negative */
-        pReverbData->m_nRevOutFbkR =
-            (EAS_PCM)SATURATE((EAS_I32)pReverbData->m_zLpf1 - (EAS_I32)pReverbData->m_zLpf0);
+            // ********** D0 output - end
 
-        // ********** mixer and feedback - end
+            // ********** D1 output - start
+            // calculate delay line self and cross out
+            nTemp1 = MULT_EG1_EG1(pD1Self[-i], pReverbData->m_nSin);
+            nTemp2 = MULT_EG1_EG1(pD0Cross[-i], pReverbData->m_nCos);
 
-        // ********** start early reflection generator, left
-        //psEarly = &(pReverbData->m_sEarlyL);
+            // calculate unfiltered delay out
+            nDelayOut = SATURATE(nTemp1 + nTemp2);
 
-        nEarlyOut = 0;
+            // calculate lowpass filter (mixer scale factor included in LPF feedforward)
+            nTemp1 = MULT_EG1_EG1(nDelayOut, pReverbData->m_nLpfFwd);
 
-        for (j=0; j < REVERB_MAX_NUM_REFLECTIONS; j++)
-        {
-            // fetch delay line out
-            //nAddr = CIRCULAR(nBase, psEarly->m_zDelay[j], REVERB_BUFFER_MASK);
-            nAddr = CIRCULAR(nBase, pReverbData->m_sEarlyL.m_zDelay[j], REVERB_BUFFER_MASK);
+            nTemp2 = MULT_EG1_EG1(pReverbData->m_zLpf1, pReverbData->m_nLpfFbk);
 
-            nDelayOut = pReverbData->m_nDelayLine[nAddr];
+            // calculate filtered delay out and simultaneously update LPF state variable
+            // filtered delay output is stored in m_zLpf1
+            pReverbData->m_zLpf1 = (EAS_PCM)SATURATE(nTemp1 + nTemp2);
 
-            // calculate reflection
-            //nTemp1 = MULT_EG1_EG1(nDelayOut, psEarly->m_nGain[j]);
-            nTemp1 = MULT_EG1_EG1(nDelayOut, pReverbData->m_sEarlyL.m_nGain[j]);
+            // ********** D1 output - end
 
-            nEarlyOut = SATURATE(nEarlyOut + nTemp1);
+            // ********** mixer and feedback - start
+            // sum is fedback to right input (R + L)
+            pReverbData->m_nRevOutFbkL =
+                (EAS_PCM)SATURATE((EAS_I32)pReverbData->m_zLpf1 + (EAS_I32)pReverbData->m_zLpf0);
 
-        }   // end for (j=0; j < REVERB_MAX_NUM_REFLECTIONS; j++)
+            // difference is feedback to left input (R - L)
+            /*lint -e{685} lint complains that it can't saturate negative */
+            pReverbData->m_nRevOutFbkR =
+                (EAS_PCM)SATURATE((EAS_I32)pReverbData->m_zLpf1 - (EAS_I32)pReverbData->m_zLpf0);
 
-        // apply lowpass to early reflections
-        //nTemp1 = MULT_EG1_EG1(nEarlyOut, psEarly->m_nLpfFwd);
-        nTemp1 = MULT_EG1_EG1(nEarlyOut, pReverbData->m_sEarlyL.m_nLpfFwd);
+            nOutL[i] = pReverbData->m_nRevOutFbkL;
+            nOutR[i] = pReverbData->m_nRevOutFbkR;
 
-        //nTemp2 = MULT_EG1_EG1(psEarly->m_zLpf, psEarly->m_nLpfFbk);
-        nTemp2 = MULT_EG1_EG1(pReverbData->m_sEarlyL.m_zLpf, pReverbData->m_sEarlyL.m_nLpfFbk);
+            // ********** mixer and feedback - end
 
+            pReverbData->m_nSin += pReverbData->m_nSinIncrement;
+            pReverbData->m_nCos += pReverbData->m_nCosIncrement;
 
-        // calculate filtered out and simultaneously update LPF state variable
-        // filtered output is stored in m_zLpf1
-        //psEarly->m_zLpf = SATURATE(nTemp1 + nTemp2);
-        pReverbData->m_sEarlyL.m_zLpf = (EAS_PCM) SATURATE(nTemp1 + nTemp2);
+        }   // end for (i=0; i < n; i++)
 
         // combine filtered early and late reflections for output
-        //*pOutputBuffer++ = inL;
-        //tempValue = SATURATE(psEarly->m_zLpf + pReverbData->m_nRevOutFbkL);
-        tempValue = SATURATE((EAS_I32)pReverbData->m_sEarlyL.m_zLpf + (EAS_I32)pReverbData->m_nRevOutFbkL);
-        //scale reverb output by wet level
-        /*lint -e{701} use shift for performance */
-        tempValue = MULT_EG1_EG1(tempValue, (pReverbData->m_nWet<<1));
-        //sum with output buffer
-        tempValue += *pOutputBuffer;
-        *pOutputBuffer++ = (EAS_PCM)SATURATE(tempValue);
-
-        // ********** end early reflection generator, left
-
-        // ********** start early reflection generator, right
-        //psEarly = &(pReverbData->m_sEarlyR);
-
-        nEarlyOut = 0;
-
-        for (j=0; j < REVERB_MAX_NUM_REFLECTIONS; j++)
+        if (bEarly)
         {
-            // fetch delay line out
-            nAddr = CIRCULAR(nBase, pReverbData->m_sEarlyR.m_zDelay[j], REVERB_BUFFER_MASK);
-            nDelayOut = pReverbData->m_nDelayLine[nAddr];
-
-            // calculate reflection
-            nTemp1 = MULT_EG1_EG1(nDelayOut, pReverbData->m_sEarlyR.m_nGain[j]);
-
-            nEarlyOut = SATURATE(nEarlyOut + nTemp1);
-
-        }   // end for (j=0; j < REVERB_MAX_NUM_REFLECTIONS; j++)
-
-        // apply lowpass to early reflections
-        nTemp1 = MULT_EG1_EG1(nEarlyOut, pReverbData->m_sEarlyR.m_nLpfFwd);
-
-        nTemp2 = MULT_EG1_EG1(pReverbData->m_sEarlyR.m_zLpf, pReverbData->m_sEarlyR.m_nLpfFbk);
-
-        // calculate filtered out and simultaneously update LPF state variable
-        // filtered output is stored in m_zLpf1
-        pReverbData->m_sEarlyR.m_zLpf = (EAS_PCM)SATURATE(nTemp1 + nTemp2);
-
-        // combine filtered early and late reflections for output
-        //*pOutputBuffer++ = inR;
-        tempValue = SATURATE((EAS_I32)pReverbData->m_sEarlyR.m_zLpf + (EAS_I32)pReverbData->m_nRevOutFbkR);
-        //scale reverb output by wet level
-        /*lint -e{701} use shift for performance */
-        tempValue = MULT_EG1_EG1(tempValue, (pReverbData->m_nWet << 1));
-        //sum with output buffer
-        tempValue = tempValue + *pOutputBuffer;
-        *pOutputBuffer++ = (EAS_PCM)SATURATE(tempValue);
-
-        // ********** end early reflection generator, right
-
-        // decrement base addr for next sample period
-        nBase--;
+            ReverbEarly(&pReverbData->m_sEarlyL, pDelayLine, nBase, nMask, n, nEarlyL);
+            ReverbEarly(&pReverbData->m_sEarlyR, pDelayLine, nBase, nMask, n, nEarlyR);
+            for (i = 0; i < n; i++)
+            {
+                tempValue = nEarlyL[i] + nOutL[i];
+                nOutL[i] = SATURATE(tempValue);
+                tempValue = nEarlyR[i] + nOutR[i];
+                nOutR[i] = SATURATE(tempValue);
+            }
+        }
 
-        pReverbData->m_nSin += pReverbData->m_nSinIncrement;
-        pReverbData->m_nCos += pReverbData->m_nCosIncrement;
+        // scale reverb output by wet level and sum with output buffer
+        for (i = 0; i < n; i++)
+        {
+            // fading out before going idle, or back in if the input returned during the fade
+            if (pReverbData->m_nIdleStep != 0)
+            {
+                pReverbData->m_nIdleGain += pReverbData->m_nIdleStep;
+                if (pReverbData->m_nIdleGain <= 0)
+                {
+                    pReverbData->m_nIdleGain = 0;
+                }
+                else if (pReverbData->m_nIdleGain >= REVERB_IDLE_FADE_SAMPLES)
+                {
+                    pReverbData->m_nIdleGain = REVERB_IDLE_FADE_SAMPLES;
+                    pReverbData->m_nIdleStep = 0;
+                }
+                /*lint -e{704} use shift for performance */
+                nWet = (nFullWet * pReverbData->m_nIdleGain) >> REVERB_IDLE_FADE_BITS;
+            }
+
+            tempValue = MULT_EG1_EG1(nOutL[i], nWet) + pOutputBuffer[2*i];
+            pOutputBuffer[2*i] = (EAS_PCM)SATURATE(tempValue);
+            tempValue = MULT_EG1_EG1(nOutR[i], nWet) + pOutputBuffer[2*i+1];
+            pOutputBuffer[2*i+1] = (EAS_PCM)SATURATE(tempValue);
+
+            // track the output level for the idle detection, x ^ (x >> 31) is |x| - 1 for negative x
+            /*lint -e{702} use shift for performance */
+            nLevel |= (nOutL[i] ^ (nOutL[i] >> 31)) | (nOutR[i] ^ (nOutR[i] >> 31));
+        }
 
-    }   // end for (i=0; i < nNumSamplesToAdd; i++)
+        // advance to the next span
+        pInputBuffer += 2 * n;
+        pOutputBuffer += 2 * n;
+        nBase = (EAS_U16) (nBase - n);
+        nNumSamplesToAdd -= (EAS_INT) n;
+    }
 
     // store the most up to date version
     pReverbData->m_nBaseIndex = nBase;
+    pReverbData->m_nTailLevel = nLevel;
 
     return EAS_SUCCESS;
 }   /* end Reverb */
@@ -836,6 +1455,9 @@ static EAS_RESULT ReverbGetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32
         case EAS_PARAM_REVERB_DRY:
             *pValue = p->m_nDry;
             break;
+        case EAS_PARAM_REVERB_HALF_RATE:
+            *pValue = (EAS_I32) (p->m_nNextRateShift != 0);
+            break;
         default:
             return EAS_ERROR_INVALID_PARAMETER;
     }
@@ -888,6 +1510,15 @@ static EAS_RESULT ReverbSetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32
                 return EAS_ERROR_INVALID_PARAMETER;
             p->m_nDry = (EAS_I16)value;
             break;
+        case EAS_PARAM_REVERB_HALF_RATE:
+#ifdef _REVERB_HALF_RATE
+            // the delay line is too short for the full rate
+            if (!value)
+                return EAS_ERROR_FEATURE_NOT_AVAILABLE;
+#endif
+            // takes effect at the start of the next buffer
+            p->m_nNextRateShift = value ? 1 : 0;
+            break;
         default:
             return EAS_ERROR_INVALID_PARAMETER;
     }
@@ -913,242 +1544,33 @@ static EAS_RESULT ReverbSetParam (EAS_VOID_PTR pInstData, EAS_I32 param, EAS_I32
 */
 static EAS_RESULT ReverbUpdateRoom(S_REVERB_OBJECT *pReverbData)
 {
-    EAS_INT temp;
+    const S_REVERB_PRESET *pPreset = &reverbPresets[pReverbData->m_nNextRoom];
 
-    S_REVERB_PRESET *pPreset = &pReverbData->m_sPreset.m_sPreset[pReverbData->m_nNextRoom];
-
-    pReverbData->m_nLpfFwd = pPreset->m_nLpfFwd;
-    pReverbData->m_nLpfFbk = pPreset->m_nLpfFbk;
+    if (pReverbData->m_nRateShift)
+    {
+        pReverbData->m_nLpfFwd = pPreset->m_nLpfFwdHalf;
+        pReverbData->m_nLpfFbk = pPreset->m_nLpfFbkHalf;
+    }
+    else
+    {
+        pReverbData->m_nLpfFwd = pPreset->m_nLpfFwd;
+        pReverbData->m_nLpfFbk = pPreset->m_nLpfFbk;
+    }
 
     pReverbData->m_nEarly = pPreset->m_nEarly;
     pReverbData->m_nWet = pPreset->m_nWet;
     pReverbData->m_nDry = pPreset->m_nDry;
 
+    pReverbData->m_nMaxExcursion = (EAS_U16) (pPreset->m_nMaxExcursion >> pReverbData->m_nRateShift);
+    pReverbData->m_nXfadeInterval = pPreset->m_nXfadeInterval;
 
-    pReverbData->m_nMaxExcursion = pPreset->m_nMaxExcursion;
-    //stored as time based, convert to sample based
-    temp = pPreset->m_nXfadeInterval;
-    /*lint -e{702} shift for performance */
-    temp = (temp * _OUTPUT_SAMPLE_RATE) >> 16;
-    pReverbData->m_nXfadeInterval = (EAS_U16) temp;
-    //gpsReverbObject->m_nXfadeInterval = pPreset->m_nXfadeInterval;
     pReverbData->m_sAp0.m_nApGain = pPreset->m_nAp0_ApGain;
-    //stored as time based, convert to absolute sample value
-    temp = pPreset->m_nAp0_ApOut;
-    /*lint -e{702} shift for performance */
-    temp = (temp * _OUTPUT_SAMPLE_RATE) >> 16;
-    pReverbData->m_sAp0.m_zApOut = (EAS_U16) (pReverbData->m_sAp0.m_zApIn + temp);
-    //gpsReverbObject->m_sAp0.m_zApOut = pPreset->m_nAp0_ApOut;
+    pReverbData->m_sAp0.m_zApOut = (EAS_U16) (pReverbData->m_sAp0.m_zApIn + (pPreset->m_nAp0_ApOut >> pReverbData->m_nRateShift));
     pReverbData->m_sAp1.m_nApGain = pPreset->m_nAp1_ApGain;
-    //stored as time based, convert to absolute sample value
-    temp = pPreset->m_nAp1_ApOut;
-    /*lint -e{702} shift for performance */
-    temp = (temp * _OUTPUT_SAMPLE_RATE) >> 16;
-    pReverbData->m_sAp1.m_zApOut = (EAS_U16) (pReverbData->m_sAp1.m_zApIn + temp);
-    //gpsReverbObject->m_sAp1.m_zApOut = pPreset->m_nAp1_ApOut;
+    pReverbData->m_sAp1.m_zApOut = (EAS_U16) (pReverbData->m_sAp1.m_zApIn + (pPreset->m_nAp1_ApOut >> pReverbData->m_nRateShift));
 
     pReverbData->m_nCurrentRoom = pReverbData->m_nNextRoom;
 
     return EAS_SUCCESS;
 
 }   /* end ReverbUpdateRoom */
-
-
-/*----------------------------------------------------------------------------
- * ReverbReadInPresets()
- *----------------------------------------------------------------------------
- * Purpose: sets global reverb preset bank to defaults
- *
- * Inputs:
- *
- * Outputs:
- *
- *----------------------------------------------------------------------------
-*/
-static EAS_RESULT ReverbReadInPresets(S_REVERB_OBJECT *pReverbData)
-{
-
-    int preset = 0;
-    int defaultPreset = 0;
-
-    //now init any remaining presets to defaults
-    for (defaultPreset = preset; defaultPreset < REVERB_MAX_ROOM_TYPE; defaultPreset++)
-    {
-        S_REVERB_PRESET *pPreset = &pReverbData->m_sPreset.m_sPreset[defaultPreset];
-        if (defaultPreset == 0 || defaultPreset > REVERB_MAX_ROOM_TYPE-1)
-        {
-            pPreset->m_nLpfFbk = 8307;
-            pPreset->m_nLpfFwd = 14768;
-            pPreset->m_nEarly = 0;
-            pPreset->m_nWet = 27690;
-            pPreset->m_nDry = 32767;
-            pPreset->m_nEarlyL_LpfFbk = 3692;
-            pPreset->m_nEarlyL_LpfFwd = 29075;
-            pPreset->m_nEarlyL_Delay0 = 922;
-            pPreset->m_nEarlyL_Gain0 = 22152;
-            pPreset->m_nEarlyL_Delay1 = 1462;
-            pPreset->m_nEarlyL_Gain1 = 17537;
-            pPreset->m_nEarlyL_Delay2 = 0;
-            pPreset->m_nEarlyL_Gain2 = 14768;
-            pPreset->m_nEarlyL_Delay3 = 1221;
-            pPreset->m_nEarlyL_Gain3 = 14307;
-            pPreset->m_nEarlyL_Delay4 = 0;
-            pPreset->m_nEarlyL_Gain4 = 13384;
-            pPreset->m_nEarlyR_Delay0 = 502;
-            pPreset->m_nEarlyR_Gain0 = 20306;
-            pPreset->m_nEarlyR_Delay1 = 1762;
-            pPreset->m_nEarlyR_Gain1 = 17537;
-            pPreset->m_nEarlyR_Delay2 = 0;
-            pPreset->m_nEarlyR_Gain2 = 14768;
-            pPreset->m_nEarlyR_Delay3 = 0;
-            pPreset->m_nEarlyR_Gain3 = 16153;
-            pPreset->m_nEarlyR_Delay4 = 0;
-            pPreset->m_nEarlyR_Gain4 = 13384;
-            pPreset->m_nMaxExcursion = 127;
-            pPreset->m_nXfadeInterval = 6388;
-            pPreset->m_nAp0_ApGain = 15691;
-            pPreset->m_nAp0_ApOut = 711;
-            pPreset->m_nAp1_ApGain = 17999;
-            pPreset->m_nAp1_ApOut = 1113;
-            pPreset->m_rfu4 = 0;
-            pPreset->m_rfu5 = 0;
-            pPreset->m_rfu6 = 0;
-            pPreset->m_rfu7 = 0;
-            pPreset->m_rfu8 = 0;
-            pPreset->m_rfu9 = 0;
-            pPreset->m_rfu10 = 0;
-        }
-        else if (defaultPreset == 1)
-        {
-            pPreset->m_nLpfFbk = 6461;
-            pPreset->m_nLpfFwd = 14307;
-            pPreset->m_nEarly = 0;
-            pPreset->m_nWet = 27690;
-            pPreset->m_nDry = 32767;
-            pPreset->m_nEarlyL_LpfFbk = 3692;
-            pPreset->m_nEarlyL_LpfFwd = 29075;
-            pPreset->m_nEarlyL_Delay0 = 922;
-            pPreset->m_nEarlyL_Gain0 = 22152;
-            pPreset->m_nEarlyL_Delay1 = 1462;
-            pPreset->m_nEarlyL_Gain1 = 17537;
-            pPreset->m_nEarlyL_Delay2 = 0;
-            pPreset->m_nEarlyL_Gain2 = 14768;
-            pPreset->m_nEarlyL_Delay3 = 1221;
-            pPreset->m_nEarlyL_Gain3 = 14307;
-            pPreset->m_nEarlyL_Delay4 = 0;
-            pPreset->m_nEarlyL_Gain4 = 13384;
-            pPreset->m_nEarlyR_Delay0 = 502;
-            pPreset->m_nEarlyR_Gain0 = 20306;
-            pPreset->m_nEarlyR_Delay1 = 1762;
-            pPreset->m_nEarlyR_Gain1 = 17537;
-            pPreset->m_nEarlyR_Delay2 = 0;
-            pPreset->m_nEarlyR_Gain2 = 14768;
-            pPreset->m_nEarlyR_Delay3 = 0;
-            pPreset->m_nEarlyR_Gain3 = 16153;
-            pPreset->m_nEarlyR_Delay4 = 0;
-            pPreset->m_nEarlyR_Gain4 = 13384;
-            pPreset->m_nMaxExcursion = 127;
-            pPreset->m_nXfadeInterval = 6391;
-            pPreset->m_nAp0_ApGain = 15230;
-            pPreset->m_nAp0_ApOut = 708;
-            pPreset->m_nAp1_ApGain = 9692;
-            pPreset->m_nAp1_ApOut = 1113;
-            pPreset->m_rfu4 = 0;
-            pPreset->m_rfu5 = 0;
-            pPreset->m_rfu6 = 0;
-            pPreset->m_rfu7 = 0;
-            pPreset->m_rfu8 = 0;
-            pPreset->m_rfu9 = 0;
-            pPreset->m_rfu10 = 0;
-        }
-        else if (defaultPreset == 2)
-        {
-            pPreset->m_nLpfFbk = 5077;
-            pPreset->m_nLpfFwd = 12922;
-            pPreset->m_nEarly = 0;
-            pPreset->m_nWet = 24460;
-            pPreset->m_nDry = 32767;
-            pPreset->m_nEarlyL_LpfFbk = 3692;
-            pPreset->m_nEarlyL_LpfFwd = 29075;
-            pPreset->m_nEarlyL_Delay0 = 922;
-            pPreset->m_nEarlyL_Gain0 = 22152;
-            pPreset->m_nEarlyL_Delay1 = 1462;
-            pPreset->m_nEarlyL_Gain1 = 17537;
-            pPreset->m_nEarlyL_Delay2 = 0;
-            pPreset->m_nEarlyL_Gain2 = 14768;
-            pPreset->m_nEarlyL_Delay3 = 1221;
-            pPreset->m_nEarlyL_Gain3 = 14307;
-            pPreset->m_nEarlyL_Delay4 = 0;
-            pPreset->m_nEarlyL_Gain4 = 13384;
-            pPreset->m_nEarlyR_Delay0 = 502;
-            pPreset->m_nEarlyR_Gain0 = 20306;
-            pPreset->m_nEarlyR_Delay1 = 1762;
-            pPreset->m_nEarlyR_Gain1 = 17537;
-            pPreset->m_nEarlyR_Delay2 = 0;
-            pPreset->m_nEarlyR_Gain2 = 14768;
-            pPreset->m_nEarlyR_Delay3 = 0;
-            pPreset->m_nEarlyR_Gain3 = 16153;
-            pPreset->m_nEarlyR_Delay4 = 0;
-            pPreset->m_nEarlyR_Gain4 = 13384;
-            pPreset->m_nMaxExcursion = 127;
-            pPreset->m_nXfadeInterval = 6449;
-            pPreset->m_nAp0_ApGain = 15691;
-            pPreset->m_nAp0_ApOut = 774;
-            pPreset->m_nAp1_ApGain = 15691;
-            pPreset->m_nAp1_ApOut = 1113;
-            pPreset->m_rfu4 = 0;
-            pPreset->m_rfu5 = 0;
-            pPreset->m_rfu6 = 0;
-            pPreset->m_rfu7 = 0;
-            pPreset->m_rfu8 = 0;
-            pPreset->m_rfu9 = 0;
-            pPreset->m_rfu10 = 0;
-        }
-        else if (defaultPreset == 3)
-        {
-            pPreset->m_nLpfFbk = 5077;
-            pPreset->m_nLpfFwd = 11076;
-            pPreset->m_nEarly = 0;
-            pPreset->m_nWet = 23075;
-            pPreset->m_nDry = 32767;
-            pPreset->m_nEarlyL_LpfFbk = 3692;
-            pPreset->m_nEarlyL_LpfFwd = 29075;
-            pPreset->m_nEarlyL_Delay0 = 922;
-            pPreset->m_nEarlyL_Gain0 = 22152;
-            pPreset->m_nEarlyL_Delay1 = 1462;
-            pPreset->m_nEarlyL_Gain1 = 17537;
-            pPreset->m_nEarlyL_Delay2 = 0;
-            pPreset->m_nEarlyL_Gain2 = 14768;
-            pPreset->m_nEarlyL_Delay3 = 1221;
-            pPreset->m_nEarlyL_Gain3 = 14307;
-            pPreset->m_nEarlyL_Delay4 = 0;
-            pPreset->m_nEarlyL_Gain4 = 13384;
-            pPreset->m_nEarlyR_Delay0 = 502;
-            pPreset->m_nEarlyR_Gain0 = 20306;
-            pPreset->m_nEarlyR_Delay1 = 1762;
-            pPreset->m_nEarlyR_Gain1 = 17537;
-            pPreset->m_nEarlyR_Delay2 = 0;
-            pPreset->m_nEarlyR_Gain2 = 14768;
-            pPreset->m_nEarlyR_Delay3 = 0;
-            pPreset->m_nEarlyR_Gain3 = 16153;
-            pPreset->m_nEarlyR_Delay4 = 0;
-            pPreset->m_nEarlyR_Gain4 = 13384;
-            pPreset->m_nMaxExcursion = 127;
-            pPreset->m_nXfadeInterval = 6470;   //6483;
-            pPreset->m_nAp0_ApGain = 14768;
-            pPreset->m_nAp0_ApOut = 792;
-            pPreset->m_nAp1_ApGain = 15783;
-            pPreset->m_nAp1_ApOut = 1113;
-            pPreset->m_rfu4 = 0;
-            pPreset->m_rfu5 = 0;
-            pPreset->m_rfu6 = 0;
-            pPreset->m_rfu7 = 0;
-            pPreset->m_rfu8 = 0;
-            pPreset->m_rfu9 = 0;
-            pPreset->m_rfu10 = 0;
-
-        }
-    }
-
-    return EAS_SUCCESS;
-}
@@ -90,7 +90,33 @@ if the buffer size is a power of two.
 // The buffer size MUST be a power of two
 #define REVERB_BUFFER_MASK                  (REVERB_BUFFER_SIZE_IN_SAMPLES -1)
 
+// with _REVERB_HALF_RATE the network always runs at half the output rate,
+// so the delay line only needs half of REVERB_BUFFER_SIZE_IN_SAMPLES
+#ifdef _REVERB_HALF_RATE
+#define REVERB_MIN_RATE_SHIFT               1
+#else
+#define REVERB_MIN_RATE_SHIFT               0
+#endif
+#define REVERB_DELAY_LINE_SIZE              (REVERB_BUFFER_SIZE_IN_SAMPLES >> REVERB_MIN_RATE_SHIFT)
+
 #define REVERB_MAX_ROOM_TYPE            4   // any room numbers larger than this are invalid
+#define REVERB_BLOCK_SIZE               32  // Reverb() processes at most this many samples per span
+
+#ifdef _REVERB
+// the send bus is in the 32-bit mix domain, which is about 2^5 times the 16-bit output
+#define REVERB_SEND_SHIFT               5
+#endif
+
+// the reverb goes idle once its input has been silent and its output has
+// stayed within about +/- REVERB_IDLE_LEVEL for REVERB_IDLE_SAMPLES. The
+// fixed point network does not decay to zero, it settles into a limit
+// cycle of a few tens of LSBs, so the level is set just above that. The
+// wet signal is then faded out over REVERB_IDLE_FADE_SAMPLES before the
+// rest of the tail is cleared, so it does not stop with a click.
+#define REVERB_IDLE_LEVEL               63  // must be (2^n)-1
+#define REVERB_IDLE_SAMPLES             REVERB_BUFFER_SIZE_IN_SAMPLES
+#define REVERB_IDLE_FADE_BITS           10
+#define REVERB_IDLE_FADE_SAMPLES        (1 << REVERB_IDLE_FADE_BITS)
 #define REVERB_MAX_NUM_REFLECTIONS      5   // max num reflections per channel
 
 /* synth parameters are updated every SYNTH_UPDATE_PERIOD_IN_SAMPLES */
@@ -198,90 +224,64 @@ typedef struct
 
 } S_EARLY_REFLECTION_OBJECT;
 
-//demo
+/*
+The presets are constant tables built at compile time. The delay and
+interval times of the original preset bank are given in seconds as
+16.16 fixed point and converted to samples at the output rate here, the
+lowpass coefficients are also given for the half rate network.
+*/
+#define REVERB_TIME_TO_SAMPLES(t)       (((t) * _OUTPUT_SAMPLE_RATE) >> 16)
+
+// keep the time constant and DC gain at half the rate: fbk' = fbk^2, fwd' = fwd * (1 - fbk') / (1 - fbk)
+#define REVERB_HALF_RATE_FBK(fbk)       (((fbk) * (fbk)) >> NUM_EG1_FRAC_BITS)
+#define REVERB_HALF_RATE_FWD(fwd,fbk)   (((fwd) * (32768 - REVERB_HALF_RATE_FBK(fbk))) / (32768 - (fbk)))
+
 typedef struct
 {
     EAS_I16             m_nLpfFbk;
     EAS_I16             m_nLpfFwd;
+    EAS_I16             m_nLpfFbkHalf;          // lowpass for the half rate network
+    EAS_I16             m_nLpfFwdHalf;
 
     EAS_I16             m_nEarly;
     EAS_I16             m_nWet;
     EAS_I16             m_nDry;
 
-    EAS_I16             m_nEarlyL_LpfFbk;
-    EAS_I16             m_nEarlyL_LpfFwd;
-
-    EAS_I16             m_nEarlyL_Delay0; //8
-    EAS_I16             m_nEarlyL_Gain0;
-    EAS_I16             m_nEarlyL_Delay1;
-    EAS_I16             m_nEarlyL_Gain1;
-    EAS_I16             m_nEarlyL_Delay2;
-    EAS_I16             m_nEarlyL_Gain2;
-    EAS_I16             m_nEarlyL_Delay3;
-    EAS_I16             m_nEarlyL_Gain3;
-    EAS_I16             m_nEarlyL_Delay4;
-    EAS_I16             m_nEarlyL_Gain4;
-
-    EAS_I16             m_nEarlyR_Delay0; //18
-    EAS_I16             m_nEarlyR_Gain0;
-    EAS_I16             m_nEarlyR_Delay1;
-    EAS_I16             m_nEarlyR_Gain1;
-    EAS_I16             m_nEarlyR_Delay2;
-    EAS_I16             m_nEarlyR_Gain2;
-    EAS_I16             m_nEarlyR_Delay3;
-    EAS_I16             m_nEarlyR_Gain3;
-    EAS_I16             m_nEarlyR_Delay4;
-    EAS_I16             m_nEarlyR_Gain4;
-
-    EAS_U16             m_nMaxExcursion; //28
-    EAS_I16             m_nXfadeInterval;
-
-    EAS_I16             m_nAp0_ApGain; //30
-    EAS_I16             m_nAp0_ApOut;
-    EAS_I16             m_nAp1_ApGain;
-    EAS_I16             m_nAp1_ApOut;
+    EAS_U16             m_nMaxExcursion;
+    EAS_U16             m_nXfadeInterval;       // in samples
 
-    EAS_I16             m_rfu4;
-    EAS_I16             m_rfu5;
-    EAS_I16             m_rfu6;
-    EAS_I16             m_rfu7;
-    EAS_I16             m_rfu8;
-    EAS_I16             m_rfu9;
-    EAS_I16             m_rfu10; //43
+    EAS_I16             m_nAp0_ApGain;
+    EAS_U16             m_nAp0_ApOut;           // allpass length in samples
+    EAS_I16             m_nAp1_ApGain;
+    EAS_U16             m_nAp1_ApOut;
 
 } S_REVERB_PRESET;
 
-typedef struct
-{
-    S_REVERB_PRESET     m_sPreset[REVERB_MAX_ROOM_TYPE];    //array of presets
+/*
+The crossfade sweeps m_nPhase from one end to the other in steps of
+REVERB_XFADE_PHASE_INCREMENT, once per call. The sin and cos for each step
+are tabulated at compile time for both directions, see ReverbCalculateSinCos
+for the approximation. m_nPhase/2 never leaves -0.5 to +0.5, so the angle
+needs no limiting.
+*/
+#define REVERB_XFADE_STEPS              32      // steps tabulated, the rest are calculated
 
-} S_REVERB_PRESET_BANK;
+#define REVERB_XFADE_PHASE(up,k)        ((EAS_I16) ((up) ? (-32768 + (k) * REVERB_XFADE_PHASE_INCREMENT) : \
+                                                           (32767 - (k) * REVERB_XFADE_PHASE_INCREMENT)))
+#define REVERB_XFADE_LIMIT(x)           (((x) > SYNTH_FULL_SCALE_EG1_GAIN) ? SYNTH_FULL_SCALE_EG1_GAIN : \
+                                         (((x) < EG1_MINUS_ONE) ? EG1_MINUS_ONE : (x)))
+#define REVERB_XFADE_POLY(g1,a)         (REVERB_PAN_G0 + MULT_EG1_EG1((g1) + MULT_EG1_EG1(REVERB_PAN_G2, (a)), (a)))
+#define REVERB_XFADE_SIN(p)             REVERB_XFADE_LIMIT(REVERB_XFADE_POLY(EG1_ONE, (p) >> 1))
+#define REVERB_XFADE_COS(p)             REVERB_XFADE_LIMIT(REVERB_XFADE_POLY(-EG1_ONE, (p) >> 1))
+#define REVERB_XFADE_ENTRY(up,k)        { REVERB_XFADE_SIN(REVERB_XFADE_PHASE(up,k)), REVERB_XFADE_COS(REVERB_XFADE_PHASE(up,k)) }
 
 /* parameters for each reverb */
 typedef struct
 {
-    /* controls entire reverb playback volume */
-    /* to conserve memory, use the MSB and ignore the LSB */
-    EAS_U8              m_nMasterVolume;
-
     /* update counter keeps track of when synth params need updating */
     /* only needs to be as large as REVERB_UPDATE_PERIOD_IN_SAMPLES */
     EAS_I16             m_nUpdateCounter;
 
-    EAS_U16             m_nMinSamplesToAdd;         /* ComputeReverb() generates this many samples */
-
-    EAS_U8              m_nFlags;                   /* misc flags/bit fields */
-
-    EAS_PCM             *m_pOutputBuffer;
-    EAS_PCM             *m_pInputBuffer;
-
-    EAS_U16             m_nNumSamplesInOutputBuffer;
-    EAS_U16             m_nNumSamplesInInputBuffer;
-
-    EAS_U16             m_nNumInputSamplesRead;     // if m_nNumInputSamplesRead >= NumSamplesInInputBuffer
-                                                    // then get a new input buffer
-    EAS_PCM             *m_pNextInputSample;
-
     EAS_U16             m_nBaseIndex;                                   // base index for circular buffer
 
     // reverb delay line offsets, allpass parameters, etc:
@@ -333,12 +333,12 @@ typedef struct
 
     EAS_I16             m_nPhaseIncrement;          // add this to m_nPhase each frame
 
+    EAS_I16             m_nXfadeStep;               // steps of m_nPhase since the last xfade, see REVERB_XFADE_STEPS
+
     EAS_I16             m_nNoise;                   // random noise sample
 
     EAS_U16             m_nMaxExcursion;            // the taps can excurse +/- this amount
 
-    EAS_BOOL            m_bUseNoise;                // if EAS_TRUE, use noise as input signal
-
     EAS_BOOL            m_bBypass;                  // if EAS_TRUE, then bypass reverb and copy input to output
 
     EAS_I16             m_nCurrentRoom;             // preset number for current room
@@ -354,13 +354,24 @@ typedef struct
     S_EARLY_REFLECTION_OBJECT   m_sEarlyL;          // left channel early reflections
     S_EARLY_REFLECTION_OBJECT   m_sEarlyR;          // right channel early reflections
 
-    EAS_PCM             m_nDelayLine[REVERB_BUFFER_SIZE_IN_SAMPLES];    // one large delay line for all reverb elements
-
-    S_REVERB_PRESET     pPreset;
-
-    S_REVERB_PRESET_BANK    m_sPreset;
-
-    //EAS_I8            preset;
+    EAS_BOOL            m_bIdle;                    // if EAS_TRUE, the tail has died away and Reverb() is skipped
+    EAS_I32             m_nIdleCount;               // samples of silent input with an inaudible tail
+    EAS_I32             m_nTailLevel;               // level of the reverb output in the last call, see REVERB_IDLE_LEVEL
+    EAS_I32             m_nIdleGain;                // gain of the wet signal while fading out, REVERB_IDLE_FADE_SAMPLES is full level
+    EAS_I32             m_nIdleStep;                // -1 while fading out before going idle, 1 while fading back in, else 0
+
+    EAS_U16             m_nBufferMask;              // mask for the part of the delay line in use
+    EAS_I16             m_nRateShift;               // 1 if the network runs at half the output rate
+    EAS_I16             m_nNextRateShift;           // rate shift requested through EAS_PARAM_REVERB_HALF_RATE
+    EAS_PCM             m_nDecimL;                  // last odd input sample, for the decimation filter
+    EAS_PCM             m_nDecimR;
+    EAS_PCM             m_nInterpL;                 // last half rate output sample, for the interpolation filter
+    EAS_PCM             m_nInterpR;
+    EAS_PCM             m_nPendingL;                // last input sample of an odd length call, waiting for its pair
+    EAS_PCM             m_nPendingR;
+    EAS_I16             m_nPending;                 // 1 if m_nPendingL and m_nPendingR hold a sample
+
+    EAS_PCM             m_nDelayLine[REVERB_DELAY_LINE_SIZE];   // one large delay line for all reverb elements
 
 } S_REVERB_OBJECT;
 
@@ -449,18 +460,6 @@ static EAS_RESULT ReverbCalculateSinCos(EAS_I16 nPhase, EAS_I16 *pnSin, EAS_I16
 */
 static EAS_RESULT Reverb(S_REVERB_OBJECT* pReverbData, EAS_INT nNumSamplesToAdd, EAS_PCM *pOutputBuffer, EAS_PCM *pInputBuffer);
 
-/*----------------------------------------------------------------------------
- * ReverbReadInPresets()
- *----------------------------------------------------------------------------
- * Purpose: sets global reverb preset bank to defaults
- *
- * Inputs:
- *
- * Outputs:
- *
- *----------------------------------------------------------------------------
-*/
-static EAS_RESULT ReverbReadInPresets(S_REVERB_OBJECT* pReverbData);
 
 
 /*----------------------------------------------------------------------------
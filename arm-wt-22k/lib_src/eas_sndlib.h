@@ -92,6 +92,13 @@ typedef struct s_region_tag
  */
 #define REGION_FLAG_IS_LOOPED                   0x01
 #define REGION_FLAG_USE_WAVE_GENERATOR          0x02
+/*
+ * REGION_FLAG_USE_ADPCM marks an unlooped sample stored as packed 4-bit
+ * IMA ADPCM codes (low nibble first, decoder starts at zero). The sample
+ * length still counts the decoded 16-bit samples in bytes. Only supported
+ * when the library is built with _ADPCM_SAMPLES. The DLS loader sets it on
+ * the unlooped waves it encodes, the built-in library has no ADPCM regions.
+ */
 #define REGION_FLAG_USE_ADPCM                   0x04
 #define REGION_FLAG_ONE_SHOT                    0x08
 #define REGION_FLAG_SQUARE_WAVE                 0x10
@@ -328,7 +335,35 @@ typedef struct s_bank_tag
 #define LIB_FORMAT_FILTER_ENABLED       0x00100000
 #define LIB_FORMAT_16_BIT_SAMPLES       0x00200000
 
+#if defined(DLS_SYNTHESIZER) && defined(_DLS_LAZY_LOAD)
+/*----------------------------------------------------------------------------
+ * DLS wave cache entry
+ *
+ * With lazy loading, the samples for a wave are read from the file and
+ * converted when the file is prepared, and only for the programs the
+ * file selects. pSamples is NULL if the wave was not loaded.
+ *----------------------------------------------------------------------------
+*/
+typedef struct s_dls_wave_tag
+{
+    EAS_SAMPLE      *pSamples;          /* converted samples, NULL if not loaded */
+    EAS_I32         dataPos;            /* file offset of the data chunk */
+    EAS_I32         dataSize;           /* size of the data chunk */
+    EAS_U32         size;               /* size of the converted samples */
+    EAS_U32         loopStart;
+    EAS_U32         loopLength;
+    EAS_U16         bitsPerSample;
+    EAS_U8          flags;              /* see DLS_WAVE_FLAG_xxx */
+} S_DLS_WAVE;
+
+#define DLS_WAVE_FLAG_USE_ADPCM         0x01
+#endif
+
 #ifdef DLS_SYNTHESIZER
+/* DLS program hash table, size is a power of 2 */
+#define DLS_MIN_PROGRAM_HASH_SIZE       4
+#define DLS_PROGRAM_HASH(locale)        ((locale) ^ ((locale) >> 8) ^ ((locale) >> 16))
+
 /*----------------------------------------------------------------------------
  * DLS data structure
  *
@@ -341,6 +376,9 @@ typedef struct s_bank_tag
  * numDLSRegions        number of DLS regions
  * numDLSArticulations  number of DLS articulations
  * numDLSSamples        number of DLS samples
+ * pDLSProgramHash      hash table of program indices + 1, by locale
+ * programHashMask      size of program hash table - 1
+ * pDLSWaves            wave cache (lazy loading only)
  *----------------------------------------------------------------------------
 */
 typedef struct s_eas_dls_tag
@@ -351,11 +389,20 @@ typedef struct s_eas_dls_tag
     EAS_U32             *pDLSSampleLen;
     EAS_U32             *pDLSSampleOffsets;
     EAS_SAMPLE          *pDLSSamples;
+    EAS_U16             *pDLSProgramHash;
     EAS_U16             numDLSPrograms;
     EAS_U16             numDLSRegions;
     EAS_U16             numDLSArticulations;
     EAS_U16             numDLSSamples;
+    EAS_U16             programHashMask;
     EAS_U8              refCount;
+#ifdef _DLS_LAZY_LOAD
+    S_DLS_WAVE          *pDLSWaves;         /* wave cache, NULL if all samples are resident */
+    EAS_HW_DATA_HANDLE  hwInstData;
+    EAS_FILE_HANDLE     fileHandle;         /* private handle for loading waves */
+    EAS_U32             cacheSize;          /* bytes of sample data loaded */
+    EAS_BOOL            bigEndian;
+#endif
 } S_DLS;
 #endif
 
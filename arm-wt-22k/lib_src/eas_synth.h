@@ -185,12 +185,19 @@
 #define CHANNEL_FLAG_UPDATE_CHANNEL_PARAMETERS          0x04
 #define CHANNEL_FLAG_RHYTHM_CHANNEL                     0x08
 #define CHANNEL_FLAG_EXTERNAL_AUDIO                     0x10
+#define CHANNEL_FLAG_KEY_MAP                            0x20
 #define DEFAULT_CHANNEL_FLAGS                           0
 
+/* S_SYNTH_CHANNEL key map entry for keys with no region */
+#define KEY_MAP_NO_REGION                               0xff
+
 /* macros for extracting virtual synth and channel numbers */
 #define GET_VSYNTH(a) ((a) >> 4)
 #define GET_CHANNEL(a) ((a) & 15)
 
+/* number of 32-bit words in a bit mask with one bit per voice */
+#define SYNTH_VOICE_MASK_WORDS  ((MAX_SYNTH_VOICES + 31) >> 5)
+
 typedef struct s_synth_channel_tag
 {
     /* use static channel parameters to reduce MIPs */
@@ -236,6 +243,10 @@ typedef struct s_synth_channel_tag
 #ifdef  _CHORUS
     EAS_U8      chorusSend;         /* CC93 */
 #endif
+
+    /* region offsets from regionIndex for each key, see VMBuildKeyMap */
+    EAS_U8      keyMapFirst[128];
+    EAS_U8      keyMapLast[128];
 } S_SYNTH_CHANNEL;
 
 /*------------------------------------
@@ -322,6 +333,7 @@ typedef struct s_synth_tag
     EAS_U16                 maxPolyphony;
     EAS_U16                 numActiveVoices;
     EAS_U16                 masterVolume;
+    EAS_U16                 dirtyChannels;      /* one bit per channel with CHANNEL_FLAG_UPDATE_CHANNEL_PARAMETERS set */
     EAS_U8                  channelsByPriority[NUM_SYNTH_CHANNELS];
     EAS_U8                  poolCount[NUM_SYNTH_CHANNELS];
     EAS_U8                  poolAlloc[NUM_SYNTH_CHANNELS];
@@ -332,6 +344,57 @@ typedef struct s_synth_tag
     EAS_U8                  priority;
 } S_SYNTH;
 
+#ifdef _WT_SYNTH
+/*------------------------------------
+ * S_WT_CONTROL data structure
+ *
+ * Envelope and LFO state of all the
+ * wavetable voices, one array per field,
+ * so that they can be updated in one
+ * pass per frame (see WT_UpdateControl)
+ *------------------------------------
+*/
+typedef struct s_wt_control_tag
+{
+    EAS_I16                 eg1Value[NUM_WT_VOICES];
+    EAS_I16                 eg2Value[NUM_WT_VOICES];
+    EAS_I16                 eg1Increment[NUM_WT_VOICES];
+    EAS_I16                 eg2Increment[NUM_WT_VOICES];
+
+    /* LFO output, phase (negative during the delay) and phase increment */
+    EAS_I16                 modLFOValue[NUM_WT_VOICES];
+    EAS_I16                 modLFOPhase[NUM_WT_VOICES];
+    EAS_I16                 modLFOPhaseInc[NUM_WT_VOICES];
+#ifdef DLS_SYNTHESIZER
+    EAS_I16                 vibLFOValue[NUM_WT_VOICES];
+    EAS_I16                 vibLFOPhase[NUM_WT_VOICES];
+    EAS_I16                 vibLFOPhaseInc[NUM_WT_VOICES];
+#endif
+
+    /* pitch in cents of the last frame and the phase increment it converts to */
+    EAS_I32                 pitchCents[NUM_WT_VOICES];
+    EAS_I32                 phaseInc[NUM_WT_VOICES];
+
+#ifdef _FILTER_ENABLED
+    /* cutoff and resonance of the last frame and the filter coefficients they convert to */
+    EAS_I32                 filterK[NUM_WT_VOICES];
+    EAS_I32                 filterB1[NUM_WT_VOICES];
+    EAS_I32                 filterB2[NUM_WT_VOICES];
+    EAS_I16                 filterCutoff[NUM_WT_VOICES];
+    EAS_U8                  filterQ[NUM_WT_VOICES];
+#endif
+
+    EAS_U8                  eg1State[NUM_WT_VOICES];
+    EAS_U8                  eg2State[NUM_WT_VOICES];
+} S_WT_CONTROL;
+
+/* pitch of a voice that has not been converted yet, any pitch this low converts to 0 */
+#define WT_PITCH_CENTS_NONE     (-0x7fffffffL)
+
+/* cutoff of a voice whose filter coefficients have not been calculated yet, outside the clamped range */
+#define WT_FILTER_CUTOFF_NONE   0x7fff
+#endif
+
 /*------------------------------------
  * S_VOICE_MGR data structure
  *
@@ -350,17 +413,32 @@ typedef struct s_voice_mgr_tag
 
 #ifdef _WT_SYNTH
     S_WT_VOICE              wtVoices[NUM_WT_VOICES];
+    S_WT_CONTROL            wtControl;
 #endif
 
 #ifdef _REVERB
-    EAS_PCM                 reverbSendBuffer[NUM_OUTPUT_CHANNELS * SYNTH_UPDATE_PERIOD_IN_SAMPLES];
+    EAS_I32                 reverbSendBuffer[NUM_OUTPUT_CHANNELS * BUFFER_SIZE_IN_MONO_SAMPLES];
 #endif
 
 #ifdef _CHORUS
-    EAS_PCM                 chorusSendBuffer[NUM_OUTPUT_CHANNELS * SYNTH_UPDATE_PERIOD_IN_SAMPLES];
+    EAS_I32                 chorusSendBuffer[NUM_OUTPUT_CHANNELS * BUFFER_SIZE_IN_MONO_SAMPLES];
 #endif
     S_SYNTH_VOICE           voices[MAX_SYNTH_VOICES];
 
+    /* active voices by channel, and stolen voices by the channel of their next note */
+    EAS_U32                 channelVoices[MAX_VIRTUAL_SYNTHESIZERS * NUM_SYNTH_CHANNELS][SYNTH_VOICE_MASK_WORDS];
+    EAS_U32                 stolenVoices[MAX_VIRTUAL_SYNTHESIZERS * NUM_SYNTH_CHANNELS][SYNTH_VOICE_MASK_WORDS];
+
+#ifdef _STEAL_INDEX
+    /* steal scores by voice, the tree of the best candidates above them, and the stale scores */
+    EAS_I32                 stealScore[MAX_SYNTH_VOICES];
+    EAS_U8                  stealTree[2 * MAX_SYNTH_VOICES];
+    EAS_U32                 stealDirty[SYNTH_VOICE_MASK_WORDS];
+#ifdef _STEAL_INDEX_CHECK
+    EAS_BOOL                stealMismatch;
+#endif
+#endif
+
     EAS_SNDLIB_HANDLE       pGlobalEAS;
 
 #ifdef DLS_SYNTHESIZER
@@ -379,6 +457,15 @@ typedef struct s_voice_mgr_tag
     EAS_I32                 workload;
     EAS_I32                 maxWorkLoad;
 
+#ifdef _ADAPTIVE_POLYPHONY
+    /* render time controller, see VMUpdateRenderLoad */
+    EAS_I32                 renderBudget;
+    EAS_I32                 renderLoad;
+    EAS_U16                 loadCeiling;
+    EAS_U16                 loadHold;
+    EAS_BOOL                loadThrottle;
+#endif
+
     EAS_U16                 activeVoices;
     EAS_U16                 maxPolyphony;
 
@@ -282,8 +282,9 @@ EAS_RESULT VMFindAvailableVoice (S_VOICE_MGR *pVoiceMgr, EAS_INT *pVoiceNumber,
  * Stealing algorithm: steal the best choice with minimal work, taking into
  * account SP-Midi channel priorities and polyphony allocation.
  *
- * In one pass through all the voices, figure out which voice to steal
- * taking into account a number of different factors:
+ * Figure out which voice to steal, from the steal tree when built with
+ * _STEAL_INDEX or else in one pass through all the voices, taking into
+ * account a number of different factors:
  * Priority of the voice's MIDI channel
  * Number of voices over the polyphony allocation for voice's MIDI channel
  * Amplitude of the voice
@@ -976,6 +977,41 @@ void VMSetWorkload (S_VOICE_MGR *pVoiceMgr, EAS_I32 maxWorkLoad);
 */
 EAS_BOOL VMCheckWorkload (S_VOICE_MGR *pVoiceMgr);
 
+#ifdef _ADAPTIVE_POLYPHONY
+/*----------------------------------------------------------------------------
+ * VMSetRenderBudget()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Sets the time allowed to render one frame, 0 = no limit.
+ *
+ * Inputs:
+ * pVoiceMgr        - pointer to instance data
+ * budget           - render budget in microseconds per frame
+ *
+ * Outputs:
+ * Returns error code
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT VMSetRenderBudget (S_VOICE_MGR *pVoiceMgr, EAS_I32 budget);
+
+/*----------------------------------------------------------------------------
+ * VMUpdateRenderLoad()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Adjusts the polyphony limit from the measured frame time.
+ *
+ * Inputs:
+ * pVoiceMgr        - pointer to instance data
+ * frameTime        - time spent on this frame in microseconds
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+void VMUpdateRenderLoad (S_VOICE_MGR *pVoiceMgr, EAS_I32 frameTime);
+#endif
+
 /*----------------------------------------------------------------------------
  * VMActiveVoices()
  *----------------------------------------------------------------------------
@@ -1030,6 +1066,30 @@ void VMMIDIShutdown (S_EAS_DATA *pEASData, S_SYNTH *pSynth);
 */
 void VMShutdown (S_EAS_DATA *pEASData);
 
+#ifdef _INSTANCE_POOL
+/*----------------------------------------------------------------------------
+ * VMRestore()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Restores the voice manager to a pristine state saved right after
+ * VMInitialize.
+ *
+ * Inputs:
+ * psEASData - pointer to overall EAS data structure
+ * pTemplate - copy of the voice manager taken after VMInitialize
+ *
+ * Outputs:
+ * None
+ *
+ * Side Effects:
+ * Any global DLS collection is released. All streams must already be
+ * closed.
+ *
+ *----------------------------------------------------------------------------
+*/
+void VMRestore (S_EAS_DATA *pEASData, const S_VOICE_MGR *pTemplate);
+#endif
+
 #ifdef EXTERNAL_AUDIO
 /*----------------------------------------------------------------------------
  * EAS_RegExtAudioCallback()
@@ -50,6 +50,27 @@
 #define WORKLOAD_AMOUNT_KEY_GROUP           10
 #define WORKLOAD_AMOUNT_POLY_LIMIT          10
 
+#ifdef _ADAPTIVE_POLYPHONY
+/* render time controller: smoothing of the measured frame time, frames to
+ * wait between polyphony changes, lowest polyphony it will go down to, and
+ * the per-frame parse workload while over budget */
+#define LOAD_SMOOTHING_SHIFT                3
+#define LOAD_HOLD_FRAMES                    8
+#define LOAD_MIN_POLYPHONY                  8
+#define LOAD_MAX_WORKLOAD                   (8 * WORKLOAD_AMOUNT_START_NOTE)
+
+/* the controller only lowers pVoiceMgr->maxPolyphony for a while, stream
+ * allocations are made against the polyphony it works below */
+#define VM_POLYPHONY_CEILING(pVoiceMgr)     ((pVoiceMgr)->renderBudget ? (pVoiceMgr)->loadCeiling : (pVoiceMgr)->maxPolyphony)
+#else
+#define VM_POLYPHONY_CEILING(pVoiceMgr)     ((pVoiceMgr)->maxPolyphony)
+#endif
+
+#ifdef _STEAL_INDEX
+/* above this many stale steal scores the whole tree is rebuilt rather than one path per voice */
+#define STEAL_INDEX_REBUILD_COUNT           (MAX_SYNTH_VOICES >> 3)
+#endif
+
 /* pointer to base sound library */
 extern S_EAS easSoundLib;
 
@@ -252,6 +273,77 @@ static void DecVoicePoolCount (S_VOICE_MGR *pVoiceMgr, S_SYNTH_VOICE *pVoice)
 #endif
 }
 
+/*----------------------------------------------------------------------------
+ * VMClearVoiceChannel()
+ *----------------------------------------------------------------------------
+ * Removes a voice from the channel voice masks before it is freed or
+ * assigned to a new channel
+ *----------------------------------------------------------------------------
+*/
+static void VMClearVoiceChannel (S_VOICE_MGR *pVoiceMgr, EAS_INT voiceNum)
+{
+    S_SYNTH_VOICE *pVoice = &pVoiceMgr->voices[voiceNum];
+    EAS_U32 bit = 1UL << (voiceNum & 31);
+
+    if (pVoice->voiceState == eVoiceStateFree)
+        return;
+    pVoiceMgr->channelVoices[pVoice->channel][voiceNum >> 5] &= ~bit;
+    if (pVoice->voiceState == eVoiceStateStolen)
+        pVoiceMgr->stolenVoices[pVoice->nextChannel][voiceNum >> 5] &= ~bit;
+}
+
+#ifdef _STEAL_INDEX
+/*----------------------------------------------------------------------------
+ * VMStealIndexDirty()
+ *----------------------------------------------------------------------------
+ * Marks the steal score of a voice as stale after its state, flags, age or
+ * gain changed, VMGetStealCandidate scores it again before the next steal
+ *----------------------------------------------------------------------------
+*/
+EAS_INLINE void VMStealIndexDirty (S_VOICE_MGR *pVoiceMgr, EAS_INT voiceNum)
+{
+    pVoiceMgr->stealDirty[voiceNum >> 5] |= 1UL << (voiceNum & 31);
+}
+#endif
+
+/*----------------------------------------------------------------------------
+ * VMGetChannelVoices()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Lists the active voices on a channel in ascending order, so that channel
+ * and note events only visit the voices they can affect
+ *
+ * Inputs:
+ * channel - virtual synth channel (see VSynthToChannel)
+ * stolen - also list stolen voices whose next note is on this channel
+ * pVoiceList - receives the voice numbers, MAX_SYNTH_VOICES entries
+ *
+ * Outputs:
+ * Returns the number of voices listed
+ *----------------------------------------------------------------------------
+*/
+static EAS_INT VMGetChannelVoices (S_VOICE_MGR *pVoiceMgr, EAS_U8 channel, EAS_BOOL stolen, EAS_U8 *pVoiceList)
+{
+    EAS_INT numVoices;
+    EAS_INT voiceNum;
+    EAS_INT word;
+    EAS_U32 bits;
+
+    numVoices = 0;
+    for (word = 0; word < SYNTH_VOICE_MASK_WORDS; word++)
+    {
+        bits = pVoiceMgr->channelVoices[channel][word];
+        if (stolen)
+            bits |= pVoiceMgr->stolenVoices[channel][word];
+        for (voiceNum = word << 5; bits != 0; voiceNum++, bits >>= 1)
+        {
+            if (bits & 1)
+                pVoiceList[numVoices++] = (EAS_U8) voiceNum;
+        }
+    }
+    return numVoices;
+}
+
 /*----------------------------------------------------------------------------
  * VMInitialize()
  *----------------------------------------------------------------------------
@@ -297,6 +389,15 @@ EAS_RESULT VMInitialize (S_EAS_DATA *pEASData)
     for (i = 0; i < MAX_SYNTH_VOICES; i++)
         InitVoice(&pVoiceMgr->voices[i]);
 
+#ifdef _STEAL_INDEX
+    /* the leaves of the steal tree, scored before the first steal */
+    for (i = 0; i < MAX_SYNTH_VOICES; i++)
+    {
+        pVoiceMgr->stealTree[MAX_SYNTH_VOICES + i] = (EAS_U8) i;
+        VMStealIndexDirty(pVoiceMgr, i);
+    }
+#endif
+
     /* initialize the synth */
     /*lint -e{522} return unused at this time */
     pPrimarySynth->pfInitialize(pVoiceMgr);
@@ -388,7 +489,7 @@ EAS_RESULT VMInitMIDI (S_EAS_DATA *pEASData, S_SYNTH **ppSynth)
     pSynth->masterVolume = DEFAULT_SYNTH_MASTER_VOLUME;
     pSynth->refCount = 1;
     pSynth->priority = DEFAULT_SYNTH_PRIORITY;
-    pSynth->poolAlloc[0] = (EAS_U8) pEASData->pVoiceMgr->maxPolyphony;
+    pSynth->poolAlloc[0] = (EAS_U8) VM_POLYPHONY_CEILING(pEASData->pVoiceMgr);
 
     VMInitializeAllChannels(pEASData->pVoiceMgr, pSynth);
 
@@ -457,8 +558,8 @@ void VMReset (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_BOOL force)
             pSynth->poolCount[i] = 0;
 
         /* set polyphony */
-        if (pSynth->maxPolyphony < pVoiceMgr->maxPolyphony)
-            pSynth->poolAlloc[0] = (EAS_U8) pVoiceMgr->maxPolyphony;
+        if (pSynth->maxPolyphony < VM_POLYPHONY_CEILING(pVoiceMgr))
+            pSynth->poolAlloc[0] = (EAS_U8) VM_POLYPHONY_CEILING(pVoiceMgr);
         else
             pSynth->poolAlloc[0] = (EAS_U8) pSynth->maxPolyphony;
 
@@ -558,6 +659,7 @@ void VMResetControllers (S_SYNTH *pSynth)
         /* update all voices on this channel */
         pChannel->channelFlags |= CHANNEL_FLAG_UPDATE_CHANNEL_PARAMETERS;
     }
+    pSynth->dirtyChannels = (EAS_U16) ((1 << NUM_SYNTH_CHANNELS) - 1);
 }
 
 /*----------------------------------------------------------------------------
@@ -582,12 +684,24 @@ void VMInitializeAllVoices (S_VOICE_MGR *pVoiceMgr, EAS_INT vSynthNum)
         if (pVoiceMgr->voices[i].voiceState != eVoiceStateStolen)
         {
             if (GET_VSYNTH(pVoiceMgr->voices[i].channel) == vSynthNum)
+            {
+                VMClearVoiceChannel(pVoiceMgr, i);
                 InitVoice(&pVoiceMgr->voices[i]);
+#ifdef _STEAL_INDEX
+                VMStealIndexDirty(pVoiceMgr, i);
+#endif
+            }
         }
         else
         {
             if (GET_VSYNTH(pVoiceMgr->voices[i].nextChannel) == vSynthNum)
+            {
+                VMClearVoiceChannel(pVoiceMgr, i);
                 InitVoice(&pVoiceMgr->voices[i]);
+#ifdef _STEAL_INDEX
+                VMStealIndexDirty(pVoiceMgr, i);
+#endif
+            }
         }
     }
 }
@@ -711,7 +825,7 @@ void VMMIPUpdateChannelMuting (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth)
     if (pSynth->maxPolyphony)
         maxPolyphony = pSynth->maxPolyphony;
     else
-        maxPolyphony = pVoiceMgr->maxPolyphony;
+        maxPolyphony = VM_POLYPHONY_CEILING(pVoiceMgr);
 
     /* process channels */
     for (i = 0; i < NUM_SYNTH_CHANNELS; i++)
@@ -968,7 +1082,10 @@ void VMReleaseAllVoices (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth)
 */
 void VMAllNotesOff (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel)
 {
+    EAS_U8 voiceList[MAX_SYNTH_VOICES];
+    EAS_INT numVoices;
     EAS_INT voiceNum;
+    EAS_INT i;
     S_SYNTH_VOICE *pVoice;
 
 #ifdef _DEBUG_VM
@@ -983,10 +1100,12 @@ void VMAllNotesOff (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel)
     /* increment workload */
     pVoiceMgr->workload += WORKLOAD_AMOUNT_SMALL_INCREMENT;
 
-    /* check each voice */
+    /* check each voice on this channel */
     channel = VSynthToChannel(pSynth, channel);
-    for (voiceNum = 0; voiceNum < MAX_SYNTH_VOICES; voiceNum++)
+    numVoices = VMGetChannelVoices(pVoiceMgr, channel, EAS_TRUE, voiceList);
+    for (i = 0; i < numVoices; i++)
     {
+        voiceNum = voiceList[i];
         pVoice = &pVoiceMgr->voices[voiceNum];
         if (pVoice->voiceState != eVoiceStateFree)
         {
@@ -1129,7 +1248,10 @@ void VMDeferredStopNote (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth)
 void VMReleaseAllDeferredNoteOffs (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel)
 {
     S_SYNTH_VOICE *pVoice;
+    EAS_U8 voiceList[MAX_SYNTH_VOICES];
+    EAS_INT numVoices;
     EAS_INT voiceNum;
+    EAS_INT i;
 
 #ifdef _DEBUG_VM
     if (channel >= NUM_SYNTH_CHANNELS)
@@ -1145,9 +1267,11 @@ void VMReleaseAllDeferredNoteOffs (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_
 
     /* find all the voices assigned to this channel */
     channel = VSynthToChannel(pSynth, channel);
-    for (voiceNum = 0; voiceNum < MAX_SYNTH_VOICES; voiceNum++)
+    numVoices = VMGetChannelVoices(pVoiceMgr, channel, EAS_FALSE, voiceList);
+    for (i = 0; i < numVoices; i++)
     {
 
+        voiceNum = voiceList[i];
         pVoice = &pVoiceMgr->voices[voiceNum];
         if (channel == pVoice->channel)
         {
@@ -1189,7 +1313,10 @@ void VMReleaseAllDeferredNoteOffs (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_
 */
 void VMCatchNotesForSustainPedal (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel)
 {
+    EAS_U8 voiceList[MAX_SYNTH_VOICES];
+    EAS_INT numVoices;
     EAS_INT voiceNum;
+    EAS_INT i;
 
 #ifdef _DEBUG_VM
     if (channel >= NUM_SYNTH_CHANNELS)
@@ -1204,8 +1331,10 @@ void VMCatchNotesForSustainPedal (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U
     channel = VSynthToChannel(pSynth, channel);
 
     /* find all the voices assigned to this channel */
-    for (voiceNum = 0; voiceNum < MAX_SYNTH_VOICES; voiceNum++)
+    numVoices = VMGetChannelVoices(pVoiceMgr, channel, EAS_FALSE, voiceList);
+    for (i = 0; i < numVoices; i++)
     {
+        voiceNum = voiceList[i];
         if (channel == pVoiceMgr->voices[voiceNum].channel)
         {
             if (eVoiceStateRelease == pVoiceMgr->voices[voiceNum].voiceState)
@@ -1236,7 +1365,12 @@ void VMUpdateAllNotesAge (S_VOICE_MGR *pVoiceMgr, EAS_U16 age)
     for (i = 0; i < MAX_SYNTH_VOICES; i++)
     {
         if (age - pVoiceMgr->voices[i].age > 0)
+        {
             pVoiceMgr->voices[i].age++;
+#ifdef _STEAL_INDEX
+            VMStealIndexDirty(pVoiceMgr, i);
+#endif
+        }
      }
 }
 
@@ -1264,12 +1398,17 @@ static void VMStolenVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_I32 voic
     /* one less voice in old pool */
     DecVoicePoolCount(pVoiceMgr, pVoice);
 
+    /* a voice that is stolen again drops its previous next note */
+    if (pVoice->voiceState == eVoiceStateStolen)
+        pVoiceMgr->stolenVoices[pVoice->nextChannel][voiceNum >> 5] &= ~(1UL << (voiceNum & 31));
+
     /* mute the sound that is currently playing */
     GetSynthPtr(voiceNum)->pfMuteVoice(pVoiceMgr, pVoiceMgr->pSynth[GET_VSYNTH(pVoice->channel)], &pVoiceMgr->voices[voiceNum], GetAdjustedVoiceNum(voiceNum));
     pVoice->voiceState = eVoiceStateStolen;
 
     /* set new note data */
     pVoice->nextChannel = VSynthToChannel(pSynth, channel);
+    pVoiceMgr->stolenVoices[pVoice->nextChannel][voiceNum >> 5] |= 1UL << (voiceNum & 31);
     pVoice->nextNote = note;
     pVoice->nextVelocity = velocity;
     pVoice->nextRegionIndex = regionIndex;
@@ -1288,6 +1427,9 @@ static void VMStolenVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_I32 voic
 
     /* assign current age to this note and increment for the next note */
     pVoice->age = pVoiceMgr->age++;
+#ifdef _STEAL_INDEX
+    VMStealIndexDirty(pVoiceMgr, voiceNum);
+#endif
 }
 
 /*----------------------------------------------------------------------------
@@ -1326,7 +1468,11 @@ static void VMFreeVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE
     /* return to free voice pool */
     pVoiceMgr->activeVoices--;
     pSynth->numActiveVoices--;
+    VMClearVoiceChannel(pVoiceMgr, pVoice - pVoiceMgr->voices);
     InitVoice(pVoice);
+#ifdef _STEAL_INDEX
+    VMStealIndexDirty(pVoiceMgr, pVoice - pVoiceMgr->voices);
+#endif
 
 #ifdef _DEBUG_VM
     { /* dpp: EAS_ReportEx(_EAS_SEVERITY_INFO, "VMFreeVoice: free voice %d\n", pVoice - pVoiceMgr->voices); */ }
@@ -1391,6 +1537,8 @@ static EAS_BOOL VMRetargetStolenVoice (S_VOICE_MGR *pVoiceMgr, EAS_I32 voiceNum)
     }
 
     /* assign new channel number, and increase channel voice count */
+    VMClearVoiceChannel(pVoiceMgr, voiceNum);
+    pVoiceMgr->channelVoices[pVoice->nextChannel][voiceNum >> 5] |= 1UL << (voiceNum & 31);
     pVoice->channel = pVoice->nextChannel;
     pMIDIChannel = &pNextSynth->channels[pVoice->channel & 15];
 
@@ -1436,15 +1584,20 @@ static EAS_BOOL VMRetargetStolenVoice (S_VOICE_MGR *pVoiceMgr, EAS_I32 voiceNum)
 void VMCheckKeyGroup (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U16 keyGroup, EAS_U8 channel)
 {
     const S_REGION *pRegion;
+    EAS_U8 voiceList[MAX_SYNTH_VOICES];
+    EAS_INT numVoices;
     EAS_INT voiceNum;
+    EAS_INT i;
 
     /* increment frame workload */
     pVoiceMgr->workload += WORKLOAD_AMOUNT_KEY_GROUP;
 
-    /* need to check all voices in case this is a layered sound */
+    /* need to check all voices on the channel in case this is a layered sound */
     channel = VSynthToChannel(pSynth, channel);
-    for (voiceNum = 0; voiceNum < MAX_SYNTH_VOICES; voiceNum++)
+    numVoices = VMGetChannelVoices(pVoiceMgr, channel, EAS_TRUE, voiceList);
+    for (i = 0; i < numVoices; i++)
     {
+        voiceNum = voiceList[i];
         if (pVoiceMgr->voices[voiceNum].voiceState != eVoiceStateStolen)
         {
             /* voice must be on the same channel */
@@ -1679,6 +1832,7 @@ void VMStartVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_
 
         /* save parameters */
         pVoiceMgr->voices[voiceNum].channel = VSynthToChannel(pSynth, channel);
+        pVoiceMgr->channelVoices[pVoice->channel][voiceNum >> 5] |= 1UL << (voiceNum & 31);
         pVoiceMgr->voices[voiceNum].note = note;
         pVoiceMgr->voices[voiceNum].velocity = velocity;
 
@@ -1694,6 +1848,9 @@ void VMStartVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_
         /* start voice on correct synth */
         /*lint -e{522} return not used at this time */
         GetSynthPtr(voiceNum)->pfStartVoice(pVoiceMgr, pSynth, &pVoiceMgr->voices[voiceNum], GetAdjustedVoiceNum(voiceNum), regionIndex);
+#ifdef _STEAL_INDEX
+        VMStealIndexDirty(pVoiceMgr, voiceNum);
+#endif
         return;
     }
 
@@ -1782,6 +1939,40 @@ void VMStartNote (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_U
         adjustedNote = 127;
     }
 
+    /* use the key map to skip regions that cannot match */
+    if (pChannel->channelFlags & CHANNEL_FLAG_KEY_MAP)
+    {
+        if (pChannel->keyMapFirst[adjustedNote] == KEY_MAP_NO_REGION)
+            return;
+
+#if defined(DLS_SYNTHESIZER)
+        /* DLS regions may be layered, check each candidate */
+        if (regionIndex & FLAG_RGN_IDX_DLS_SYNTH)
+        {
+            EAS_U16 lastRegion;
+
+            lastRegion = regionIndex + pChannel->keyMapLast[adjustedNote];
+            for (regionIndex += pChannel->keyMapFirst[adjustedNote]; regionIndex <= lastRegion; regionIndex++)
+            {
+                /*lint -e{740,826} cast OK, we know this is actually a DLS region */
+                const S_DLS_REGION *pDLSRegion = (S_DLS_REGION*) GetRegionPtr(pSynth, regionIndex);
+
+                /* check key against this region's key and velocity range */
+                if (((adjustedNote >= pDLSRegion->wtRegion.region.rangeLow) && (adjustedNote <= pDLSRegion->wtRegion.region.rangeHigh)) &&
+                    ((velocity >= pDLSRegion->velLow) && (velocity <= pDLSRegion->velHigh)))
+                {
+                    VMStartVoice(pVoiceMgr, pSynth, channel, note, velocity, regionIndex);
+                }
+            }
+            return;
+        }
+#endif
+
+        /* EAS voice, the first matching region plays */
+        VMStartVoice(pVoiceMgr, pSynth, channel, note, velocity, regionIndex + pChannel->keyMapFirst[adjustedNote]);
+        return;
+    }
+
 #if defined(DLS_SYNTHESIZER)
     if (regionIndex & FLAG_RGN_IDX_DLS_SYNTH)
     {
@@ -1857,7 +2048,10 @@ void VMStartNote (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_U
 void VMStopNote (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_U8 note, EAS_U8 velocity)
 {
     S_SYNTH_CHANNEL *pChannel;
+    EAS_U8 voiceList[MAX_SYNTH_VOICES];
+    EAS_INT numVoices;
     EAS_INT voiceNum;
+    EAS_INT i;
 
     pChannel = &(pSynth->channels[channel]);
 
@@ -1879,9 +2073,12 @@ void VMStopNote (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_U8
 
     channel = VSynthToChannel(pSynth, channel);
 
-    for (voiceNum=0; voiceNum < MAX_SYNTH_VOICES; voiceNum++)
+    numVoices = VMGetChannelVoices(pVoiceMgr, channel, EAS_TRUE, voiceList);
+    for (i = 0; i < numVoices; i++)
     {
 
+        voiceNum = voiceList[i];
+
         /* stolen notes are handled separately */
         if (eVoiceStateStolen != pVoiceMgr->voices[voiceNum].voiceState)
         {
@@ -1971,42 +2168,129 @@ EAS_RESULT VMFindAvailableVoice (S_VOICE_MGR *pVoiceMgr, EAS_INT *pVoiceNumber,
 }
 
 /*----------------------------------------------------------------------------
- * VMStealVoice()
+ * VMGetStealScore()
  *----------------------------------------------------------------------------
  * Purpose:
- * Steal a voice and return the voice number
+ * Compute the part of the steal priority of an active voice that does not
+ * depend on the new note, higher means better for stealing
  *
- * Stealing algorithm: steal the best choice with minimal work, taking into
- * account SP-Midi channel priorities and polyphony allocation.
+ * Inputs:
+ * pVoice - voice to score
  *
- * In one pass through all the voices, figure out which voice to steal
- * taking into account a number of different factors:
- * Priority of the voice's MIDI channel
- * Number of voices over the polyphony allocation for voice's MIDI channel
- * Amplitude of the voice
- * Note age
- * Key velocity (for voices that haven't been started yet)
- * If any matching notes are found
+ * Outputs:
+ * Returns the steal score
+ *----------------------------------------------------------------------------
+*/
+static EAS_I32 VMGetStealScore (const S_SYNTH_VOICE *pVoice)
+{
+    EAS_I32 score;
+
+    /* if voice is stolen or just started, reduce the likelihood it will be stolen */
+    if (( pVoice->voiceState == eVoiceStateStolen) || (pVoice->voiceFlags & VOICE_FLAG_NO_SAMPLES_SYNTHESIZED_YET))
+        return 128 - pVoice->nextVelocity;
+
+    /* compute the priority of this voice, higher means better for stealing */
+    /* use not age */
+    score = (EAS_I32) pVoice->age << NOTE_AGE_STEAL_WEIGHT;
+
+    /* include note gain -higher gain is lower steal value */
+    /*lint -e{704} use shift for performance */
+    score += ((32768 >> (12 - NOTE_GAIN_STEAL_WEIGHT)) + 256) -
+        ((EAS_I32) pVoice->gain >> (12 - NOTE_GAIN_STEAL_WEIGHT));
+    return score;
+}
+
+/*----------------------------------------------------------------------------
+ * VMGetStealPriority()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Compute the steal priority of an active voice for a new note, higher
+ * means better for stealing
  *
  * Inputs:
- * pnVoiceNumber - really an output, see below
- * nChannel - the channel that this voice wants to be started on
- * nKeyNumber - the key number for this new voice
- * psEASData - pointer to overall EAS data structure
+ * pVoiceMgr - pointer to voice manager
+ * pSynth - synth that wants to start the new note
+ * pCurrVoice - voice to score
+ * channel - the channel that the new note wants to be started on
+ * note - the key number of the new note
  *
  * Outputs:
- * pnVoiceNumber - voice number of the voice that was stolen
- * EAS_RESULT EAS_SUCCESS - always successful
+ * Returns the steal priority, or -1 if the voice belongs to a higher
+ * priority virtual synth and must not be stolen
  *----------------------------------------------------------------------------
 */
-EAS_RESULT VMStealVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_INT *pVoiceNumber, EAS_U8 channel, EAS_U8 note, EAS_I32 lowVoice, EAS_I32 highVoice)
+static EAS_I32 VMGetStealPriority (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pCurrVoice, EAS_U8 channel, EAS_U8 note)
 {
-    S_SYNTH_VOICE *pCurrVoice;
     S_SYNTH *pCurrSynth;
-    EAS_INT voiceNum;
-    EAS_INT bestCandidate;
     EAS_U8 currChannel;
     EAS_U8 currNote;
+    EAS_I32 currentPriority;
+
+    /* for stolen voices, use the new parameters, not the old */
+    if (pCurrVoice->voiceState == eVoiceStateStolen)
+    {
+        pCurrSynth = pVoiceMgr->pSynth[GET_VSYNTH(pCurrVoice->nextChannel)];
+        currChannel = pCurrVoice->nextChannel;
+        currNote = pCurrVoice->nextNote;
+    }
+    else
+    {
+        pCurrSynth = pVoiceMgr->pSynth[GET_VSYNTH(pCurrVoice->channel)];
+        currChannel = pCurrVoice->channel;
+        currNote = pCurrVoice->note;
+    }
+
+    /* ignore voices that are higher priority */
+    if (pSynth->priority > pCurrSynth->priority)
+        return -1;
+#ifdef _DEBUG_VM
+//  { /* dpp: EAS_ReportEx(_EAS_SEVERITY_INFO, "VMStealVoice: New priority = %d exceeds old priority = %d\n", pSynth->priority, pCurrSynth->priority); */ }
+#endif
+
+    /* age, gain and velocity of the voice */
+    currentPriority = VMGetStealScore(pCurrVoice);
+
+    /* in SP-MIDI mode, include over poly allocation and channel priority */
+    if (pSynth->synthFlags & SYNTH_FLAG_SP_MIDI_ON)
+    {
+        S_SYNTH_CHANNEL *pChannel = &pCurrSynth->channels[GET_CHANNEL(currChannel)];
+        /*lint -e{701} use shift for performance */
+        if (pSynth->poolCount[pChannel->pool] >= pSynth->poolAlloc[pChannel->pool])
+            currentPriority += (pSynth->poolCount[pChannel->pool] -pSynth->poolAlloc[pChannel->pool] + 1) << CHANNEL_POLY_STEAL_WEIGHT;
+
+        /* include channel priority */
+        currentPriority += (EAS_I32)(pChannel->pool << CHANNEL_PRIORITY_STEAL_WEIGHT);
+    }
+
+    /* if a note is already playing that matches this note, consider stealing it more readily */
+    if ((note == currNote) && (channel == currChannel))
+        currentPriority += NOTE_MATCH_PENALTY;
+
+    return currentPriority;
+}
+
+/*----------------------------------------------------------------------------
+ * VMScanStealCandidates()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Find the voice to steal for a new note by scoring every voice in the
+ * range. Of the voices with the best score, the highest numbered one wins.
+ *
+ * Inputs:
+ * pVoiceMgr - pointer to voice manager
+ * pSynth - synth that wants to start the new note
+ * channel - the channel that the new note wants to be started on
+ * note - the key number of the new note
+ * lowVoice, highVoice - range of voices that the new note can use
+ *
+ * Outputs:
+ * Returns the voice number, or MAX_SYNTH_VOICES if no voice can be stolen
+ *----------------------------------------------------------------------------
+*/
+static EAS_INT VMScanStealCandidates (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_U8 note, EAS_I32 lowVoice, EAS_I32 highVoice)
+{
+    EAS_INT voiceNum;
+    EAS_INT bestCandidate;
     EAS_I32 bestPriority;
     EAS_I32 currentPriority;
 
@@ -2016,73 +2300,260 @@ EAS_RESULT VMStealVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_INT *pVoic
 
     for (voiceNum = lowVoice; voiceNum <= highVoice; voiceNum++)
     {
-        pCurrVoice = &pVoiceMgr->voices[voiceNum];
-
         /* ignore free voices */
-        if (pCurrVoice->voiceState == eVoiceStateFree)
+        if (pVoiceMgr->voices[voiceNum].voiceState == eVoiceStateFree)
+            continue;
+
+        /* ignore voices that are higher priority */
+        currentPriority = VMGetStealPriority(pVoiceMgr, pSynth, &pVoiceMgr->voices[voiceNum], channel, note);
+        if (currentPriority < 0)
             continue;
 
-        /* for stolen voices, use the new parameters, not the old */
-        if (pCurrVoice->voiceState == eVoiceStateStolen)
+        /* is this the best choice so far? */
+        if (currentPriority >= bestPriority)
         {
-            pCurrSynth = pVoiceMgr->pSynth[GET_VSYNTH(pCurrVoice->nextChannel)];
-            currChannel = pCurrVoice->nextChannel;
-            currNote = pCurrVoice->nextNote;
+            bestPriority = currentPriority;
+            bestCandidate = voiceNum;
         }
-        else
+    }
+    return bestCandidate;
+}
+
+#ifdef _STEAL_INDEX
+/*----------------------------------------------------------------------------
+ * VMStealWinner()
+ *----------------------------------------------------------------------------
+ * Returns the better steal candidate of the two children of a tree node,
+ * the higher numbered voice on equal scores as in VMScanStealCandidates
+ *----------------------------------------------------------------------------
+*/
+static EAS_U8 VMStealWinner (const S_VOICE_MGR *pVoiceMgr, EAS_INT node)
+{
+    EAS_U8 left = pVoiceMgr->stealTree[node << 1];
+    EAS_U8 right = pVoiceMgr->stealTree[(node << 1) + 1];
+
+    if ((pVoiceMgr->stealScore[left] > pVoiceMgr->stealScore[right]) ||
+        ((pVoiceMgr->stealScore[left] == pVoiceMgr->stealScore[right]) && (left > right)))
+        return left;
+    return right;
+}
+
+/*----------------------------------------------------------------------------
+ * VMUpdateStealIndex()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Scores the voices marked by VMStealIndexDirty again and updates the tree
+ * nodes above them. Free voices score -1 so they never win.
+ *
+ * The gain of every active voice changes each frame, so the scores are
+ * only brought up to date when a voice is about to be stolen, at a cost
+ * of O(log n) for each voice that changed since the last steal.
+ *
+ * Inputs:
+ * pVoiceMgr - pointer to voice manager
+ *
+ * Outputs:
+ *----------------------------------------------------------------------------
+*/
+static void VMUpdateStealIndex (S_VOICE_MGR *pVoiceMgr)
+{
+    S_SYNTH_VOICE *pVoice;
+    EAS_INT numDirty;
+    EAS_INT voiceNum;
+    EAS_INT word;
+    EAS_INT node;
+    EAS_U32 bits;
+
+    /* score the stale voices */
+    numDirty = 0;
+    for (word = 0; word < SYNTH_VOICE_MASK_WORDS; word++)
+    {
+        for (voiceNum = word << 5, bits = pVoiceMgr->stealDirty[word]; bits != 0; voiceNum++, bits >>= 1)
         {
-            pCurrSynth = pVoiceMgr->pSynth[GET_VSYNTH(pCurrVoice->channel)];
-            currChannel = pCurrVoice->channel;
-            currNote = pCurrVoice->note;
+            if ((bits & 1) == 0)
+                continue;
+            pVoice = &pVoiceMgr->voices[voiceNum];
+            if (pVoice->voiceState == eVoiceStateFree)
+                pVoiceMgr->stealScore[voiceNum] = -1;
+            else
+                pVoiceMgr->stealScore[voiceNum] = VMGetStealScore(pVoice);
+            numDirty++;
         }
+    }
+    if (numDirty == 0)
+        return;
 
-        /* ignore voices that are higher priority */
-        if (pSynth->priority > pCurrSynth->priority)
-            continue;
-#ifdef _DEBUG_VM
-//      { /* dpp: EAS_ReportEx(_EAS_SEVERITY_INFO, "VMStealVoice: New priority = %d exceeds old priority = %d\n", pSynth->priority, pCurrSynth->priority); */ }
-#endif
+    /* many stale voices, rebuild the whole tree */
+    if (numDirty > STEAL_INDEX_REBUILD_COUNT)
+    {
+        for (node = MAX_SYNTH_VOICES - 1; node > 0; node--)
+            pVoiceMgr->stealTree[node] = VMStealWinner(pVoiceMgr, node);
+    }
 
-        /* if voice is stolen or just started, reduce the likelihood it will be stolen */
-        if (( pCurrVoice->voiceState == eVoiceStateStolen) || (pCurrVoice->voiceFlags & VOICE_FLAG_NO_SAMPLES_SYNTHESIZED_YET))
+    /* otherwise replay the path from each stale voice to the root */
+    else
+    {
+        for (word = 0; word < SYNTH_VOICE_MASK_WORDS; word++)
         {
-            currentPriority = 128 - pCurrVoice->nextVelocity;
+            for (voiceNum = word << 5, bits = pVoiceMgr->stealDirty[word]; bits != 0; voiceNum++, bits >>= 1)
+            {
+                if (bits & 1)
+                {
+                    for (node = (MAX_SYNTH_VOICES + voiceNum) >> 1; node > 0; node >>= 1)
+                        pVoiceMgr->stealTree[node] = VMStealWinner(pVoiceMgr, node);
+                }
+            }
         }
-        else
+    }
+
+    for (word = 0; word < SYNTH_VOICE_MASK_WORDS; word++)
+        pVoiceMgr->stealDirty[word] = 0;
+}
+
+/*----------------------------------------------------------------------------
+ * VMGetStealCandidate()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Find the voice to steal for a new note from the steal tree, with the
+ * same result as VMScanStealCandidates
+ *
+ * The tree holds the score of each voice without the terms that depend on
+ * the new note. The best of the range comes from O(log n) tree nodes, and
+ * the voices on the channel of the new note are scored again in full to add
+ * NOTE_MATCH_PENALTY. SP-MIDI scores and higher priority virtual synths
+ * depend on the synth of the new note, so these fall back to the scan.
+ *
+ * Inputs:
+ * pVoiceMgr - pointer to voice manager
+ * pSynth - synth that wants to start the new note
+ * channel - the channel that the new note wants to be started on
+ * note - the key number of the new note
+ * lowVoice, highVoice - range of voices that the new note can use
+ *
+ * Outputs:
+ * Returns the voice number, or MAX_SYNTH_VOICES if no voice can be stolen
+ *----------------------------------------------------------------------------
+*/
+static EAS_INT VMGetStealCandidate (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, EAS_U8 note, EAS_I32 lowVoice, EAS_I32 highVoice)
+{
+    EAS_U8 voiceList[MAX_SYNTH_VOICES];
+    EAS_INT numVoices;
+    EAS_INT voiceNum;
+    EAS_INT bestCandidate;
+    EAS_INT low;
+    EAS_INT high;
+    EAS_INT i;
+    EAS_I32 bestPriority;
+    EAS_I32 currentPriority;
+
+    if (pSynth->synthFlags & SYNTH_FLAG_SP_MIDI_ON)
+        return VMScanStealCandidates(pVoiceMgr, pSynth, channel, note, lowVoice, highVoice);
+    for (i = 0; i < MAX_VIRTUAL_SYNTHESIZERS; i++)
+    {
+        if ((pVoiceMgr->pSynth[i] != NULL) && (pVoiceMgr->pSynth[i]->priority < pSynth->priority))
+            return VMScanStealCandidates(pVoiceMgr, pSynth, channel, note, lowVoice, highVoice);
+    }
+
+    VMUpdateStealIndex(pVoiceMgr);
+
+    /* best score of the range, free voices score -1 and never win */
+    bestPriority = -1;
+    bestCandidate = MAX_SYNTH_VOICES;
+    for (low = MAX_SYNTH_VOICES + lowVoice, high = MAX_SYNTH_VOICES + highVoice + 1; low < high; low >>= 1, high >>= 1)
+    {
+        if (low & 1)
         {
-            /* compute the priority of this voice, higher means better for stealing */
-            /* use not age */
-            currentPriority = (EAS_I32) pCurrVoice->age << NOTE_AGE_STEAL_WEIGHT;
-
-            /* include note gain -higher gain is lower steal value */
-            /*lint -e{704} use shift for performance */
-            currentPriority += ((32768 >> (12 - NOTE_GAIN_STEAL_WEIGHT)) + 256) -
-                ((EAS_I32) pCurrVoice->gain >> (12 - NOTE_GAIN_STEAL_WEIGHT));
+            voiceNum = pVoiceMgr->stealTree[low++];
+            currentPriority = pVoiceMgr->stealScore[voiceNum];
+            if ((currentPriority > bestPriority) || ((currentPriority == bestPriority) && (voiceNum > bestCandidate)))
+            {
+                bestPriority = currentPriority;
+                bestCandidate = voiceNum;
+            }
         }
-
-        /* in SP-MIDI mode, include over poly allocation and channel priority */
-        if (pSynth->synthFlags & SYNTH_FLAG_SP_MIDI_ON)
+        if (high & 1)
         {
-            S_SYNTH_CHANNEL *pChannel = &pCurrSynth->channels[GET_CHANNEL(currChannel)];
-            /*lint -e{701} use shift for performance */
-            if (pSynth->poolCount[pChannel->pool] >= pSynth->poolAlloc[pChannel->pool])
-                currentPriority += (pSynth->poolCount[pChannel->pool] -pSynth->poolAlloc[pChannel->pool] + 1) << CHANNEL_POLY_STEAL_WEIGHT;
-
-            /* include channel priority */
-            currentPriority += (EAS_I32)(pChannel->pool << CHANNEL_PRIORITY_STEAL_WEIGHT);
+            voiceNum = pVoiceMgr->stealTree[--high];
+            currentPriority = pVoiceMgr->stealScore[voiceNum];
+            if ((currentPriority > bestPriority) || ((currentPriority == bestPriority) && (voiceNum > bestCandidate)))
+            {
+                bestPriority = currentPriority;
+                bestCandidate = voiceNum;
+            }
         }
+    }
 
-        /* if a note is already playing that matches this note, consider stealing it more readily */
-        if ((note == currNote) && (channel == currChannel))
-            currentPriority += NOTE_MATCH_PENALTY;
-
-        /* is this the best choice so far? */
-        if (currentPriority >= bestPriority)
+    /* a voice playing the same note on the same channel scores higher than its leaf */
+    numVoices = VMGetChannelVoices(pVoiceMgr, channel, EAS_TRUE, voiceList);
+    for (i = 0; i < numVoices; i++)
+    {
+        voiceNum = voiceList[i];
+        if ((voiceNum < lowVoice) || (voiceNum > highVoice))
+            continue;
+        currentPriority = VMGetStealPriority(pVoiceMgr, pSynth, &pVoiceMgr->voices[voiceNum], channel, note);
+        if ((currentPriority > bestPriority) || ((currentPriority == bestPriority) && (voiceNum > bestCandidate)))
         {
             bestPriority = currentPriority;
             bestCandidate = voiceNum;
         }
     }
+    return bestCandidate;
+}
+#endif
+
+/*----------------------------------------------------------------------------
+ * VMStealVoice()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Steal a voice and return the voice number
+ *
+ * Stealing algorithm: steal the best choice with minimal work, taking into
+ * account SP-Midi channel priorities and polyphony allocation.
+ *
+ * Figure out which voice to steal, with VMGetStealCandidate when built with
+ * _STEAL_INDEX, or else in one pass through all the voices, taking into
+ * account a number of different factors:
+ * Priority of the voice's MIDI channel
+ * Number of voices over the polyphony allocation for voice's MIDI channel
+ * Amplitude of the voice
+ * Note age
+ * Key velocity (for voices that haven't been started yet)
+ * If any matching notes are found
+ *
+ * Inputs:
+ * pnVoiceNumber - really an output, see below
+ * nChannel - the channel that this voice wants to be started on
+ * nKeyNumber - the key number for this new voice
+ * psEASData - pointer to overall EAS data structure
+ *
+ * Outputs:
+ * pnVoiceNumber - voice number of the voice that was stolen
+ * EAS_RESULT EAS_SUCCESS - always successful
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT VMStealVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_INT *pVoiceNumber, EAS_U8 channel, EAS_U8 note, EAS_I32 lowVoice, EAS_I32 highVoice)
+{
+    EAS_INT bestCandidate;
+#ifdef _STEAL_INDEX_CHECK
+    EAS_INT scanCandidate;
+#endif
+
+    /* determine which voice to steal */
+#ifdef _STEAL_INDEX
+    bestCandidate = VMGetStealCandidate(pVoiceMgr, pSynth, channel, note, lowVoice, highVoice);
+
+#ifdef _STEAL_INDEX_CHECK
+    /* the tree must pick the voice that the scan picks, VMRender fails if not */
+    scanCandidate = VMScanStealCandidates(pVoiceMgr, pSynth, channel, note, lowVoice, highVoice);
+    if (bestCandidate != scanCandidate)
+    {
+        { /* dpp: EAS_ReportEx(_EAS_SEVERITY_ERROR, "VMStealVoice: Steal tree picked voice %d, the scan picks voice %d\n", bestCandidate, scanCandidate); */ }
+        pVoiceMgr->stealMismatch = EAS_TRUE;
+    }
+#endif
+#else
+    bestCandidate = VMScanStealCandidates(pVoiceMgr, pSynth, channel, note, lowVoice, highVoice);
+#endif
 
     /* may happen if all voices are allocated to a higher priority virtual synth */
     if (bestCandidate == MAX_SYNTH_VOICES)
@@ -2137,6 +2608,7 @@ void VMChannelPressure (S_SYNTH *pSynth, EAS_U8 channel, EAS_U8 value)
     for all the voices associated with this channel
     */
     pChannel->channelFlags |= CHANNEL_FLAG_UPDATE_CHANNEL_PARAMETERS;
+    pSynth->dirtyChannels |= (EAS_U16) (1 << channel);
 }
 
 /*----------------------------------------------------------------------------
@@ -2179,6 +2651,7 @@ void VMPitchBend (S_SYNTH *pSynth, EAS_U8 channel, EAS_U8 nPitchLSB, EAS_U8 nPit
     for all the voices associated with this channel
     */
     pChannel->channelFlags |= CHANNEL_FLAG_UPDATE_CHANNEL_PARAMETERS;
+    pSynth->dirtyChannels |= (EAS_U16) (1 << channel);
 }
 
 /*----------------------------------------------------------------------------
@@ -2210,6 +2683,7 @@ void VMControlChange (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, E
     for all the voices associated with this channel
     */
     pChannel->channelFlags |= CHANNEL_FLAG_UPDATE_CHANNEL_PARAMETERS;
+    pSynth->dirtyChannels |= (EAS_U16) (1 << channel);
 
     switch ( controller )
     {
@@ -2530,11 +3004,12 @@ void VMUpdateStaticChannelParameters (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth)
     }
     else
     {
+        EAS_U32 dirty;
 
         /* only update channel params if signalled by a channel flag */
-        for (channel = 0; channel < NUM_SYNTH_CHANNELS; channel++)
+        for (channel = 0, dirty = pSynth->dirtyChannels; dirty != 0; channel++, dirty >>= 1)
         {
-            if ( 0 != (pSynth->channels[channel].channelFlags & CHANNEL_FLAG_UPDATE_CHANNEL_PARAMETERS))
+            if ((dirty & 1) && (pSynth->channels[channel].channelFlags & CHANNEL_FLAG_UPDATE_CHANNEL_PARAMETERS))
             {
 #ifdef _HYBRID_SYNTH
                 if (pSynth->channels[channel].regionIndex & FLAG_RGN_IDX_FM_SYNTH)
@@ -2546,7 +3021,6 @@ void VMUpdateStaticChannelParameters (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth)
 #endif
             }
         }
-
     }
 
     return;
@@ -2612,9 +3086,8 @@ static EAS_RESULT VMFindProgram (const S_EAS *pEAS, EAS_U32 bank, EAS_U8 program
  * VMFindDLSProgram()
  *----------------------------------------------------------------------------
  * Purpose:
- * Look up an individual program in sound library. This function
- * searches the bank list for a program, then the individual program
- * list.
+ * Look up an individual program in a DLS collection using the program
+ * hash table built by the DLS parser.
  *
  * Inputs:
  *
@@ -2625,7 +3098,8 @@ static EAS_RESULT VMFindDLSProgram (const S_DLS *pDLS, EAS_U32 bank, EAS_U8 prog
 {
     EAS_U32 locale;
     const S_PROGRAM *p;
-    EAS_U16 i;
+    EAS_U16 slot;
+    EAS_U16 entry;
 
     /* make sure we have a valid sound library */
     if (pDLS == NULL)
@@ -2634,20 +3108,83 @@ static EAS_RESULT VMFindDLSProgram (const S_DLS *pDLS, EAS_U32 bank, EAS_U8 prog
     /* establish locale */
     locale = (bank << 8) | programNum;
 
-    /* search for program */
-    for (i = 0, p = pDLS->pDLSPrograms; i < pDLS->numDLSPrograms; i++, p++)
+    /* probe the hash table until we find the program or an empty slot */
+    slot = DLS_PROGRAM_HASH(locale) & pDLS->programHashMask;
+    while ((entry = pDLS->pDLSProgramHash[slot]) != 0)
     {
+        p = &pDLS->pDLSPrograms[entry - 1];
         if (p->locale == locale)
         {
             *pRegionIndex = p->regionIndex;
             return EAS_SUCCESS;
         }
+        slot = (slot + 1) & pDLS->programHashMask;
     }
 
     return EAS_FAILURE;
 }
 #endif
 
+/*----------------------------------------------------------------------------
+ * VMBuildKeyMap()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Builds the channel's key map for the current program. For each key,
+ * the map holds the offsets of the first and last region whose key
+ * range includes the key, so VMStartNote only looks at those regions.
+ * Programs with more regions than the map can address are left without
+ * a map and VMStartNote walks the region list.
+ *
+ * Inputs:
+ * pSynth - pointer to synth
+ * pChannel - pointer to channel, regionIndex must be set
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void VMBuildKeyMap (S_SYNTH *pSynth, S_SYNTH_CHANNEL *pChannel)
+{
+    const S_REGION *pRegion;
+    EAS_INT offset;
+    EAS_INT key;
+
+    pChannel->channelFlags &= ~CHANNEL_FLAG_KEY_MAP;
+
+    /* make sure we have a sound library for this region */
+#ifdef DLS_SYNTHESIZER
+    if (pChannel->regionIndex & FLAG_RGN_IDX_DLS_SYNTH)
+    {
+        if (pSynth->pDLS == NULL)
+            return;
+    }
+    else
+#endif
+    if (pSynth->pEAS == NULL)
+        return;
+
+    EAS_HWMemSet(pChannel->keyMapFirst, KEY_MAP_NO_REGION, sizeof(pChannel->keyMapFirst));
+    EAS_HWMemSet(pChannel->keyMapLast, 0, sizeof(pChannel->keyMapLast));
+
+    for (offset = 0; offset < KEY_MAP_NO_REGION; offset++)
+    {
+        pRegion = GetRegionPtr(pSynth, (EAS_U16) (pChannel->regionIndex + offset));
+        for (key = pRegion->rangeLow; (key <= pRegion->rangeHigh) && (key < 128); key++)
+        {
+            if (pChannel->keyMapFirst[key] == KEY_MAP_NO_REGION)
+                pChannel->keyMapFirst[key] = (EAS_U8) offset;
+            pChannel->keyMapLast[key] = (EAS_U8) offset;
+        }
+
+        /* last region in program? */
+        if (pRegion->keyGroupAndFlags & REGION_FLAG_LAST_REGION)
+        {
+            pChannel->channelFlags |= CHANNEL_FLAG_KEY_MAP;
+            return;
+        }
+    }
+}
+
 /*----------------------------------------------------------------------------
  * VMProgramChange()
  *----------------------------------------------------------------------------
@@ -2748,12 +3285,14 @@ void VMProgramChange (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel, E
     /* we have our new program change for this channel */
     pChannel->programNum = program;
     pChannel->regionIndex = regionIndex;
+    VMBuildKeyMap(pSynth, pChannel);
 
     /*
     set a channel flag to request parameter updates
     for all the voices associated with this channel
     */
     pChannel->channelFlags |= CHANNEL_FLAG_UPDATE_CHANNEL_PARAMETERS;
+    pSynth->dirtyChannels |= (EAS_U16) (1 << channel);
 
     return;
 }
@@ -2783,22 +3322,32 @@ EAS_I32 VMAddSamples (S_VOICE_MGR *pVoiceMgr, EAS_I32 *pMixBuffer, EAS_I32 numSa
     EAS_INT voiceNum;
     EAS_BOOL done;
 
-#ifdef  _REVERB
-    EAS_PCM *pReverbSendBuffer;
-#endif  // ifdef    _REVERB
-
-#ifdef  _CHORUS
-    EAS_PCM *pChorusSendBuffer;
-#endif  // ifdef    _CHORUS
-
-    voicesRendered = 0;
+    /* retarget stolen voices */
     for (voiceNum = 0; voiceNum < MAX_SYNTH_VOICES; voiceNum++)
     {
-
-        /* retarget stolen voices */
+#ifdef _FAST_STEAL
+        /* ramp out the old note at the start of this frame, so the new note can start in it */
+        if ((pVoiceMgr->voices[voiceNum].voiceState == eVoiceStateStolen) && (pVoiceMgr->voices[voiceNum].gain > 0))
+        {
+            pSynth = pVoiceMgr->pSynth[pVoiceMgr->voices[voiceNum].channel >> 4];
+            (void) GetSynthPtr(voiceNum)->pfUpdateVoice(pVoiceMgr, pSynth, &pVoiceMgr->voices[voiceNum], GetAdjustedVoiceNum(voiceNum), pMixBuffer, numSamples);
+        }
+#endif
         if ((pVoiceMgr->voices[voiceNum].voiceState == eVoiceStateStolen) && (pVoiceMgr->voices[voiceNum].gain <= 0))
             VMRetargetStolenVoice(pVoiceMgr, voiceNum);
+    }
+
+    /* update the envelopes and LFOs of all voices in one pass */
+    if (pPrimarySynth->pfUpdateControl != NULL)
+        pPrimarySynth->pfUpdateControl(pVoiceMgr);
+#ifdef _HYBRID_SYNTH
+    if (pSecondarySynth->pfUpdateControl != NULL)
+        pSecondarySynth->pfUpdateControl(pVoiceMgr);
+#endif
 
+    voicesRendered = 0;
+    for (voiceNum = 0; voiceNum < MAX_SYNTH_VOICES; voiceNum++)
+    {
         /* get pointer to virtual synth */
         pSynth = pVoiceMgr->pSynth[pVoiceMgr->voices[voiceNum].channel >> 4];
 
@@ -2830,6 +3379,11 @@ EAS_I32 VMAddSamples (S_VOICE_MGR *pVoiceMgr, EAS_I32 *pMixBuffer, EAS_I32 numSa
             /* if voice just started, advance state to play */
             if (pVoiceMgr->voices[voiceNum].voiceState == eVoiceStateStart)
                 pVoiceMgr->voices[voiceNum].voiceState = eVoiceStatePlay;
+
+#ifdef _STEAL_INDEX
+            /* the gain, and the flags of a retargeted or new voice, changed in this frame */
+            VMStealIndexDirty(pVoiceMgr, voiceNum);
+#endif
         }
     }
 
@@ -2857,11 +3411,21 @@ EAS_RESULT VMRender (S_VOICE_MGR *pVoiceMgr, EAS_I32 numSamples, EAS_I32 *pMixBu
     S_SYNTH *pSynth;
     EAS_INT i;
     EAS_INT channel;
+    EAS_U32 dirty;
 
 #ifdef _CHECKED_BUILD
     SanityCheck(pVoiceMgr);
 #endif
 
+#ifdef _STEAL_INDEX_CHECK
+    /* a voice was stolen by a different choice than the scan would make */
+    if (pVoiceMgr->stealMismatch)
+    {
+        pVoiceMgr->stealMismatch = EAS_FALSE;
+        return EAS_ERROR_DATA_INCONSISTENCY;
+    }
+#endif
+
     /* update MIDI channel parameters */
     *pVoicesRendered = 0;
     for (i = 0; i < MAX_VIRTUAL_SYNTHESIZERS; i++)
@@ -2910,8 +3474,12 @@ EAS_RESULT VMRender (S_VOICE_MGR *pVoiceMgr, EAS_I32 numSamples, EAS_I32 *pMixBu
         }
 
         /* clear channel update flags */
-        for (channel = 0; channel < NUM_SYNTH_CHANNELS; channel++)
-            pSynth->channels[channel].channelFlags &= ~CHANNEL_FLAG_UPDATE_CHANNEL_PARAMETERS;
+        for (channel = 0, dirty = pSynth->dirtyChannels; dirty != 0; channel++, dirty >>= 1)
+        {
+            if (dirty & 1)
+                pSynth->channels[channel].channelFlags &= ~CHANNEL_FLAG_UPDATE_CHANNEL_PARAMETERS;
+        }
+        pSynth->dirtyChannels = 0;
 
         }
 
@@ -2979,11 +3547,129 @@ void VMSetWorkload (S_VOICE_MGR *pVoiceMgr, EAS_I32 maxWorkLoad)
 */
 EAS_BOOL VMCheckWorkload (S_VOICE_MGR *pVoiceMgr)
 {
+#ifdef _ADAPTIVE_POLYPHONY
+    /* parse fewer events per frame while over the render budget */
+    if (pVoiceMgr->loadThrottle && (pVoiceMgr->workload >= LOAD_MAX_WORKLOAD))
+        return EAS_TRUE;
+#endif
     if (pVoiceMgr->maxWorkLoad > 0)
         return (EAS_BOOL) (pVoiceMgr->workload >= pVoiceMgr->maxWorkLoad);
     return EAS_FALSE;
 }
 
+#ifdef _ADAPTIVE_POLYPHONY
+/*----------------------------------------------------------------------------
+ * VMSetRenderBudget()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Sets the time allowed to render one frame. 0 turns the render time
+ * controller off and restores the full polyphony.
+ *
+ * Inputs:
+ * pVoiceMgr        - pointer to instance data
+ * budget           - render budget in microseconds per frame
+ *
+ * Outputs:
+ * Returns error code
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+EAS_RESULT VMSetRenderBudget (S_VOICE_MGR *pVoiceMgr, EAS_I32 budget)
+{
+    if (budget < 0)
+        return EAS_ERROR_PARAMETER_RANGE;
+
+    /* the controller never goes above the polyphony it started from */
+    if (pVoiceMgr->renderBudget == 0)
+        pVoiceMgr->loadCeiling = pVoiceMgr->maxPolyphony;
+    else if (budget == 0)
+        pVoiceMgr->maxPolyphony = pVoiceMgr->loadCeiling;
+
+    pVoiceMgr->renderBudget = budget;
+    pVoiceMgr->renderLoad = 0;
+    pVoiceMgr->loadHold = 0;
+    pVoiceMgr->loadThrottle = EAS_FALSE;
+    return EAS_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------
+ * VMUpdateRenderLoad()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Called once per frame with the measured time it took to parse and
+ * render the frame. While the smoothed time is over the budget, the
+ * polyphony limit is lowered in proportion to the overrun and event
+ * parsing is capped at LOAD_MAX_WORKLOAD per frame. Excess voices are
+ * not muted, new notes steal them until the voice count is under the
+ * new limit. Once the load falls below 3/4 of the budget, the polyphony
+ * is raised again one voice at a time. The limit stays between
+ * LOAD_MIN_POLYPHONY and the polyphony in effect when the budget was set.
+ *
+ * Inputs:
+ * pVoiceMgr        - pointer to instance data
+ * frameTime        - time spent on this frame in microseconds
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ * Changes pVoiceMgr->maxPolyphony
+ *
+ *----------------------------------------------------------------------------
+*/
+void VMUpdateRenderLoad (S_VOICE_MGR *pVoiceMgr, EAS_I32 frameTime)
+{
+    EAS_I32 polyphony;
+    EAS_I32 minPolyphony;
+
+    /* controller is off without a budget */
+    if (pVoiceMgr->renderBudget == 0)
+        return;
+
+    /* smooth the measured time so a single slow frame does not drop voices */
+    /*lint -e{704} use shift for performance */
+    pVoiceMgr->renderLoad += (frameTime - pVoiceMgr->renderLoad) >> LOAD_SMOOTHING_SHIFT;
+    pVoiceMgr->loadThrottle = (EAS_BOOL) (pVoiceMgr->renderLoad > pVoiceMgr->renderBudget);
+
+    /* give the last change time to take effect */
+    if (pVoiceMgr->loadHold)
+    {
+        pVoiceMgr->loadHold--;
+        return;
+    }
+
+    minPolyphony = LOAD_MIN_POLYPHONY;
+    if (minPolyphony > pVoiceMgr->loadCeiling)
+        minPolyphony = pVoiceMgr->loadCeiling;
+
+    polyphony = pVoiceMgr->maxPolyphony;
+    if (pVoiceMgr->loadThrottle)
+    {
+        /* render time is roughly proportional to the number of voices */
+        polyphony = (EAS_I32) (((int64_t) polyphony * pVoiceMgr->renderBudget) / pVoiceMgr->renderLoad);
+        if (polyphony < (pVoiceMgr->maxPolyphony >> 1))
+            polyphony = pVoiceMgr->maxPolyphony >> 1;
+        if (polyphony >= pVoiceMgr->maxPolyphony)
+            polyphony = pVoiceMgr->maxPolyphony - 1;
+        if (polyphony < minPolyphony)
+            polyphony = minPolyphony;
+    }
+    else if (pVoiceMgr->renderLoad < pVoiceMgr->renderBudget - (pVoiceMgr->renderBudget >> 2))
+    {
+        if (polyphony < pVoiceMgr->loadCeiling)
+            polyphony++;
+    }
+
+    if (polyphony != pVoiceMgr->maxPolyphony)
+    {
+        { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL, "VMUpdateRenderLoad: load %ld budget %ld polyphony %ld\n", pVoiceMgr->renderLoad, pVoiceMgr->renderBudget, polyphony); */ }
+        pVoiceMgr->maxPolyphony = (EAS_U16) polyphony;
+        pVoiceMgr->loadHold = LOAD_HOLD_FRAMES;
+    }
+}
+#endif
+
 /*----------------------------------------------------------------------------
  * VMActiveVoices()
  *----------------------------------------------------------------------------
@@ -3044,8 +3730,8 @@ EAS_RESULT VMSetPolyphony (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_I32 poly
     pSynth->maxPolyphony = (EAS_U16) polyphonyCount;
 
     /* max polyphony is minimum of virtual synth and actual synth */
-    if (polyphonyCount > pVoiceMgr->maxPolyphony)
-        polyphonyCount = pVoiceMgr->maxPolyphony;
+    if (polyphonyCount > VM_POLYPHONY_CEILING(pVoiceMgr))
+        polyphonyCount = VM_POLYPHONY_CEILING(pVoiceMgr);
 
     /* if SP-MIDI mode, update the channel muting */
     if (pSynth->synthFlags & SYNTH_FLAG_SP_MIDI_ON)
@@ -3243,6 +3929,29 @@ EAS_RESULT VMValidateEASLib (EAS_SNDLIB_HANDLE pEAS)
     return EAS_SUCCESS;
 }
 
+/*----------------------------------------------------------------------------
+ * VMInvalidateKeyMaps()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * The channel key maps describe the regions of the library that was in
+ * use at the last program change. Drop them when a library changes, the
+ * next program change builds them again.
+ *
+ * Inputs:
+ * pSynth - pointer to synth
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void VMInvalidateKeyMaps (S_SYNTH *pSynth)
+{
+    EAS_INT i;
+
+    for (i = 0; i < NUM_SYNTH_CHANNELS; i++)
+        pSynth->channels[i].channelFlags &= ~CHANNEL_FLAG_KEY_MAP;
+}
+
 /*----------------------------------------------------------------------------
  * VMSetEASLib()
  *----------------------------------------------------------------------------
@@ -3268,6 +3977,7 @@ EAS_RESULT VMSetEASLib (S_SYNTH *pSynth, EAS_SNDLIB_HANDLE pEAS)
         return result;
 
     pSynth->pEAS = pEAS;
+    VMInvalidateKeyMaps(pSynth);
     return EAS_SUCCESS;
 }
 
@@ -3291,6 +4001,7 @@ EAS_RESULT VMSetEASLib (S_SYNTH *pSynth, EAS_SNDLIB_HANDLE pEAS)
 EAS_RESULT VMSetDLSLib (S_SYNTH *pSynth, EAS_DLSLIB_HANDLE pDLS)
 {
     pSynth->pDLS = pDLS;
+    VMInvalidateKeyMaps(pSynth);
     return EAS_SUCCESS;
 }
 #endif
@@ -3404,6 +4115,39 @@ void VMShutdown (S_EAS_DATA *pEASData)
     pEASData->pVoiceMgr = NULL;
 }
 
+#ifdef _INSTANCE_POOL
+/*----------------------------------------------------------------------------
+ * VMRestore()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Restores the voice manager to a pristine state saved right after
+ * VMInitialize. This is a single block copy, much cheaper than
+ * VMShutdown followed by VMInitialize.
+ *
+ * Inputs:
+ * psEASData - pointer to overall EAS data structure
+ * pTemplate - copy of the voice manager taken after VMInitialize
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+void VMRestore (S_EAS_DATA *pEASData, const S_VOICE_MGR *pTemplate)
+{
+
+#ifdef DLS_SYNTHESIZER
+    /* if we have a global DLS collection, clean it up */
+    if (pEASData->pVoiceMgr->pGlobalDLS)
+    {
+        DLSCleanup(pEASData->hwInstData, pEASData->pVoiceMgr->pGlobalDLS);
+        pEASData->pVoiceMgr->pGlobalDLS = NULL;
+    }
+#endif
+
+    EAS_HWMemCpy(pEASData->pVoiceMgr, pTemplate, sizeof(S_VOICE_MGR));
+}
+#endif
+
 #ifdef EXTERNAL_AUDIO
 /*----------------------------------------------------------------------------
  * EAS_RegExtAudioCallback()
@@ -3436,7 +4180,7 @@ void VMGetMIDIControllers (S_SYNTH *pSynth, EAS_U8 channel, S_MIDI_CONTROLLERS *
     pControl->reverbSend = pSynth->channels[channel].reverbSend;
 #endif
 
-#ifdef _CHORUSE
+#ifdef _CHORUS
     pControl->chorusSend = pSynth->channels[channel].chorusSend;
 #endif
 }
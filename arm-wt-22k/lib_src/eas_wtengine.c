@@ -42,6 +42,11 @@
 #include "eas_wtengine.h"
 #include "eas_mixer.h"
 
+#if (defined(_REVERB) || defined(_CHORUS)) && ((NUM_OUTPUT_CHANNELS != 2) || defined(UNIFIED_MIXER) || \
+    (defined(NATIVE_EAS_KERNEL) && !defined(_16_BIT_SAMPLES)))
+#error "The effect send buses require stereo output and the C gain stage"
+#endif
+
 /*----------------------------------------------------------------------------
  * prototypes
  *----------------------------------------------------------------------------
@@ -60,6 +65,33 @@ extern void WT_Interpolate (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame);
 extern void WT_VoiceFilter (S_FILTER_CONTROL*pFilter, S_WT_INT_FRAME *pWTIntFrame);
 #endif
 
+#ifdef _ADPCM_SAMPLES
+extern void WT_InterpolateADPCM (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame);
+
+/*----------------------------------------------------------------------------
+ * IMA ADPCM tables
+ *----------------------------------------------------------------------------
+*/
+const EAS_I16 wtADPCMStepSize[ADPCM_MAX_STEP_INDEX + 1] =
+{
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+const EAS_I8 wtADPCMIndexAdjust[16] =
+{
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+#endif
+
 // The PRNG in WT_NoiseGenerator relies on modulo math
 #undef  NO_INT_OVERFLOW_CHECKS
 #define NO_INT_OVERFLOW_CHECKS __attribute__((no_sanitize("integer")))
@@ -77,6 +109,101 @@ extern void WT_VoiceFilter (S_FILTER_CONTROL*pFilter, S_WT_INT_FRAME *pWTIntFram
  *
  *----------------------------------------------------------------------------
 */
+#if defined(_REVERB) || defined(_CHORUS)
+/*----------------------------------------------------------------------------
+ * WT_VoiceGainSend
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Output gain for a voice with a reverb or chorus send. Mixes the voice
+ * into the final mix buffer exactly as WT_VoiceGain does and accumulates
+ * the same panned samples, scaled by each non-zero send level, into the
+ * send buses.
+ *
+ * Inputs:
+ * numSamples       - number of samples, already range checked
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+static void WT_VoiceGainSend (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame, EAS_I32 numSamples)
+{
+    EAS_I32 *pMixBuffer;
+    EAS_PCM *pInputBuffer;
+    EAS_I32 gain;
+    EAS_I32 gainIncrement;
+    EAS_I32 gainLeft, gainRight;
+    EAS_I32 tmp0;
+#ifdef _REVERB
+    EAS_I32 *pReverbBuffer;
+    EAS_I32 reverbLeft, reverbRight;
+#endif
+#ifdef _CHORUS
+    EAS_I32 *pChorusBuffer;
+    EAS_I32 chorusLeft, chorusRight;
+#endif
+
+    pMixBuffer = pWTIntFrame->pMixBuffer;
+    pInputBuffer = pWTIntFrame->pAudioBuffer;
+
+    gainIncrement = (pWTIntFrame->frame.gainTarget - pWTIntFrame->prevGain) * (1 << (16 - SYNTH_UPDATE_PERIOD_IN_BITS));
+    if (gainIncrement < 0)
+        gainIncrement++;
+    gain = pWTIntFrame->prevGain * (1 << 16);
+
+    gainLeft = pWTVoice->gainLeft;
+    gainRight = pWTVoice->gainRight;
+
+    /* a bus with no send is skipped rather than fed zeros */
+#ifdef _REVERB
+    pReverbBuffer = (pWTIntFrame->reverbSend != 0) ? pWTIntFrame->pReverbSend : NULL;
+    /*lint -e{704} <avoid divide>*/
+    reverbLeft = (gainLeft * pWTIntFrame->reverbSend) >> 15;
+    /*lint -e{704} <avoid divide>*/
+    reverbRight = (gainRight * pWTIntFrame->reverbSend) >> 15;
+#endif
+#ifdef _CHORUS
+    pChorusBuffer = (pWTIntFrame->chorusSend != 0) ? pWTIntFrame->pChorusSend : NULL;
+    /*lint -e{704} <avoid divide>*/
+    chorusLeft = (gainLeft * pWTIntFrame->chorusSend) >> 15;
+    /*lint -e{704} <avoid divide>*/
+    chorusRight = (gainRight * pWTIntFrame->chorusSend) >> 15;
+#endif
+
+    while (numSamples--) {
+
+        /* incremental gain step to prevent zipper noise */
+        gain += gainIncrement;
+        /*lint -e{704} <avoid divide>*/
+        tmp0 = ((gain >> 16) * *pInputBuffer++) >> 14;
+
+        /*lint -e{704} <avoid divide>*/
+        *pMixBuffer++ += (tmp0 * gainLeft) >> NUM_MIXER_GUARD_BITS;
+        /*lint -e{704} <avoid divide>*/
+        *pMixBuffer++ += (tmp0 * gainRight) >> NUM_MIXER_GUARD_BITS;
+
+#ifdef _REVERB
+        if (pReverbBuffer != NULL)
+        {
+            /*lint -e{704} <avoid divide>*/
+            *pReverbBuffer++ += (tmp0 * reverbLeft) >> NUM_MIXER_GUARD_BITS;
+            /*lint -e{704} <avoid divide>*/
+            *pReverbBuffer++ += (tmp0 * reverbRight) >> NUM_MIXER_GUARD_BITS;
+        }
+#endif
+#ifdef _CHORUS
+        if (pChorusBuffer != NULL)
+        {
+            /*lint -e{704} <avoid divide>*/
+            *pChorusBuffer++ += (tmp0 * chorusLeft) >> NUM_MIXER_GUARD_BITS;
+            /*lint -e{704} <avoid divide>*/
+            *pChorusBuffer++ += (tmp0 * chorusRight) >> NUM_MIXER_GUARD_BITS;
+        }
+#endif
+    }
+}
+#endif
+
 /*lint -esym(715, pWTVoice) reserved for future use */
 void WT_VoiceGain (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
 {
@@ -104,6 +231,22 @@ void WT_VoiceGain (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
         android_errorWriteLog(0x534e4554, "317780080");
         numSamples = BUFFER_SIZE_IN_MONO_SAMPLES;
     }
+
+#ifdef _REVERB
+    if (pWTIntFrame->reverbSend != 0)
+    {
+        WT_VoiceGainSend(pWTVoice, pWTIntFrame, numSamples);
+        return;
+    }
+#endif
+#ifdef _CHORUS
+    if (pWTIntFrame->chorusSend != 0)
+    {
+        WT_VoiceGainSend(pWTVoice, pWTIntFrame, numSamples);
+        return;
+    }
+#endif
+
     pMixBuffer = pWTIntFrame->pMixBuffer;
     pInputBuffer = pWTIntFrame->pAudioBuffer;
 
@@ -378,6 +521,144 @@ void WT_InterpolateNoLoop (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
 }
 #endif
 
+#ifdef _ADPCM_SAMPLES
+/*----------------------------------------------------------------------------
+ * WT_NextADPCMSample
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Decodes the next sample from the voice's ADPCM stream. Codes are packed
+ * two per byte, low nibble first.
+ *----------------------------------------------------------------------------
+*/
+static EAS_I32 WT_NextADPCMSample (S_WT_VOICE *pWTVoice, EAS_I32 *pPredictor, EAS_I32 *pStepIndex)
+{
+    EAS_I32 code;
+
+    if (pWTVoice->flags & WT_FLAGS_ADPCM_NIBBLE)
+    {
+        /*lint -e{702} <avoid divide>*/
+        code = *pWTVoice->pADPCMData++ >> 4;
+        pWTVoice->flags &= ~WT_FLAGS_ADPCM_NIBBLE;
+    }
+    else
+    {
+        code = *pWTVoice->pADPCMData & 0x0f;
+        pWTVoice->flags |= WT_FLAGS_ADPCM_NIBBLE;
+    }
+    return WT_DecodeADPCM(code, pPredictor, pStepIndex);
+}
+
+/*----------------------------------------------------------------------------
+ * WT_InterpolateADPCM
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Interpolation engine for unlooped ADPCM encoded samples
+ *
+ * Inputs:
+ *
+ * Outputs:
+ *
+ * Notes:
+ * The ADPCM stream can only be decoded in order, so the voice carries the
+ * decoder state and the two samples bracketing the current phase. The
+ * phaseAccum and loopEnd values count decoded 16-bit samples, exactly as
+ * for PCM data, so WT_CheckSampleEnd does not need to know about ADPCM.
+ * Each output sample costs one decode per input sample consumed.
+ *----------------------------------------------------------------------------
+*/
+void WT_InterpolateADPCM (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
+{
+    EAS_PCM *pOutputBuffer;
+    EAS_I32 phaseInc;
+    EAS_I32 phaseFrac;
+    EAS_I32 acc0;
+    EAS_U32 phaseAccum;
+    EAS_I32 samp1;
+    EAS_I32 samp2;
+    EAS_I32 predictor;
+    EAS_I32 stepIndex;
+    EAS_I32 numSamples;
+
+    /* initialize some local variables */
+    numSamples = pWTIntFrame->numSamples;
+    if (numSamples <= 0) {
+        ALOGE("b/26366256");
+        android_errorWriteLog(0x534e4554, "26366256");
+        return;
+    } else if (numSamples > BUFFER_SIZE_IN_MONO_SAMPLES) {
+        ALOGE("b/317780080 clip numSamples %ld -> %d", numSamples, BUFFER_SIZE_IN_MONO_SAMPLES);
+        android_errorWriteLog(0x534e4554, "317780080");
+        numSamples = BUFFER_SIZE_IN_MONO_SAMPLES;
+    }
+    pOutputBuffer = pWTIntFrame->pAudioBuffer;
+
+    phaseInc = pWTIntFrame->frame.phaseIncrement;
+    phaseAccum = pWTVoice->phaseAccum;
+    phaseFrac = (EAS_I32)(pWTVoice->phaseFrac & PHASE_FRAC_MASK);
+    predictor = pWTVoice->adpcmPredictor;
+    stepIndex = pWTVoice->adpcmStepIndex;
+
+    /* first call for this voice, decode the first two samples */
+    if ((pWTVoice->flags & WT_FLAGS_ADPCM_READY) == 0)
+    {
+        predictor = stepIndex = 0;
+        pWTVoice->adpcmSample = (EAS_I16) WT_NextADPCMSample(pWTVoice, &predictor, &stepIndex);
+        (void) WT_NextADPCMSample(pWTVoice, &predictor, &stepIndex);
+        pWTVoice->flags |= WT_FLAGS_ADPCM_READY;
+    }
+    samp1 = pWTVoice->adpcmSample;
+    samp2 = predictor;
+
+    while (numSamples--) {
+
+        EAS_I32 nextSamplePhaseInc;
+
+        /* linear interpolation */
+        acc0 = samp2 - samp1;
+        acc0 = acc0 * phaseFrac;
+        /*lint -e{704} <avoid divide>*/
+        acc0 = samp1 + (acc0 >> NUM_PHASE_FRAC_BITS);
+
+        /* save new output sample in buffer */
+        /*lint -e{704} <avoid divide>*/
+        *pOutputBuffer++ = (EAS_I16)(acc0 >> 2);
+
+        /* increment phase */
+        phaseFrac += phaseInc;
+        /*lint -e{704} <avoid divide>*/
+        nextSamplePhaseInc = phaseFrac >> NUM_PHASE_FRAC_BITS;
+
+        /* next sample */
+        if (nextSamplePhaseInc > 0) {
+
+            /* check for loop end */
+            if (phaseAccum + (EAS_U32) ((nextSamplePhaseInc + 1) << 1) >= pWTVoice->loopEnd + sizeof(EAS_SAMPLE)) {
+                break;
+            }
+
+            /* advance sample pointer */
+            /*lint -e{703} <avoid multiply>*/
+            phaseAccum += (EAS_U32) (nextSamplePhaseInc << 1);
+            phaseFrac = (EAS_I32)((EAS_U32)phaseFrac & PHASE_FRAC_MASK);
+
+            /* decode up to the new pair of samples */
+            while (nextSamplePhaseInc--)
+            {
+                samp1 = samp2;
+                samp2 = WT_NextADPCMSample(pWTVoice, &predictor, &stepIndex);
+            }
+        }
+    }
+
+    /* save pointer, phase, and decoder state */
+    pWTVoice->phaseAccum = phaseAccum;
+    pWTVoice->phaseFrac = (EAS_U32) phaseFrac;
+    pWTVoice->adpcmSample = (EAS_I16) samp1;
+    pWTVoice->adpcmPredictor = (EAS_I16) predictor;
+    pWTVoice->adpcmStepIndex = (EAS_U8) stepIndex;
+}
+#endif
+
 #if defined(_FILTER_ENABLED) && !defined(NATIVE_EAS_KERNEL)
 /*----------------------------------------------------------------------------
  * WT_VoiceFilter
@@ -514,6 +795,49 @@ void WT_VoiceFilter (S_FILTER_CONTROL *pFilter, S_WT_INT_FRAME *pWTIntFrame)
     }
 }
 
+/*----------------------------------------------------------------------------
+ * WT_AdvanceLoopPhase
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Moves the phase of a looped voice to where WT_Interpolate would leave
+ * it after numSamples samples, without generating any output. Used for
+ * voices that are silent for the whole frame.
+ *
+ * Inputs:
+ * pWTVoice         - looped voice, not the noise generator
+ * pWTIntFrame      - frame parameters for the voice
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+void WT_AdvanceLoopPhase (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
+{
+    const EAS_SAMPLE *pSamples;
+    const EAS_SAMPLE *loopEnd;
+    EAS_I32 loopLength;
+    EAS_I32 phaseFrac;
+
+    if (pWTIntFrame->numSamples <= 0)
+        return;
+
+    /* the per sample phase steps add up to one step over the whole frame */
+    phaseFrac = (EAS_I32) (pWTVoice->phaseFrac & PHASE_FRAC_MASK) +
+        pWTIntFrame->frame.phaseIncrement * pWTIntFrame->numSamples;
+    pSamples = (const EAS_SAMPLE*) pWTVoice->phaseAccum + (phaseFrac >> NUM_PHASE_FRAC_BITS);
+
+    /* wrap back into the loop, the same as WT_Interpolate does one loop length at a time */
+    loopEnd = (const EAS_SAMPLE*) pWTVoice->loopEnd + 1;
+    if (&pSamples[1] >= loopEnd)
+    {
+        loopLength = loopEnd - (const EAS_SAMPLE*) pWTVoice->loopStart;
+        pSamples -= ((&pSamples[1] - loopEnd) / loopLength + 1) * loopLength;
+    }
+
+    pWTVoice->phaseAccum = (EAS_U32) pSamples;
+    pWTVoice->phaseFrac = (EAS_U32) (phaseFrac & PHASE_FRAC_MASK);
+}
+
 #ifndef _OPTIMIZED_MONO
 /*----------------------------------------------------------------------------
  * WT_ProcessVoice
@@ -538,6 +862,12 @@ void WT_ProcessVoice (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
     if (pWTVoice->loopStart == WT_NOISE_GENERATOR)
         WT_NoiseGenerator(pWTVoice, pWTIntFrame);
 
+#ifdef _ADPCM_SAMPLES
+    /* generate interpolated samples from ADPCM data (never looped) */
+    else if (pWTVoice->flags & WT_FLAGS_USE_ADPCM)
+        WT_InterpolateADPCM(pWTVoice, pWTIntFrame);
+#endif
+
     /* generate interpolated samples for looped waves */
     else if (pWTVoice->loopStart != pWTVoice->loopEnd)
         WT_Interpolate(pWTVoice, pWTIntFrame);
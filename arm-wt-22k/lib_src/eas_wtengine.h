@@ -39,6 +39,10 @@
 #error "Incompatible build settings: _OPTIMIZED_MONO can only be used with NUM_OUTPUT_CHANNELS = 1"
 #endif
 
+#if defined(_ADPCM_SAMPLES) && !defined(_16_BIT_SAMPLES)
+#error "Incompatible build settings: _ADPCM_SAMPLES requires _16_BIT_SAMPLES"
+#endif
+
 #include "eas_wt_IPC_frame.h"
 
 /*----------------------------------------------------------------------------
@@ -66,6 +70,14 @@ typedef struct s_wt_int_frame_tag
     EAS_I32         *pMixBuffer;
     EAS_I32         numSamples;
     EAS_I32         prevGain;
+#ifdef _REVERB
+    EAS_I32         *pReverbSend;                   /* reverb send bus */
+    EAS_I32         reverbSend;                     /* send level, 1.15 format, 0 = no send */
+#endif
+#ifdef _CHORUS
+    EAS_I32         *pChorusSend;                   /* chorus send bus */
+    EAS_I32         chorusSend;                     /* send level, 1.15 format, 0 = no send */
+#endif
 } S_WT_INT_FRAME;
 
 #if defined(_FILTER_ENABLED)
@@ -80,21 +92,16 @@ typedef struct s_filter_control_tag
 } S_FILTER_CONTROL;
 #endif
 
-/*------------------------------------
- * S_LFO_CONTROL data structure
- *------------------------------------
-*/
-typedef struct s_lfo_control_tag
-{
-    EAS_I16     lfoValue;           /* LFO current output value */
-    EAS_I16     lfoPhase;           /* LFO current phase */
-} S_LFO_CONTROL;
-
 /* bit definitions for S_WT_VOICE:flags */
 #define WT_FLAGS_ADPCM_NIBBLE           1       /* high/low nibble flag */
 #define WT_FLAGS_ADPCM_READY            2       /* first 2 samples are decoded */
 #define WT_FLAGS_USE_ADPCM              4       /* sample is ADPCM encoded */
 
+#ifdef _ADPCM_SAMPLES
+/* IMA ADPCM step size table range */
+#define ADPCM_MAX_STEP_INDEX            88
+#endif
+
 /* eg1State and eg2State */
 typedef enum {
     eEnvelopeStateInit = 0,
@@ -119,7 +126,8 @@ typedef enum {
 /*----------------------------------------------------------------------------
  * S_WT_VOICE
  *
- * This structure contains state data for the wavetable engine
+ * This structure contains state data for the wavetable engine. The
+ * envelope and LFO state is kept separately in S_WT_CONTROL.
  *----------------------------------------------------------------------------
 */
 typedef struct s_wt_voice_tag
@@ -138,23 +146,78 @@ typedef struct s_wt_voice_tag
     S_FILTER_CONTROL    filter;                 /* low pass filter */
 #endif
 
-    S_LFO_CONTROL       modLFO;                 /* modulator LFO */
+    EAS_U16             artIndex;               /* index to articulation params */
 
-#ifdef DLS_SYNTHESIZER
-    S_LFO_CONTROL       vibLFO;                 /* vibrato LFO */
+#ifdef _ADPCM_SAMPLES
+    /* ADPCM decoder state - phaseAccum and loopEnd count
+     * decoded 16-bit samples, pADPCMData is the real read pointer
+     */
+    const EAS_U8        *pADPCMData;            /* next byte of ADPCM data */
+    EAS_I16             adpcmSample;            /* decoded sample at phaseAccum */
+    EAS_I16             adpcmPredictor;         /* decoded sample at phaseAccum + 1 */
+    EAS_U8              adpcmStepIndex;         /* current index into step size table */
+    EAS_U8              flags;                  /* see WT_FLAGS_xxx */
 #endif
 
-    /* envelope control */
-    EAS_I16             eg1Value;
-    EAS_I16             eg2Value;
-    EAS_I16             eg1Increment;
-    EAS_I16             eg2Increment;
-    EAS_U8              eg1State;
-    EAS_U8              eg2State;
+} S_WT_VOICE;
 
-    EAS_U16             artIndex;               /* index to articulation params */
+#ifdef _ADPCM_SAMPLES
+/*----------------------------------------------------------------------------
+ * IMA ADPCM tables and decoder
+ *----------------------------------------------------------------------------
+*/
+extern const EAS_I16 wtADPCMStepSize[ADPCM_MAX_STEP_INDEX + 1];
+extern const EAS_I8 wtADPCMIndexAdjust[16];
 
-} S_WT_VOICE;
+/*----------------------------------------------------------------------------
+ * WT_DecodeADPCM
+ *----------------------------------------------------------------------------
+ * Decodes one 4-bit IMA ADPCM code and updates the decoder state. The
+ * DLS loader uses this same routine to track the decoder while encoding,
+ * so encoder and decoder stay in lock-step.
+ *----------------------------------------------------------------------------
+*/
+EAS_INLINE EAS_I32 WT_DecodeADPCM (EAS_I32 code, EAS_I32 *pPredictor, EAS_I32 *pStepIndex)
+{
+    EAS_I32 step;
+    EAS_I32 delta;
+    EAS_I32 predictor;
+
+    step = wtADPCMStepSize[*pStepIndex];
+
+    /*lint -e{704} <avoid divide>*/
+    delta = step >> 3;
+    if (code & 4)
+        delta += step;
+    if (code & 2)
+        delta += step >> 1;
+    if (code & 1)
+        delta += step >> 2;
+
+    predictor = *pPredictor;
+    if (code & 8)
+        predictor -= delta;
+    else
+        predictor += delta;
+
+    /* saturate */
+    if (predictor > 32767)
+        predictor = 32767;
+    else if (predictor < -32768)
+        predictor = -32768;
+    *pPredictor = predictor;
+
+    /* adjust step size */
+    step = *pStepIndex + wtADPCMIndexAdjust[code];
+    if (step < 0)
+        step = 0;
+    else if (step > ADPCM_MAX_STEP_INDEX)
+        step = ADPCM_MAX_STEP_INDEX;
+    *pStepIndex = step;
+
+    return predictor;
+}
+#endif
 
 /*----------------------------------------------------------------------------
  * prototypes
@@ -162,6 +225,7 @@ typedef struct s_wt_voice_tag
 */
 EAS_BOOL WT_CheckSampleEnd (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame, EAS_BOOL update);
 void WT_ProcessVoice (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame);
+void WT_AdvanceLoopPhase (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame);
 
 #ifdef EAS_SPLIT_WT_SYNTH
 void WTE_ConfigVoice (EAS_I32 voiceNum, S_WT_CONFIG *pWTConfig, EAS_FRAME_BUFFER_HANDLE pFrameBuffer);
@@ -56,10 +56,12 @@ static void WT_SustainPedal (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VO
 static EAS_RESULT WT_StartVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, EAS_I32 voiceNum, EAS_U16 regionIndex);
 static EAS_BOOL WT_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, EAS_I32 voiceNum, EAS_I32 *pMixBuffer, EAS_I32 numSamples);
 static void WT_UpdateChannel (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 channel);
-static EAS_I32 WT_UpdatePhaseInc (S_WT_VOICE *pWTVoice, const S_ARTICULATION *pArt, S_SYNTH_CHANNEL *pChannel, EAS_I32 pitchCents);
-static EAS_I32 WT_UpdateGain (S_SYNTH_VOICE *pVoice, S_WT_VOICE *pWTVoice, const S_ARTICULATION *pArt, S_SYNTH_CHANNEL *pChannel, EAS_I32 gain);
-static void WT_UpdateEG1 (S_WT_VOICE *pWTVoice, const S_ENVELOPE *pEnv);
-static void WT_UpdateEG2 (S_WT_VOICE *pWTVoice, const S_ENVELOPE *pEnv);
+static void WT_UpdateControl (S_VOICE_MGR *pVoiceMgr);
+static EAS_I32 WT_UpdatePhaseInc (S_WT_CONTROL *pControl, EAS_I32 voiceNum, const S_ARTICULATION *pArt, S_SYNTH_CHANNEL *pChannel, EAS_I32 pitchCents);
+static EAS_I32 WT_UpdateGain (S_SYNTH_VOICE *pVoice, S_WT_CONTROL *pControl, EAS_I32 voiceNum, const S_ARTICULATION *pArt, S_SYNTH_CHANNEL *pChannel, EAS_I32 gain);
+static void WT_UpdateEG1 (S_WT_CONTROL *pControl, EAS_I32 voiceNum, const S_ENVELOPE *pEnv);
+static void WT_UpdateEG2 (S_WT_CONTROL *pControl, EAS_I32 voiceNum, const S_ENVELOPE *pEnv);
+static void WT_UpdateLFOs (S_WT_CONTROL *pControl, const EAS_U8 *pActive);
 
 #ifdef EAS_SPLIT_WT_SYNTH
 extern EAS_BOOL WTE_StartFrame (EAS_FRAME_BUFFER_HANDLE pFrameBuffer);
@@ -67,7 +69,7 @@ extern EAS_BOOL WTE_EndFrame (EAS_FRAME_BUFFER_HANDLE pFrameBuffer, EAS_I32 *pMi
 #endif
 
 #ifdef _FILTER_ENABLED
-static void WT_UpdateFilter (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pIntFrame, const S_ARTICULATION *pArt);
+static void WT_UpdateFilter (S_WT_CONTROL *pControl, EAS_I32 voiceNum, S_WT_INT_FRAME *pIntFrame, const S_ARTICULATION *pArt);
 #endif
 
 #ifdef _STATS
@@ -91,7 +93,8 @@ const S_SYNTH_INTERFACE wtSynth =
     WT_ReleaseVoice,
     WT_MuteVoice,
     WT_SustainPedal,
-    WT_UpdateChannel
+    WT_UpdateChannel,
+    WT_UpdateControl
 };
 
 #ifdef EAS_SPLIT_WT_SYNTH
@@ -123,13 +126,13 @@ static EAS_RESULT WT_Initialize (S_VOICE_MGR *pVoiceMgr)
 
         pVoiceMgr->wtVoices[i].artIndex = DEFAULT_ARTICULATION_INDEX;
 
-        pVoiceMgr->wtVoices[i].eg1State = DEFAULT_EG1_STATE;
-        pVoiceMgr->wtVoices[i].eg1Value = DEFAULT_EG1_VALUE;
-        pVoiceMgr->wtVoices[i].eg1Increment = DEFAULT_EG1_INCREMENT;
+        pVoiceMgr->wtControl.eg1State[i] = DEFAULT_EG1_STATE;
+        pVoiceMgr->wtControl.eg1Value[i] = DEFAULT_EG1_VALUE;
+        pVoiceMgr->wtControl.eg1Increment[i] = DEFAULT_EG1_INCREMENT;
 
-        pVoiceMgr->wtVoices[i].eg2State = DEFAULT_EG2_STATE;
-        pVoiceMgr->wtVoices[i].eg2Value = DEFAULT_EG2_VALUE;
-        pVoiceMgr->wtVoices[i].eg2Increment = DEFAULT_EG2_INCREMENT;
+        pVoiceMgr->wtControl.eg2State[i] = DEFAULT_EG2_STATE;
+        pVoiceMgr->wtControl.eg2Value[i] = DEFAULT_EG2_VALUE;
+        pVoiceMgr->wtControl.eg2Increment[i] = DEFAULT_EG2_INCREMENT;
 
         /* left and right gain values are needed only if stereo output */
 #if (NUM_OUTPUT_CHANNELS == 2)
@@ -181,8 +184,8 @@ static void WT_ReleaseVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VO
     pArticulation = &pSynth->pEAS->pArticulations[pWTVoice->artIndex];
 
     /* release EG1 */
-    pWTVoice->eg1State = eEnvelopeStateRelease;
-    pWTVoice->eg1Increment = pArticulation->eg1.releaseTime;
+    pVoiceMgr->wtControl.eg1State[voiceNum] = eEnvelopeStateRelease;
+    pVoiceMgr->wtControl.eg1Increment[voiceNum] = pArticulation->eg1.releaseTime;
 
     /*
     The spec says we should release EG2, but doing so with the current
@@ -191,8 +194,8 @@ static void WT_ReleaseVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VO
     */
 
     /* release EG2 */
-    pWTVoice->eg2State = eEnvelopeStateRelease;
-    pWTVoice->eg2Increment = pArticulation->eg2.releaseTime;
+    pVoiceMgr->wtControl.eg2State[voiceNum] = eEnvelopeStateRelease;
+    pVoiceMgr->wtControl.eg2Increment[voiceNum] = pArticulation->eg2.releaseTime;
 }
 
 /*----------------------------------------------------------------------------
@@ -227,8 +230,8 @@ static void WT_MuteVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE
         VOICE_FLAG_DEFER_MUTE);
 
     /* set the envelope state */
-    pVoiceMgr->wtVoices[voiceNum].eg1State = eEnvelopeStateMuted;
-    pVoiceMgr->wtVoices[voiceNum].eg2State = eEnvelopeStateMuted;
+    pVoiceMgr->wtControl.eg1State[voiceNum] = eEnvelopeStateMuted;
+    pVoiceMgr->wtControl.eg2State[voiceNum] = eEnvelopeStateMuted;
 }
 
 /*----------------------------------------------------------------------------
@@ -259,12 +262,12 @@ static void WT_SustainPedal (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VO
 
     /* don't catch the voice if below the sustain level */
     pWTVoice = &pVoiceMgr->wtVoices[voiceNum];
-    if (pWTVoice->eg1Value < pSynth->pEAS->pArticulations[pWTVoice->artIndex].eg1.sustainLevel)
+    if (pVoiceMgr->wtControl.eg1Value[voiceNum] < pSynth->pEAS->pArticulations[pWTVoice->artIndex].eg1.sustainLevel)
         return;
 
     /* sustain flag is set, damper pedal is on */
     /* defer releasing this note until the damper pedal is off */
-    pWTVoice->eg1State = eEnvelopeStateDecay;
+    pVoiceMgr->wtControl.eg1State[voiceNum] = eEnvelopeStateDecay;
     pVoice->voiceState = eVoiceStatePlay;
 
     /*
@@ -311,6 +314,7 @@ static void WT_SustainPedal (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VO
 static EAS_RESULT WT_StartVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, EAS_I32 voiceNum, EAS_U16 regionIndex)
 {
     S_WT_VOICE *pWTVoice;
+    S_WT_CONTROL *pControl;
     const S_WT_REGION *pRegion;
     const S_ARTICULATION *pArt;
     S_SYNTH_CHANNEL *pChannel;
@@ -350,16 +354,28 @@ static EAS_RESULT WT_StartVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNT
     pArt = &pSynth->pEAS->pArticulations[pWTVoice->artIndex];
 
     /* MIDI note on puts this voice into attack state */
-    pWTVoice->eg1State = eEnvelopeStateAttack;
-    pWTVoice->eg1Value = 0;
-    pWTVoice->eg1Increment = pArt->eg1.attackTime;
-    pWTVoice->eg2State = eEnvelopeStateAttack;
-    pWTVoice->eg2Value = 0;
-    pWTVoice->eg2Increment = pArt->eg2.attackTime;
+    pControl = &pVoiceMgr->wtControl;
+    pControl->eg1State[voiceNum] = eEnvelopeStateAttack;
+    pControl->eg1Value[voiceNum] = 0;
+    pControl->eg1Increment[voiceNum] = pArt->eg1.attackTime;
+    pControl->eg2State[voiceNum] = eEnvelopeStateAttack;
+    pControl->eg2Value[voiceNum] = 0;
+    pControl->eg2Increment[voiceNum] = pArt->eg2.attackTime;
 
     /* init the LFO */
-    pWTVoice->modLFO.lfoValue = 0;
-    pWTVoice->modLFO.lfoPhase = -pArt->lfoDelay;
+    pControl->modLFOValue[voiceNum] = 0;
+    pControl->modLFOPhase[voiceNum] = -pArt->lfoDelay;
+    pControl->modLFOPhaseInc[voiceNum] = pArt->lfoFreq;
+    pControl->pitchCents[voiceNum] = WT_PITCH_CENTS_NONE;
+    pControl->phaseInc[voiceNum] = 0;
+#ifdef _FILTER_ENABLED
+    pControl->filterCutoff[voiceNum] = WT_FILTER_CUTOFF_NONE;
+#endif
+#ifdef DLS_SYNTHESIZER
+    pControl->vibLFOValue[voiceNum] = 0;
+    pControl->vibLFOPhase[voiceNum] = 0;
+    pControl->vibLFOPhaseInc[voiceNum] = 0;
+#endif
 
     pVoice->gain = 0;
 
@@ -382,6 +398,10 @@ static EAS_RESULT WT_StartVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNT
     pWTVoice->filter.z2 = 0;
 #endif
 
+#ifdef _ADPCM_SAMPLES
+    pWTVoice->flags = 0;
+#endif
+
     /* if this wave is to be generated using noise generator */
     if (pRegion->region.keyGroupAndFlags & REGION_FLAG_USE_WAVE_GENERATOR)
     {
@@ -420,6 +440,15 @@ static EAS_RESULT WT_StartVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNT
             pWTVoice->loopStart = pWTVoice->loopEnd = pWTVoice->phaseAccum + pSynth->pEAS->pSampleLen[pRegion->waveIndex] - 2;
 #endif
         }
+
+#ifdef _ADPCM_SAMPLES
+        /* ADPCM samples are decoded as they are played */
+        if (pRegion->region.keyGroupAndFlags & REGION_FLAG_USE_ADPCM)
+        {
+            pWTVoice->pADPCMData = (const EAS_U8*) pWTVoice->phaseAccum;
+            pWTVoice->flags = WT_FLAGS_USE_ADPCM;
+        }
+#endif
     }
 
 #ifdef EAS_SPLIT_WT_SYNTH
@@ -539,6 +568,7 @@ EAS_BOOL WT_CheckSampleEnd (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame, E
 static EAS_BOOL WT_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH_VOICE *pVoice, EAS_I32 voiceNum, EAS_I32 *pMixBuffer, EAS_I32  numSamples)
 {
     S_WT_VOICE *pWTVoice;
+    S_WT_CONTROL *pControl;
     S_WT_INT_FRAME intFrame;
     S_SYNTH_CHANNEL *pChannel;
     const S_WT_REGION *pWTRegion;
@@ -555,25 +585,21 @@ static EAS_BOOL WT_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH
     pWTRegion = &pSynth->pEAS->pWTRegions[pVoice->regionIndex & REGION_INDEX_MASK];
     pArt = &pSynth->pEAS->pArticulations[pWTVoice->artIndex];
     pChannel = &pSynth->channels[pVoice->channel & 15];
+    pControl = &pVoiceMgr->wtControl;
     intFrame.prevGain = pVoice->gain;
 
-    /* update the envelopes */
-    WT_UpdateEG1(pWTVoice, &pArt->eg1);
-    WT_UpdateEG2(pWTVoice, &pArt->eg2);
-
-    /* update the LFO */
-    WT_UpdateLFO(&pWTVoice->modLFO, pArt->lfoFreq);
+    /* the envelopes and LFOs have already been updated by WT_UpdateControl */
 
 #ifdef _FILTER_ENABLED
     /* calculate filter if library uses filter */
     if (pSynth->pEAS->libAttr & LIB_FORMAT_FILTER_ENABLED)
-        WT_UpdateFilter(pWTVoice, &intFrame, pArt);
+        WT_UpdateFilter(pControl, voiceNum, &intFrame, pArt);
     else
         intFrame.frame.k = 0;
 #endif
 
     /* update the gain */
-    intFrame.frame.gainTarget = WT_UpdateGain(pVoice, pWTVoice, pArt, pChannel, pWTRegion->gain);
+    intFrame.frame.gainTarget = WT_UpdateGain(pVoice, pControl, voiceNum, pArt, pChannel, pWTRegion->gain);
 
     /* calculate base pitch*/
     temp = pChannel->staticPitch + pWTRegion->tuning;
@@ -583,7 +609,7 @@ static EAS_BOOL WT_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH
         temp += pVoice->note * 100;
     else
         temp += (pVoice->note + pSynth->globalTranspose) * 100;
-    intFrame.frame.phaseIncrement = WT_UpdatePhaseInc(pWTVoice, pArt, pChannel, temp);
+    intFrame.frame.phaseIncrement = WT_UpdatePhaseInc(pControl, voiceNum, pArt, pChannel, temp);
     if (pWTVoice->loopStart == WT_NOISE_GENERATOR) {
         temp = 0;
     } else {
@@ -604,6 +630,16 @@ static EAS_BOOL WT_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH
     intFrame.pAudioBuffer = pVoiceMgr->voiceBuffer;
     intFrame.pMixBuffer = pMixBuffer;
     intFrame.numSamples = numSamples;
+#ifdef _REVERB
+    /* CC91 sets the reverb send directly */
+    intFrame.pReverbSend = pVoiceMgr->reverbSendBuffer;
+    intFrame.reverbSend = (EAS_I32) pChannel->reverbSend << 8;
+#endif
+#ifdef _CHORUS
+    /* CC93 sets the chorus send directly */
+    intFrame.pChorusSend = pVoiceMgr->chorusSendBuffer;
+    intFrame.chorusSend = (EAS_I32) pChannel->chorusSend << 8;
+#endif
 
     /* check for end of sample */
     if ((pWTVoice->loopStart != WT_NOISE_GENERATOR) && (pWTVoice->loopStart == pWTVoice->loopEnd))
@@ -626,14 +662,19 @@ static EAS_BOOL WT_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH
     else
         WTE_ProcessVoice(voiceNum - NUM_PRIMARY_VOICES, &intFrame.frame, pVoiceMgr->pFrameBuffer);
 #else
-    WT_ProcessVoice(pWTVoice, &intFrame);
+#ifdef _FAST_STEAL
+    if (pVoice->voiceState == eVoiceStateStolen)
+        WT_RenderStealRamp(pWTVoice, &intFrame);
+    else
+#endif
+    WT_RenderVoice(pWTVoice, &intFrame);
 #endif
 
     /* clear flag */
     pVoice->voiceFlags &= ~VOICE_FLAG_NO_SAMPLES_SYNTHESIZED_YET;
 
     /* if voice has finished, set flag for voice manager */
-    if ((pVoice->voiceState != eVoiceStateStolen) && (pWTVoice->eg1State == eEnvelopeStateMuted))
+    if ((pVoice->voiceState != eVoiceStateStolen) && (pControl->eg1State[voiceNum] == eEnvelopeStateMuted))
         done = EAS_TRUE;
 
     /* if the update interval has elapsed, then force the current gain to the next
@@ -645,6 +686,80 @@ static EAS_BOOL WT_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH
     return done;
 }
 
+/*----------------------------------------------------------------------------
+ * WT_RenderVoice()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Renders a frame for the given voice. Looped voices that are silent for the
+ * whole frame (see WT_SILENT_GAIN) only have their phase advanced.
+ *
+ * Inputs:
+ * pWTVoice         - pointer to the voice engine state
+ * pIntFrame        - frame parameters for the voice
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+void WT_RenderVoice (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pIntFrame)
+{
+    EAS_BOOL silent;
+
+    /* looped voices that are silent for the whole frame only need their phase advanced */
+    silent = (pIntFrame->prevGain >= -WT_SILENT_GAIN) && (pIntFrame->prevGain <= WT_SILENT_GAIN) &&
+        (pIntFrame->frame.gainTarget >= -WT_SILENT_GAIN) && (pIntFrame->frame.gainTarget <= WT_SILENT_GAIN) &&
+        (pWTVoice->loopStart != WT_NOISE_GENERATOR) && (pWTVoice->loopStart != pWTVoice->loopEnd);
+#ifdef _ADPCM_SAMPLES
+    silent = silent && ((pWTVoice->flags & WT_FLAGS_USE_ADPCM) == 0);
+#endif
+#if defined(_FILTER_ENABLED) && (WT_SILENT_GAIN == 0)
+    /* the filter state depends on every input sample */
+    silent = silent && (pIntFrame->frame.k == 0);
+#endif
+    if (silent)
+    {
+#if defined(_FILTER_ENABLED) && (WT_SILENT_GAIN > 0)
+        pWTVoice->filter.z1 = pWTVoice->filter.z2 = 0;
+#endif
+        WT_AdvanceLoopPhase(pWTVoice, pIntFrame);
+        return;
+    }
+
+    WT_ProcessVoice(pWTVoice, pIntFrame);
+}
+
+#ifdef _FAST_STEAL
+/*----------------------------------------------------------------------------
+ * WT_RenderStealRamp()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Renders the old note of a stolen voice, ramping its gain to zero over
+ * the first 2^WT_STEAL_RAMP_BITS samples of the frame. The engine ramps
+ * over a whole frame, so the target is set to the gain the ramp would
+ * reach at the end of the frame if it continued past zero.
+ *
+ * Inputs:
+ * pWTVoice         - pointer to the voice engine state
+ * pIntFrame        - frame parameters for the voice
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ * - the frame's gain target is left at zero
+ *----------------------------------------------------------------------------
+*/
+void WT_RenderStealRamp (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pIntFrame)
+{
+    if (pIntFrame->numSamples > (1 << WT_STEAL_RAMP_BITS))
+        pIntFrame->numSamples = 1 << WT_STEAL_RAMP_BITS;
+    pIntFrame->frame.gainTarget = pIntFrame->prevGain -
+        (pIntFrame->prevGain << (SYNTH_UPDATE_PERIOD_IN_BITS - WT_STEAL_RAMP_BITS));
+    if (pIntFrame->numSamples > 0)
+        WT_ProcessVoice(pWTVoice, pIntFrame);
+    pIntFrame->frame.gainTarget = 0;
+}
+#endif
+
 /*----------------------------------------------------------------------------
  * WT_UpdatePhaseInc()
  *----------------------------------------------------------------------------
@@ -665,7 +780,7 @@ static EAS_BOOL WT_UpdateVoice (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, S_SYNTH
  * set the phase increment for this voice
  *----------------------------------------------------------------------------
 */
-static EAS_I32 WT_UpdatePhaseInc (S_WT_VOICE *pWTVoice, const S_ARTICULATION *pArt, S_SYNTH_CHANNEL *pChannel, EAS_I32 pitchCents)
+static EAS_I32 WT_UpdatePhaseInc (S_WT_CONTROL *pControl, EAS_I32 voiceNum, const S_ARTICULATION *pArt, S_SYNTH_CHANNEL *pChannel, EAS_I32 pitchCents)
 {
     EAS_I32 temp;
 
@@ -678,7 +793,7 @@ static EAS_I32 WT_UpdatePhaseInc (S_WT_VOICE *pWTVoice, const S_ARTICULATION *pA
          ((pChannel->channelPressure) << (NUM_EG1_FRAC_BITS -7)));
 
     /* now multiply the (channel pressure + CC1) pitch values by the LFO value */
-    temp = MULT_EG1_EG1(pWTVoice->modLFO.lfoValue, temp);
+    temp = MULT_EG1_EG1(pControl->modLFOValue[voiceNum], temp);
 
     /*
     add in the LFO pitch due to
@@ -687,11 +802,16 @@ static EAS_I32 WT_UpdatePhaseInc (S_WT_VOICE *pWTVoice, const S_ARTICULATION *pA
     "static" pitch for this voice on this channel
     */
     temp += pitchCents +
-        (MULT_EG1_EG1(pWTVoice->eg2Value, pArt->eg2ToPitch)) +
-        (MULT_EG1_EG1(pWTVoice->modLFO.lfoValue, pArt->lfoToPitch));
+        (MULT_EG1_EG1(pControl->eg2Value[voiceNum], pArt->eg2ToPitch)) +
+        (MULT_EG1_EG1(pControl->modLFOValue[voiceNum], pArt->lfoToPitch));
 
-    /* convert from cents to linear phase increment */
-    return EAS_Calculate2toX(temp);
+    /* convert from cents to linear phase increment if the pitch has changed */
+    if (temp != pControl->pitchCents[voiceNum])
+    {
+        pControl->pitchCents[voiceNum] = temp;
+        pControl->phaseInc[voiceNum] = EAS_Calculate2toX(temp);
+    }
+    return pControl->phaseInc[voiceNum];
 }
 
 /*----------------------------------------------------------------------------
@@ -775,7 +895,7 @@ static void WT_UpdateChannel (S_VOICE_MGR *pVoiceMgr, S_SYNTH *pSynth, EAS_U8 ch
  *
  *----------------------------------------------------------------------------
 */
-static EAS_I32 WT_UpdateGain (S_SYNTH_VOICE *pVoice, S_WT_VOICE *pWTVoice, const S_ARTICULATION *pArt, S_SYNTH_CHANNEL *pChannel, EAS_I32 gain)
+static EAS_I32 WT_UpdateGain (S_SYNTH_VOICE *pVoice, S_WT_CONTROL *pControl, EAS_I32 voiceNum, const S_ARTICULATION *pArt, S_SYNTH_CHANNEL *pChannel, EAS_I32 gain)
 {
     EAS_I32 lfoGain;
     EAS_I32 temp;
@@ -798,7 +918,7 @@ static EAS_I32 WT_UpdateGain (S_SYNTH_VOICE *pVoice, S_WT_VOICE *pWTVoice, const
     temp = MULT_EG1_EG1(temp, pChannel->staticGain);
 
     /* calculate LFO gain using an approximation for 10^x */
-    lfoGain = MULT_EG1_EG1(pWTVoice->modLFO.lfoValue, pArt->lfoToGain);
+    lfoGain = MULT_EG1_EG1(pControl->modLFOValue[voiceNum], pArt->lfoToGain);
     lfoGain = MULT_EG1_EG1(lfoGain, LFO_GAIN_TO_CENTS);
 
     /* convert from a dB-like value to linear gain */
@@ -806,7 +926,7 @@ static EAS_I32 WT_UpdateGain (S_SYNTH_VOICE *pVoice, S_WT_VOICE *pWTVoice, const
     temp = MULT_EG1_EG1(temp, lfoGain);
 
     /* calculate the voice's gain */
-    temp = (EAS_I16)MULT_EG1_EG1(temp, pWTVoice->eg1Value);
+    temp = (EAS_I16)MULT_EG1_EG1(temp, pControl->eg1Value[voiceNum]);
 
     return temp;
 }
@@ -830,14 +950,14 @@ static EAS_I32 WT_UpdateGain (S_SYNTH_VOICE *pVoice, S_WT_VOICE *pWTVoice, const
  * - updates EG1 state value for the given voice
  *----------------------------------------------------------------------------
 */
-static void WT_UpdateEG1 (S_WT_VOICE *pWTVoice, const S_ENVELOPE *pEnv)
+static void WT_UpdateEG1 (S_WT_CONTROL *pControl, EAS_I32 voiceNum, const S_ENVELOPE *pEnv)
 {
     EAS_I32 temp;
 
-    switch (pWTVoice->eg1State)
+    switch (pControl->eg1State[voiceNum])
     {
         case eEnvelopeStateAttack:
-            temp = pWTVoice->eg1Value + pWTVoice->eg1Increment;
+            temp = pControl->eg1Value[voiceNum] + pControl->eg1Increment[voiceNum];
 
             /* check if we have reached peak amplitude */
             if (temp >= SYNTH_FULL_SCALE_EG1_GAIN)
@@ -846,15 +966,15 @@ static void WT_UpdateEG1 (S_WT_VOICE *pWTVoice, const S_ENVELOPE *pEnv)
                 temp = SYNTH_FULL_SCALE_EG1_GAIN;
 
                 /* prepare to move to decay state */
-                pWTVoice->eg1State = eEnvelopeStateDecay;
-                pWTVoice->eg1Increment = pEnv->decayTime;
+                pControl->eg1State[voiceNum] = eEnvelopeStateDecay;
+                pControl->eg1Increment[voiceNum] = pEnv->decayTime;
             }
 
             break;
 
         /* exponential decay */
         case eEnvelopeStateDecay:
-            temp = MULT_EG1_EG1(pWTVoice->eg1Value, pWTVoice->eg1Increment);
+            temp = MULT_EG1_EG1(pControl->eg1Value[voiceNum], pControl->eg1Increment[voiceNum]);
 
             /* check if we have reached sustain level */
             if (temp <= pEnv->sustainLevel)
@@ -864,11 +984,11 @@ static void WT_UpdateEG1 (S_WT_VOICE *pWTVoice, const S_ENVELOPE *pEnv)
 
                 /* if sustain level is zero, skip sustain & release the voice */
                 if (temp > 0)
-                    pWTVoice->eg1State = eEnvelopeStateSustain;
+                    pControl->eg1State[voiceNum] = eEnvelopeStateSustain;
 
                 /* move to sustain state */
                 else
-                    pWTVoice->eg1State = eEnvelopeStateMuted;
+                    pControl->eg1State[voiceNum] = eEnvelopeStateMuted;
             }
 
             break;
@@ -877,13 +997,13 @@ static void WT_UpdateEG1 (S_WT_VOICE *pWTVoice, const S_ENVELOPE *pEnv)
             return;
 
         case eEnvelopeStateRelease:
-            temp = MULT_EG1_EG1(pWTVoice->eg1Value, pWTVoice->eg1Increment);
+            temp = MULT_EG1_EG1(pControl->eg1Value[voiceNum], pControl->eg1Increment[voiceNum]);
 
             /* if we hit zero, this voice isn't contributing any audio */
             if (temp <= 0)
             {
                 temp = 0;
-                pWTVoice->eg1State = eEnvelopeStateMuted;
+                pControl->eg1State[voiceNum] = eEnvelopeStateMuted;
             }
             break;
 
@@ -897,13 +1017,13 @@ static void WT_UpdateEG1 (S_WT_VOICE *pWTVoice, const S_ENVELOPE *pEnv)
             temp = 0;
 #ifdef  _DEBUG_SYNTH
             { /* dpp: EAS_ReportEx(_EAS_SEVERITY_INFO, "WT_UpdateEG1: error, %d is an unrecognized state\n",
-                pWTVoice->eg1State); */ }
+                pControl->eg1State[voiceNum]); */ }
 #endif
             break;
 
     }
 
-    pWTVoice->eg1Value = (EAS_I16) temp;
+    pControl->eg1Value[voiceNum] = (EAS_I16) temp;
 }
 
 /*----------------------------------------------------------------------------
@@ -923,14 +1043,14 @@ static void WT_UpdateEG1 (S_WT_VOICE *pWTVoice, const S_ENVELOPE *pEnv)
  *----------------------------------------------------------------------------
 */
 
-static void WT_UpdateEG2 (S_WT_VOICE *pWTVoice, const S_ENVELOPE *pEnv)
+static void WT_UpdateEG2 (S_WT_CONTROL *pControl, EAS_I32 voiceNum, const S_ENVELOPE *pEnv)
 {
     EAS_I32 temp;
 
-    switch (pWTVoice->eg2State)
+    switch (pControl->eg2State[voiceNum])
     {
         case eEnvelopeStateAttack:
-            temp = pWTVoice->eg2Value + pWTVoice->eg2Increment;
+            temp = pControl->eg2Value[voiceNum] + pControl->eg2Increment[voiceNum];
 
             /* check if we have reached peak amplitude */
             if (temp >= SYNTH_FULL_SCALE_EG1_GAIN)
@@ -939,16 +1059,16 @@ static void WT_UpdateEG2 (S_WT_VOICE *pWTVoice, const S_ENVELOPE *pEnv)
                 temp = SYNTH_FULL_SCALE_EG1_GAIN;
 
                 /* prepare to move to decay state */
-                pWTVoice->eg2State = eEnvelopeStateDecay;
+                pControl->eg2State[voiceNum] = eEnvelopeStateDecay;
 
-                pWTVoice->eg2Increment = pEnv->decayTime;
+                pControl->eg2Increment[voiceNum] = pEnv->decayTime;
             }
 
             break;
 
             /* implement linear pitch decay in cents */
         case eEnvelopeStateDecay:
-            temp = pWTVoice->eg2Value -pWTVoice->eg2Increment;
+            temp = pControl->eg2Value[voiceNum] -pControl->eg2Increment[voiceNum];
 
             /* check if we have reached sustain level */
             if (temp <= pEnv->sustainLevel)
@@ -957,7 +1077,7 @@ static void WT_UpdateEG2 (S_WT_VOICE *pWTVoice, const S_ENVELOPE *pEnv)
                 temp = pEnv->sustainLevel;
 
                 /* prepare to move to sustain state */
-                pWTVoice->eg2State = eEnvelopeStateSustain;
+                pControl->eg2State[voiceNum] = eEnvelopeStateSustain;
             }
             break;
 
@@ -965,12 +1085,12 @@ static void WT_UpdateEG2 (S_WT_VOICE *pWTVoice, const S_ENVELOPE *pEnv)
             return;
 
         case eEnvelopeStateRelease:
-            temp = pWTVoice->eg2Value - pWTVoice->eg2Increment;
+            temp = pControl->eg2Value[voiceNum] - pControl->eg2Increment[voiceNum];
 
             if (temp <= 0)
             {
                 temp = 0;
-                pWTVoice->eg2State = eEnvelopeStateMuted;
+                pControl->eg2State[voiceNum] = eEnvelopeStateMuted;
             }
 
             break;
@@ -985,52 +1105,127 @@ static void WT_UpdateEG2 (S_WT_VOICE *pWTVoice, const S_ENVELOPE *pEnv)
             temp = 0;
 #ifdef  _DEBUG_SYNTH
             { /* dpp: EAS_ReportEx(_EAS_SEVERITY_INFO, "WT_UpdateEG2: error, %d is an unrecognized state\n",
-                pWTVoice->eg2State); */ }
+                pControl->eg2State[voiceNum]); */ }
 #endif
             break;
     }
 
-    pWTVoice->eg2Value = (EAS_I16) temp;
+    pControl->eg2Value[voiceNum] = (EAS_I16) temp;
 }
 
 /*----------------------------------------------------------------------------
- * WT_UpdateLFO ()
+ * WT_UpdateControl ()
  *----------------------------------------------------------------------------
  * Purpose:
- * Calculate the LFO for the given voice
+ * Update the envelopes and LFOs of all active voices for this frame
  *
  * Inputs:
- * pLFO         - ptr to the LFO data
- * phaseInc     - phase increment
+ * pVoiceMgr    - pointer to voice manager
  *
  * Outputs:
  *
  * Side Effects:
- * - updates LFO values for the given voice
+ * - updates the control state in pVoiceMgr->wtControl
+ *
+ * Notes:
+ * This is called once per frame before any voice is rendered. The
+ * envelopes are state machines and are updated per voice, the LFOs are
+ * updated for all voices together in WT_UpdateLFOs.
  *----------------------------------------------------------------------------
 */
-void WT_UpdateLFO (S_LFO_CONTROL *pLFO, EAS_I16 phaseInc)
+static void WT_UpdateControl (S_VOICE_MGR *pVoiceMgr)
 {
+    S_WT_CONTROL *pControl;
+    S_SYNTH_VOICE *pVoice;
+    S_SYNTH *pSynth;
+    const S_ARTICULATION *pArt;
+    EAS_U8 active[NUM_WT_VOICES];
+    EAS_INT i;
 
-    /* To save memory, if m_nPhaseValue is negative, we are in the
-     * delay phase, and m_nPhaseValue represents the time left
-     * in the delay.
-     */
-     if (pLFO->lfoPhase < 0)
-     {
-        pLFO->lfoPhase++;
-        return;
-     }
+    pControl = &pVoiceMgr->wtControl;
+    for (i = 0; i < NUM_WT_VOICES; i++)
+    {
+        pVoice = &pVoiceMgr->voices[i];
+        active[i] = (EAS_U8) (pVoice->voiceState != eVoiceStateFree);
+        if (!active[i])
+            continue;
 
-    /* calculate LFO output from phase value */
-    /*lint -e{701} Use shift for performance */
-    pLFO->lfoValue = (EAS_I16) (pLFO->lfoPhase << 2);
-    /*lint -e{502} <shortcut to turn sawtooth into triangle wave> */
-    if ((pLFO->lfoPhase > 0x1fff) && (pLFO->lfoPhase < 0x6000))
-        pLFO->lfoValue = ~pLFO->lfoValue;
+        pSynth = pVoiceMgr->pSynth[pVoice->channel >> 4];
+
+#ifdef DLS_SYNTHESIZER
+        if (pVoice->regionIndex & FLAG_RGN_IDX_DLS_SYNTH)
+        {
+            DLS_UpdateEnvelopes(pVoiceMgr, pSynth, pVoice, i);
+            continue;
+        }
+#endif
 
-    /* update LFO phase */
-    pLFO->lfoPhase = (pLFO->lfoPhase + phaseInc) & 0x7fff;
+        /* update the envelopes */
+        pArt = &pSynth->pEAS->pArticulations[pVoiceMgr->wtVoices[i].artIndex];
+        WT_UpdateEG1(pControl, i, &pArt->eg1);
+        WT_UpdateEG2(pControl, i, &pArt->eg2);
+    }
+
+    /* update the LFOs */
+    WT_UpdateLFOs(pControl, active);
+}
+
+/*----------------------------------------------------------------------------
+ * WT_UpdateLFOs ()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Calculate the LFOs for all active voices
+ *
+ * Inputs:
+ * pControl     - ptr to the voice control data
+ * pActive      - non-zero for each voice that is active
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ * - updates LFO values for the active voices
+ *
+ * Notes:
+ * The loop is written without branches so the compiler can vectorize it.
+ * To save memory, if the phase is negative, the LFO is in the delay phase
+ * and the phase represents the time left in the delay. The LFO value is
+ * a sawtooth derived from the phase, with the middle half inverted to
+ * turn it into a triangle wave.
+ *----------------------------------------------------------------------------
+*/
+static void WT_UpdateLFOs (S_WT_CONTROL *pControl, const EAS_U8 *pActive)
+{
+    EAS_INT i;
+    EAS_I32 phase;
+    EAS_I32 value;
+
+    for (i = 0; i < NUM_WT_VOICES; i++)
+    {
+        phase = pControl->modLFOPhase[i];
+        /*lint -e{701} Use shift for performance */
+        value = (EAS_I16) (phase << 2);
+        /*lint -e{502} <shortcut to turn sawtooth into triangle wave> */
+        value = ((phase > 0x1fff) && (phase < 0x6000)) ? ~value : value;
+        value = ((phase < 0) || !pActive[i]) ? pControl->modLFOValue[i] : value;
+        phase = (phase < 0) ? phase + 1 : ((phase + pControl->modLFOPhaseInc[i]) & 0x7fff);
+        pControl->modLFOValue[i] = (EAS_I16) value;
+        pControl->modLFOPhase[i] = (EAS_I16) (pActive[i] ? phase : pControl->modLFOPhase[i]);
+    }
+
+#ifdef DLS_SYNTHESIZER
+    for (i = 0; i < NUM_WT_VOICES; i++)
+    {
+        phase = pControl->vibLFOPhase[i];
+        /*lint -e{701} Use shift for performance */
+        value = (EAS_I16) (phase << 2);
+        /*lint -e{502} <shortcut to turn sawtooth into triangle wave> */
+        value = ((phase > 0x1fff) && (phase < 0x6000)) ? ~value : value;
+        value = ((phase < 0) || !pActive[i]) ? pControl->vibLFOValue[i] : value;
+        phase = (phase < 0) ? phase + 1 : ((phase + pControl->vibLFOPhaseInc[i]) & 0x7fff);
+        pControl->vibLFOValue[i] = (EAS_I16) value;
+        pControl->vibLFOPhase[i] = (EAS_I16) (pActive[i] ? phase : pControl->vibLFOPhase[i]);
+    }
+#endif
 }
 
 #ifdef _FILTER_ENABLED
@@ -1050,7 +1245,7 @@ void WT_UpdateLFO (S_LFO_CONTROL *pLFO, EAS_I16 phaseInc)
  * - updates Filter values for the given voice
  *----------------------------------------------------------------------------
 */
-static void WT_UpdateFilter (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pIntFrame, const S_ARTICULATION *pArt)
+static void WT_UpdateFilter (S_WT_CONTROL *pControl, EAS_I32 voiceNum, S_WT_INT_FRAME *pIntFrame, const S_ARTICULATION *pArt)
 {
     EAS_I32 cutoff;
 
@@ -1062,7 +1257,7 @@ static void WT_UpdateFilter (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pIntFrame, co
     }
 
     /* determine the dynamic cutoff frequency */
-    cutoff = MULT_EG1_EG1(pWTVoice->eg2Value, pArt->eg2ToFc);
+    cutoff = MULT_EG1_EG1(pControl->eg2Value[voiceNum], pArt->eg2ToFc);
     cutoff += pArt->filterCutoff;
 
     /* subtract the A5 offset and the sampling frequency */
@@ -1074,7 +1269,7 @@ static void WT_UpdateFilter (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pIntFrame, co
     else if (cutoff < FILTER_CUTOFF_MIN_PITCH_CENTS)
         cutoff = FILTER_CUTOFF_MIN_PITCH_CENTS;
 
-    WT_SetFilterCoeffs(pIntFrame, cutoff, pArt->filterQ);
+    WT_UpdateFilterCoeffs(pControl, voiceNum, pIntFrame, cutoff, pArt->filterQ);
 }
 #endif
 
@@ -1308,3 +1503,45 @@ void WT_SetFilterCoeffs (S_WT_INT_FRAME *pIntFrame, EAS_I32 cutoff, EAS_I32 reso
 }
 #endif
 
+#ifdef _FILTER_ENABLED
+/*----------------------------------------------------------------------------
+ * WT_UpdateFilterCoeffs()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Set the filter coefficients for a voice, only recalculating them when
+ * the clamped cutoff or the resonance differ from the previous frame
+ *
+ * Inputs:
+ * pControl - pointer to the WT voice control data
+ * voiceNum - voice index
+ * pIntFrame - pointer to the voice's frame data
+ * cutoff - clamped cutoff frequency in cents, with A5 subtracted
+ * resonance - filter resonance index
+ *
+ * Outputs:
+ *
+ * Side Effects:
+ * - updates the filter coefficients and the cache for the given voice
+ *----------------------------------------------------------------------------
+*/
+void WT_UpdateFilterCoeffs (S_WT_CONTROL *pControl, EAS_I32 voiceNum, S_WT_INT_FRAME *pIntFrame, EAS_I32 cutoff, EAS_I32 resonance)
+{
+
+    /* reuse the coefficients from the previous frame */
+    if ((cutoff == pControl->filterCutoff[voiceNum]) && (resonance == pControl->filterQ[voiceNum]))
+    {
+        pIntFrame->frame.k = pControl->filterK[voiceNum];
+        pIntFrame->frame.b1 = pControl->filterB1[voiceNum];
+        pIntFrame->frame.b2 = pControl->filterB2[voiceNum];
+        return;
+    }
+
+    WT_SetFilterCoeffs(pIntFrame, cutoff, resonance);
+    pControl->filterCutoff[voiceNum] = (EAS_I16) cutoff;
+    pControl->filterQ[voiceNum] = (EAS_U8) resonance;
+    pControl->filterK[voiceNum] = pIntFrame->frame.k;
+    pControl->filterB1[voiceNum] = pIntFrame->frame.b1;
+    pControl->filterB2[voiceNum] = pIntFrame->frame.b2;
+}
+#endif
+
@@ -54,12 +54,47 @@
 #error "_SAMPLE_RATE_XXXXX must be defined to valid rate"
 #endif
 
-/* function prototypes */
-void WT_UpdateLFO (S_LFO_CONTROL *pLFO, EAS_I16 phaseInc);
+/*
+ * A looped voice whose gain stays within +/-WT_SILENT_GAIN for a whole
+ * frame is not rendered, only its phase is advanced (see WT_RenderVoice).
+ * The default of zero skips only voices that would add nothing to the mix.
+ * A larger value also skips voices that have decayed below audibility, and
+ * clears their filter state, so the output is no longer bit-exact.
+ */
+#ifndef WT_SILENT_GAIN
+#define WT_SILENT_GAIN                  0
+#endif
+
+/*
+ * With _FAST_STEAL, a stolen voice ramps its old note out over the first
+ * 2^WT_STEAL_RAMP_BITS samples of the frame and starts the new note in the
+ * same frame, instead of ramping over a whole frame and starting the new
+ * note on the next one. The ramp must be shorter than a frame.
+ */
+#ifdef _FAST_STEAL
+#ifndef WT_STEAL_RAMP_BITS
+#define WT_STEAL_RAMP_BITS              5
+#endif
+#if (WT_STEAL_RAMP_BITS < 0) || (WT_STEAL_RAMP_BITS >= SYNTH_UPDATE_PERIOD_IN_BITS)
+#error "WT_STEAL_RAMP_BITS must be less than SYNTH_UPDATE_PERIOD_IN_BITS"
+#endif
+#if defined(_FM_SYNTH) || defined(UNIFIED_MIXER) || defined(EAS_SPLIT_WT_SYNTH)
+#error "_FAST_STEAL is only supported by the wavetable synth with the default mixer"
+#endif
+#endif
 
+/* function prototypes */
 #if defined(_FILTER_ENABLED) || defined(DLS_SYNTHESIZER)
 void WT_SetFilterCoeffs (S_WT_INT_FRAME *pIntFrame, EAS_I32 cutoff, EAS_I32 resonance);
 #endif
+#ifdef _FILTER_ENABLED
+struct s_wt_control_tag;
+void WT_UpdateFilterCoeffs (struct s_wt_control_tag *pControl, EAS_I32 voiceNum, S_WT_INT_FRAME *pIntFrame, EAS_I32 cutoff, EAS_I32 resonance);
+#endif
+void WT_RenderVoice (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pIntFrame);
+#ifdef _FAST_STEAL
+void WT_RenderStealRamp (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pIntFrame);
+#endif
 
 #endif
 
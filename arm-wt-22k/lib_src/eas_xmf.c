@@ -69,6 +69,9 @@ static EAS_RESULT XMF_GetData (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData, EAS
 static EAS_RESULT XMF_FindFileContents (EAS_HW_DATA_HANDLE hwInstData, S_XMF_DATA *pXMFData);
 static EAS_RESULT XMF_ReadNode (EAS_HW_DATA_HANDLE hwInstData, S_XMF_DATA *pXMFData, EAS_I32 nodeOffset, EAS_I32 endOffset, EAS_I32 *pLength, EAS_I32 depth);
 static EAS_RESULT XMF_ReadVLQ (EAS_HW_DATA_HANDLE hwInstData, EAS_FILE_HANDLE fileHandle, EAS_U32 *remainingBytes, EAS_I32 *value);
+#ifdef _DLS_LAZY_LOAD
+static EAS_RESULT XMF_LoadPrograms (S_EAS_DATA *pEASData, S_XMF_DATA *pXMFData);
+#endif
 
 
 /*----------------------------------------------------------------------------
@@ -230,7 +233,12 @@ static EAS_RESULT XMF_Prepare (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData)
     pXMFData = (S_XMF_DATA*) pInstData;
     if (pXMFData->dlsOffset != 0)
     {
+#ifdef _DLS_LAZY_LOAD
+        /* the file stays open until the stream is closed, so samples can be read on demand */
+        if ((result = DLSLazyParser(pEASData->hwInstData, pXMFData->fileHandle, pXMFData->dlsOffset, &pXMFData->pDLS)) != EAS_SUCCESS)
+#else
         if ((result = DLSParser(pEASData->hwInstData, pXMFData->fileHandle, pXMFData->dlsOffset, &pXMFData->pDLS)) != EAS_SUCCESS)
+#endif
         {
             { /* dpp: EAS_ReportEx(_EAS_SEVERITY_WARNING, "Error converting XMF DLS data\n"); */ }
             return result;
@@ -251,10 +259,93 @@ static EAS_RESULT XMF_Prepare (S_EAS_DATA *pEASData, EAS_VOID_PTR pInstData)
     {
         DLSAddRef(pXMFData->pDLS);
         VMInitializeAllChannels(pEASData->pVoiceMgr, ((S_SMF_DATA*) pXMFData->pSMFData)->pSynth);
+#ifdef _DLS_LAZY_LOAD
+        /* load the samples now, so that rendering never reads the file */
+        if (pXMFData->pDLS->pDLSWaves != NULL)
+            result = XMF_LoadPrograms(pEASData, pXMFData);
+#endif
     }
     return result;
 }
 
+#ifdef _DLS_LAZY_LOAD
+/*----------------------------------------------------------------------------
+ * XMF_LoadPrograms()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Loads the samples of a lazily loaded DLS collection for the programs the
+ * file uses. The MIDI data is parsed once in locate mode, which selects
+ * programs but starts no notes, and the waves of every program a channel
+ * selects are loaded. The synth and the SMF parser are then put back to
+ * the state they had before, at the start of the file.
+ *
+ * Inputs:
+ * pEASData         - pointer to overall EAS data structure
+ * pXMFData         - pointer to XMF instance data
+ *
+ * Outputs:
+ *
+ *
+ * Side Effects:
+ *
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT XMF_LoadPrograms (S_EAS_DATA *pEASData, S_XMF_DATA *pXMFData)
+{
+    S_SMF_DATA *pSMFData;
+    S_SYNTH *pSynth;
+    S_SYNTH synth;
+    S_METADATA_CB metadata;
+    EAS_U16 regionIndex[NUM_SYNTH_CHANNELS];
+    EAS_U16 tickConv;
+    EAS_U8 flags;
+    EAS_RESULT result;
+    EAS_INT i;
+
+    pSMFData = (S_SMF_DATA*) pXMFData->pSMFData;
+    pSynth = pSMFData->pSynth;
+
+    /* save the state the scan changes, and keep metadata away from the host */
+    EAS_HWMemCpy(&synth, pSynth, sizeof(S_SYNTH));
+    EAS_HWMemCpy(&metadata, &pSMFData->metadata, sizeof(S_METADATA_CB));
+    pSMFData->metadata.callback = NULL;
+    tickConv = pSMFData->tickConv;
+    flags = pSMFData->flags;
+
+    /* load the initial programs */
+    result = EAS_SUCCESS;
+    for (i = 0; (i < NUM_SYNTH_CHANNELS) && (result == EAS_SUCCESS); i++)
+    {
+        regionIndex[i] = pSynth->channels[i].regionIndex;
+        result = DLSLoadProgram(pXMFData->pDLS, regionIndex[i]);
+    }
+
+    /* scan the file, a parse error ends the scan and is left to playback */
+    while ((result == EAS_SUCCESS) && (pSMFData->state < EAS_STATE_STOPPING))
+    {
+        if (SMF_Event(pEASData, pSMFData, eParserModeLocate) != EAS_SUCCESS)
+            break;
+        for (i = 0; (i < NUM_SYNTH_CHANNELS) && (result == EAS_SUCCESS); i++)
+        {
+            if (pSynth->channels[i].regionIndex != regionIndex[i])
+            {
+                regionIndex[i] = pSynth->channels[i].regionIndex;
+                result = DLSLoadProgram(pXMFData->pDLS, regionIndex[i]);
+            }
+        }
+    }
+
+    /* back to the start of the file */
+    EAS_HWMemCpy(pSynth, &synth, sizeof(S_SYNTH));
+    EAS_HWMemCpy(&pSMFData->metadata, &metadata, sizeof(S_METADATA_CB));
+    pSMFData->tickConv = tickConv;
+    pSMFData->flags = flags;
+    if (result != EAS_SUCCESS)
+        return result;
+    return SMF_Reset(pEASData, pSMFData);
+}
+#endif
+
 /*----------------------------------------------------------------------------
  * XMF_Time()
  *----------------------------------------------------------------------------
@@ -242,12 +242,39 @@ EAS_INLINE EAS_INT JET_CloseSegment (EAS_DATA_HANDLE easHandle, EAS_INT queueNum
     if (result != EAS_SUCCESS)
         return result;
 
+    /* finished segments were taken off the queue count by JET_Process */
+    if (easHandle->jetHandle->segQueue[queueNum].state != JET_STATE_FINISHED)
+        easHandle->jetHandle->numQueuedSegments--;
     easHandle->jetHandle->segQueue[queueNum].streamHandle = NULL;
     easHandle->jetHandle->segQueue[queueNum].state = JET_STATE_CLOSED;
-    easHandle->jetHandle->numQueuedSegments--;
     return result;
 }
 
+/*----------------------------------------------------------------------------
+ * JET_CloseFinishedSegments
+ *----------------------------------------------------------------------------
+ * Closes the streams of segments that finished playing. JET_Process runs
+ * inside EAS_Render, so it only marks them; closing frees memory and is
+ * left to the next control call.
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT JET_CloseFinishedSegments (EAS_DATA_HANDLE easHandle)
+{
+    EAS_INT index;
+    EAS_RESULT result;
+
+    for (index = 0; index < SEG_QUEUE_DEPTH; index++)
+    {
+        if (easHandle->jetHandle->segQueue[index].state == JET_STATE_FINISHED)
+        {
+            result = JET_CloseSegment(easHandle, index);
+            if (result != EAS_SUCCESS)
+                return result;
+        }
+    }
+    return EAS_SUCCESS;
+}
+
 /*----------------------------------------------------------------------------
  * JetParseInfoChunk()
  *----------------------------------------------------------------------------
@@ -547,7 +574,7 @@ EAS_PUBLIC EAS_RESULT JET_Status (EAS_DATA_HANDLE easHandle, S_JET_STATUS *pStat
     S_JET_SEGMENT *pSeg;
 
     pSeg = &easHandle->jetHandle->segQueue[easHandle->jetHandle->playSegment];
-    if (pSeg->streamHandle != NULL)
+    if ((pSeg->streamHandle != NULL) && (pSeg->state != JET_STATE_FINISHED))
     {
         pStatus->currentUserID = pSeg->userID;
         pStatus->segmentRepeatCount = pSeg->repeatCount;
@@ -562,7 +589,7 @@ EAS_PUBLIC EAS_RESULT JET_Status (EAS_DATA_HANDLE easHandle, S_JET_STATUS *pStat
     pStatus->numQueuedSegments = easHandle->jetHandle->numQueuedSegments;
     pStatus->currentPlayingSegment = easHandle->jetHandle->playSegment;
     pStatus->currentQueuedSegment = easHandle->jetHandle->queueSegment;
-    if (pSeg->streamHandle != NULL)
+    if ((pSeg->streamHandle != NULL) && (pSeg->state != JET_STATE_FINISHED))
     {
         EAS_RESULT result;
         EAS_I32 location ;
@@ -626,6 +653,11 @@ EAS_PUBLIC EAS_RESULT JET_QueueSegment (EAS_DATA_HANDLE easHandle, EAS_INT segme
     if (libNum >= easHandle->jetHandle->numLibraries)
         return EAS_ERROR_PARAMETER_RANGE;
 
+    /* free the slots of segments that have finished */
+    result = JET_CloseFinishedSegments(easHandle);
+    if (result != EAS_SUCCESS)
+        return result;
+
     /* check to see if queue is full */
     p = &easHandle->jetHandle->segQueue[easHandle->jetHandle->queueSegment];
     if (p->streamHandle != NULL)
@@ -645,13 +677,11 @@ EAS_PUBLIC EAS_RESULT JET_QueueSegment (EAS_DATA_HANDLE easHandle, EAS_INT segme
         return result;
     p->state = JET_STATE_OPEN;
 
-    /* if less than SEG_QUEUE_DEPTH segments queued up, prepare file for playback */
-    if (++easHandle->jetHandle->numQueuedSegments < SEG_QUEUE_DEPTH)
-    {
-        result = JET_PrepareSegment(easHandle, easHandle->jetHandle->queueSegment);
-        if (result != EAS_SUCCESS)
-            return result;
-    }
+    /* prepare file for playback now, so that JET_Process never has to allocate memory */
+    easHandle->jetHandle->numQueuedSegments++;
+    result = JET_PrepareSegment(easHandle, easHandle->jetHandle->queueSegment);
+    if (result != EAS_SUCCESS)
+        return result;
 
     /* create duplicate file handle */
     result = EAS_HWDupHandle(easHandle->hwInstData, easHandle->jetHandle->jetFileHandle, &fileHandle);
@@ -909,7 +939,7 @@ EAS_PUBLIC EAS_RESULT JET_Process (EAS_DATA_HANDLE easHandle)
     for (;;)
     {
         pSeg = &easHandle->jetHandle->segQueue[index];
-        if (pSeg->state != JET_STATE_CLOSED)
+        if ((pSeg->state != JET_STATE_CLOSED) && (pSeg->state != JET_STATE_FINISHED))
         {
 
             /* get playback state */
@@ -955,13 +985,12 @@ EAS_PUBLIC EAS_RESULT JET_Process (EAS_DATA_HANDLE easHandle)
                     }
                     break;
 
-                /* if playback has stopped, close the segment */
+                /* if playback has stopped, the segment is closed by the next control call */
                 case JET_STATE_STOPPING:
                     if (state == EAS_STATE_STOPPED)
                     {
-                        result = JET_CloseSegment(easHandle, index);
-                        if (result != EAS_SUCCESS)
-                            return result;
+                        pSeg->state = JET_STATE_FINISHED;
+                        easHandle->jetHandle->numQueuedSegments--;
                     }
                     break;
 
@@ -122,7 +122,8 @@ typedef enum
     JET_STATE_READY,
     JET_STATE_PLAYING,
     JET_STATE_PAUSED,
-    JET_STATE_STOPPING
+    JET_STATE_STOPPING,
+    JET_STATE_FINISHED      /* stopped, the stream is closed outside EAS_Render */
 } E_JET_SEGMENT_STATE;
 
 /* S_JEG_SEGMENT.flags */
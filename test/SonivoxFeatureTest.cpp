@@ -0,0 +1,744 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Tests for the optional libsonivox features. The test is linked with libsonivox-feature-test
+// and built with the same options, see libsonivox-feature-test-defaults.
+
+#include <gtest/gtest.h>
+
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#include <libsonivox/eas.h>
+#include <libsonivox/eas_chorus.h>
+#include <libsonivox/eas_reverb.h>
+#include <libsonivox/jet.h>
+
+using namespace std;
+
+// The tests build a small mobile XMF file in memory, a DLS collection followed by a
+// format 0 MIDI file, so they run the DLS synthesizer without any resource files.
+static constexpr uint32_t kDlsSampleRate = 22050;
+static constexpr uint32_t kDlsMelodyBank = 0x79 << 8;
+static constexpr uint8_t kDlsNote = 60;  // unity note of every sample, so it plays back at its rate
+
+struct DlsWave {
+    vector<int16_t> samples;
+    uint32_t loopStart;
+    uint32_t loopLength;  // 0 for a one-shot sample
+};
+
+static void put16(vector<uint8_t> &buf, uint16_t value) {
+    buf.push_back(value & 0xff);
+    buf.push_back(value >> 8);
+}
+
+static void put32(vector<uint8_t> &buf, uint32_t value) {
+    put16(buf, value & 0xffff);
+    put16(buf, value >> 16);
+}
+
+static void putId(vector<uint8_t> &buf, const char *id) {
+    buf.insert(buf.end(), id, id + 4);
+}
+
+static void append(vector<uint8_t> &buf, const vector<uint8_t> &data) {
+    buf.insert(buf.end(), data.begin(), data.end());
+}
+
+static vector<uint8_t> riffChunk(const char *id, const vector<uint8_t> &data) {
+    vector<uint8_t> chunk;
+    putId(chunk, id);
+    put32(chunk, data.size());
+    append(chunk, data);
+    if (data.size() & 1) chunk.push_back(0);
+    return chunk;
+}
+
+static vector<uint8_t> riffList(const char *id, const char *type, const vector<uint8_t> &data) {
+    vector<uint8_t> body;
+    putId(body, type);
+    append(body, data);
+    return riffChunk(id, body);
+}
+
+static vector<uint8_t> makeWsmp(const DlsWave &wave) {
+    vector<uint8_t> wsmp;
+    put32(wsmp, 20);  // structure size
+    put16(wsmp, kDlsNote);
+    put16(wsmp, 0);  // fine tune
+    put32(wsmp, 0);  // attenuation
+    put32(wsmp, 0);  // options
+    put32(wsmp, wave.loopLength ? 1 : 0);
+    if (wave.loopLength) {
+        put32(wsmp, 16);  // structure size
+        put32(wsmp, 0);   // forward loop
+        put32(wsmp, wave.loopStart);
+        put32(wsmp, wave.loopLength);
+    }
+    return riffChunk("wsmp", wsmp);
+}
+
+// Builds a DLS collection with one instrument per wave, instrument i is program i in the
+// default melody bank and plays wave i over the whole keyboard.
+static vector<uint8_t> makeDls(const vector<DlsWave> &waves) {
+    vector<uint8_t> instruments;
+    vector<uint8_t> pool;
+    vector<uint8_t> cues;
+    for (uint32_t i = 0; i < waves.size(); i++) {
+        vector<uint8_t> insh;
+        put32(insh, 1);  // regions
+        put32(insh, kDlsMelodyBank);
+        put32(insh, i);  // program
+
+        vector<uint8_t> rgnh;
+        put16(rgnh, 0);  // key range
+        put16(rgnh, 127);
+        put16(rgnh, 0);  // velocity range
+        put16(rgnh, 127);
+        put16(rgnh, 0);  // options
+        put16(rgnh, 0);  // key group
+
+        vector<uint8_t> wlnk;
+        put16(wlnk, 0);  // options
+        put16(wlnk, 0);  // phase group
+        put32(wlnk, 1);  // channel
+        put32(wlnk, i);  // wave
+
+        vector<uint8_t> rgn = riffChunk("rgnh", rgnh);
+        append(rgn, riffChunk("wlnk", wlnk));
+
+        // the parser needs at least one articulation, a centered pan is the default anyway
+        vector<uint8_t> art1;
+        put32(art1, 8);  // structure size
+        put32(art1, 1);  // connections
+        put16(art1, 0);  // CONN_SRC_NONE
+        put16(art1, 0);  // CONN_SRC_NONE
+        put16(art1, 4);  // CONN_DST_PAN
+        put16(art1, 0);  // CONN_TRN_NONE
+        put32(art1, 0);
+
+        vector<uint8_t> ins = riffChunk("insh", insh);
+        append(ins, riffList("LIST", "lrgn", riffList("LIST", "rgn ", rgn)));
+        append(ins, riffList("LIST", "lart", riffChunk("art1", art1)));
+        append(instruments, riffList("LIST", "ins ", ins));
+
+        vector<uint8_t> fmt;
+        put16(fmt, 1);  // WAVE_FORMAT_PCM
+        put16(fmt, 1);  // mono
+        put32(fmt, kDlsSampleRate);
+        put32(fmt, kDlsSampleRate * sizeof(int16_t));
+        put16(fmt, sizeof(int16_t));
+        put16(fmt, 16);
+
+        vector<uint8_t> data;
+        for (int16_t sample : waves[i].samples) put16(data, sample);
+
+        vector<uint8_t> wave = riffChunk("fmt ", fmt);
+        append(wave, makeWsmp(waves[i]));
+        append(wave, riffChunk("data", data));
+        put32(cues, pool.size());
+        append(pool, riffList("LIST", "wave", wave));
+    }
+
+    vector<uint8_t> colh;
+    put32(colh, waves.size());
+
+    vector<uint8_t> ptbl;
+    put32(ptbl, 8);  // structure size
+    put32(ptbl, waves.size());
+    append(ptbl, cues);
+
+    vector<uint8_t> dls = riffChunk("colh", colh);
+    append(dls, riffList("LIST", "lins", instruments));
+    append(dls, riffChunk("ptbl", ptbl));
+    append(dls, riffList("LIST", "wvpl", pool));
+    return riffList("RIFF", "DLS ", dls);
+}
+
+// Builds a format 0 MIDI file from the events of its track, at 192 ticks per quarter note and
+// the default 120 bpm, so 384 ticks per second.
+static vector<uint8_t> makeTrackSmf(vector<uint8_t> track) {
+    track.insert(track.end(), {0x00, 0xff, 0x2f, 0x00});
+
+    vector<uint8_t> smf = {'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 192};
+    putId(smf, "MTrk");
+    smf.insert(smf.end(), {(uint8_t)(track.size() >> 24), (uint8_t)(track.size() >> 16),
+                           (uint8_t)(track.size() >> 8), (uint8_t)track.size()});
+    append(smf, track);
+    return smf;
+}
+
+// Builds a MIDI file that sets up channel 0 and plays kDlsNote on it for half a second.
+static vector<uint8_t> makeSmf(uint8_t program, const vector<pair<uint8_t, uint8_t>> &controllers) {
+    vector<uint8_t> track = {0x00, 0xc0, program};
+    for (const auto &controller : controllers) {
+        track.insert(track.end(), {0x00, 0xb0, controller.first, controller.second});
+    }
+    track.insert(track.end(), {0x00, 0x90, kDlsNote, 0x64});
+    track.insert(track.end(), {0x81, 0x40, 0x80, kDlsNote, 0x40});  // 192 ticks later
+    return makeTrackSmf(track);
+}
+
+// four byte variable length quantity, so node lengths can be written before they are known
+static void putVlq(vector<uint8_t> &buf, uint32_t value) {
+    buf.push_back(0x80 | ((value >> 21) & 0x7f));
+    buf.push_back(0x80 | ((value >> 14) & 0x7f));
+    buf.push_back(0x80 | ((value >> 7) & 0x7f));
+    buf.push_back(value & 0x7f);
+}
+
+static vector<uint8_t> makeXmfNode(uint8_t numItems, uint8_t headerLength,
+                                   const vector<uint8_t> &contents) {
+    vector<uint8_t> node;
+    putVlq(node, headerLength + 1 + contents.size());
+    node.push_back(numItems);
+    node.push_back(headerLength);
+    node.push_back(0);  // no metadata
+    node.resize(headerLength);
+    node.push_back(1);  // inline resource
+    append(node, contents);
+    return node;
+}
+
+static vector<uint8_t> makeXmf(const vector<uint8_t> &dls, const vector<uint8_t> &smf) {
+    // the DLS parser aligns chunks to even file offsets, so the file nodes get one byte of
+    // header padding to put the DLS collection at an even offset
+    vector<uint8_t> items = makeXmfNode(0, 8, dls);
+    append(items, makeXmfNode(0, 8, smf));
+    vector<uint8_t> tree = makeXmfNode(2, 7, items);
+
+    constexpr uint32_t kTreeStart = 21;
+    uint32_t fileLength = kTreeStart + tree.size();
+    vector<uint8_t> xmf = {'X', 'M', 'F', '_', '1', '.', '0', '0'};
+    putVlq(xmf, fileLength);
+    xmf.push_back(0);  // no metadata types table
+    putVlq(xmf, kTreeStart);
+    putVlq(xmf, fileLength - 1);
+    append(xmf, tree);
+    return xmf;
+}
+
+static int memReadAt(void *handle, void *buffer, int offset, int size) {
+    const vector<uint8_t> *data = (const vector<uint8_t> *)handle;
+    if (offset > (int)data->size()) offset = data->size();
+    if (offset + size > (int)data->size()) size = data->size() - offset;
+    copy(data->begin() + offset, data->begin() + offset + size, (uint8_t *)buffer);
+    return size;
+}
+
+static int memGetSize(void *handle) {
+    return ((const vector<uint8_t> *)handle)->size();
+}
+
+struct EffectParam {
+    E_FX_MODULES module;
+    EAS_I32 param;
+    EAS_I32 value;
+};
+
+class SonivoxDlsTest : public ::testing::Test {
+  public:
+    // Plays the XMF file from the start on a new library instance with the given effects
+    // parameters and render budget and returns the first numFrames frames.
+    void render(const vector<uint8_t> &xmf, const vector<EffectParam> &params, EAS_I32 numFrames,
+                vector<EAS_PCM> *pcm, EAS_I32 renderBudget = 0) {
+        EAS_DATA_HANDLE easData = nullptr;
+        EAS_HANDLE stream = nullptr;
+        EAS_FILE easFile;
+        easFile.handle = (void *)&xmf;
+        easFile.readAt = memReadAt;
+        easFile.size = memGetSize;
+
+        const S_EAS_LIB_CONFIG *config = EAS_Config();
+        ASSERT_NE(config, nullptr) << "Failed to configure the library";
+
+        EAS_RESULT result = EAS_Init(&easData);
+        ASSERT_EQ(result, EAS_SUCCESS) << "Failed to initialize synthesizer library";
+
+        if (renderBudget != 0) {
+            result = EAS_SetRenderBudget(easData, renderBudget);
+            ASSERT_EQ(result, EAS_SUCCESS) << "Failed to set the render budget";
+        }
+
+        for (const EffectParam &p : params) {
+            result = EAS_SetParameter(easData, p.module, p.param, p.value);
+            ASSERT_EQ(result, EAS_SUCCESS) << "Failed to set parameter " << p.param
+                                           << " of effects module " << p.module;
+        }
+
+        result = EAS_OpenFile(easData, &easFile, &stream);
+        ASSERT_EQ(result, EAS_SUCCESS) << "Failed to open the XMF file";
+
+        result = EAS_Prepare(easData, stream);
+        ASSERT_EQ(result, EAS_SUCCESS) << "Failed to prepare the XMF file, is the DLS valid?";
+
+        // a call may return no frames when it stops parsing early, like the players do the
+        // next call carries on where it left off
+        pcm->assign(numFrames * config->numChannels, 0);
+        EAS_I32 count;
+        for (EAS_I32 frame = 0; frame < numFrames; frame += count) {
+            vector<EAS_PCM> buffer(config->mixBufferSize * config->numChannels);
+            result = EAS_Render(easData, buffer.data(), config->mixBufferSize, &count);
+            ASSERT_EQ(result, EAS_SUCCESS) << "Failed to render the audio data";
+            ASSERT_TRUE(count == 0 || count == config->mixBufferSize);
+
+            EAS_I32 frames = min(count, numFrames - frame);
+            copy(buffer.begin(), buffer.begin() + frames * config->numChannels,
+                 pcm->begin() + frame * config->numChannels);
+        }
+
+        result = EAS_CloseFile(easData, stream);
+        ASSERT_EQ(result, EAS_SUCCESS) << "Failed to close the XMF file";
+        result = EAS_Shutdown(easData);
+        ASSERT_EQ(result, EAS_SUCCESS) << "Failed to shut down synthesizer library";
+    }
+
+    // Plays a sine on a channel with the effect send controller at 0 and at 127. At 0 the output
+    // must match the render with the effects module bypassed, at 127 it must not.
+    void checkEffectSend(E_FX_MODULES module, EAS_I32 bypassParam, uint8_t sendController);
+};
+
+static double rms(const vector<EAS_PCM> &pcm) {
+    double sum = 0;
+    for (EAS_PCM sample : pcm) sum += (double)sample * sample;
+    return sqrt(sum / pcm.size());
+}
+
+void SonivoxDlsTest::checkEffectSend(E_FX_MODULES module, EAS_I32 bypassParam,
+                                     uint8_t sendController) {
+    static constexpr EAS_I32 kFrames = kDlsSampleRate;
+
+    DlsWave wave = {vector<int16_t>(kDlsSampleRate / 4), 0, 0};
+    for (uint32_t i = 0; i < wave.samples.size(); i++) {
+        wave.samples[i] = (int16_t)(12000 * sin(2 * M_PI * 440 * i / kDlsSampleRate));
+    }
+    vector<uint8_t> dls = makeDls({wave});
+    vector<EffectParam> dry = {{module, bypassParam, EAS_TRUE}};
+    vector<EffectParam> wet = {{module, bypassParam, EAS_FALSE}};
+
+    vector<EAS_PCM> bypassed;
+    ASSERT_NO_FATAL_FAILURE(
+            render(makeXmf(dls, makeSmf(0, {{sendController, 0}})), dry, kFrames, &bypassed));
+    ASSERT_GT(rms(bypassed), 0) << "The DLS instrument did not play";
+
+    vector<EAS_PCM> noSend;
+    ASSERT_NO_FATAL_FAILURE(
+            render(makeXmf(dls, makeSmf(0, {{sendController, 0}})), wet, kFrames, &noSend));
+    ASSERT_TRUE(noSend == bypassed)
+            << "DLS voice with CC" << (int)sendController << " at 0 was sent to the effect";
+
+    vector<EAS_PCM> fullSend;
+    ASSERT_NO_FATAL_FAILURE(
+            render(makeXmf(dls, makeSmf(0, {{sendController, 127}})), wet, kFrames, &fullSend));
+    ASSERT_FALSE(fullSend == bypassed)
+            << "DLS voice with CC" << (int)sendController << " at 127 was not sent to the effect";
+}
+
+TEST_F(SonivoxDlsTest, AdpcmSampleTest) {
+    // Program 0 plays a one-shot sample, which the DLS loader stores as IMA ADPCM. Program 1
+    // plays the same sample with a loop at its end, which always stays PCM. Until the voice
+    // reaches the loop the renders differ only by the ADPCM coding error, which must stay below
+    // kMaxAdpcmError of the signal (about -26 dB).
+    static constexpr double kMaxAdpcmError = 0.05;
+    static constexpr uint32_t kSampleLength = 8192;
+    static constexpr uint32_t kLoopLength = 512;
+    static constexpr EAS_I32 kCompareFrames = kSampleLength - kLoopLength;
+
+    DlsWave oneShot = {vector<int16_t>(kSampleLength), 0, 0};
+    for (uint32_t i = 0; i < kSampleLength; i++) {
+        double t = (double)i / kDlsSampleRate;
+        oneShot.samples[i] =
+                (int16_t)(12000 * sin(2 * M_PI * 440 * t) + 4000 * sin(2 * M_PI * 1320 * t));
+    }
+    DlsWave looped = oneShot;
+    looped.loopStart = kSampleLength - kLoopLength;
+    looped.loopLength = kLoopLength;
+    vector<uint8_t> dls = makeDls({oneShot, looped});
+
+    vector<EAS_PCM> adpcm;
+    ASSERT_NO_FATAL_FAILURE(render(makeXmf(dls, makeSmf(0, {})), {}, kCompareFrames, &adpcm));
+    vector<EAS_PCM> pcm;
+    ASSERT_NO_FATAL_FAILURE(render(makeXmf(dls, makeSmf(1, {})), {}, kCompareFrames, &pcm));
+
+    double signal = rms(pcm);
+    ASSERT_GT(signal, 0) << "The DLS instrument did not play";
+
+    double sum = 0;
+    for (size_t i = 0; i < pcm.size(); i++) {
+        int32_t diff = (int32_t)adpcm[i] - pcm[i];
+        sum += (double)diff * diff;
+    }
+    double error = sqrt(sum / pcm.size());
+    ASSERT_GT(error, 0) << "The one-shot sample was not stored as ADPCM";
+    ASSERT_LT(error, kMaxAdpcmError * signal)
+            << "ADPCM decode error is too large, signal rms: " << signal;
+}
+
+TEST_F(SonivoxDlsTest, LoopedSampleTest) {
+    // Program 0 plays a sample with a loop at its end. Program 1 plays the same data followed
+    // by more data with a loop at its end. Before either voice reaches its loop they play the
+    // same samples, so the loader must not change any sample ahead of the loop.
+    static constexpr uint32_t kSampleLength = 8192;
+    static constexpr uint32_t kLoopLength = 512;
+    static constexpr EAS_I32 kCompareFrames = kSampleLength - kLoopLength;
+
+    DlsWave shortLoop = {vector<int16_t>(kSampleLength), kSampleLength - kLoopLength, kLoopLength};
+    for (uint32_t i = 0; i < kSampleLength; i++) {
+        shortLoop.samples[i] = (int16_t)(12000 * sin(2 * M_PI * 440 * i / kDlsSampleRate));
+    }
+    DlsWave longLoop = shortLoop;
+    longLoop.samples.insert(longLoop.samples.end(), shortLoop.samples.begin(),
+                            shortLoop.samples.end());
+    longLoop.loopStart = 2 * kSampleLength - kLoopLength;
+    vector<uint8_t> dls = makeDls({shortLoop, longLoop});
+
+    vector<EAS_PCM> shortRender;
+    ASSERT_NO_FATAL_FAILURE(
+            render(makeXmf(dls, makeSmf(0, {})), {}, kCompareFrames, &shortRender));
+    ASSERT_GT(rms(shortRender), 0) << "The DLS instrument did not play";
+    vector<EAS_PCM> longRender;
+    ASSERT_NO_FATAL_FAILURE(render(makeXmf(dls, makeSmf(1, {})), {}, kCompareFrames, &longRender));
+
+    for (size_t i = 0; i < shortRender.size(); i++) {
+        ASSERT_EQ(shortRender[i], longRender[i]) << "Renders differ at sample " << i;
+    }
+}
+
+TEST_F(SonivoxDlsTest, ProgramChangeTest) {
+    // The file selects program 1 before its note. Its sample must be in memory when the note
+    // starts, with lazy loading that means it was loaded before the first render, so it plays
+    // exactly like the same sample as program 0.
+    static constexpr uint32_t kSampleLength = 4096;
+    static constexpr EAS_I32 kCompareFrames = kSampleLength - 1;
+
+    DlsWave other = {vector<int16_t>(kSampleLength), 0, 0};
+    DlsWave selected = other;
+    for (uint32_t i = 0; i < kSampleLength; i++) {
+        other.samples[i] = (int16_t)(12000 * sin(2 * M_PI * 220 * i / kDlsSampleRate));
+        selected.samples[i] = (int16_t)(12000 * sin(2 * M_PI * 330 * i / kDlsSampleRate));
+    }
+
+    vector<EAS_PCM> expected;
+    ASSERT_NO_FATAL_FAILURE(
+            render(makeXmf(makeDls({selected}), makeSmf(0, {})), {}, kCompareFrames, &expected));
+    ASSERT_GT(rms(expected), 0) << "The DLS instrument did not play";
+    vector<EAS_PCM> changed;
+    ASSERT_NO_FATAL_FAILURE(render(makeXmf(makeDls({other, selected}), makeSmf(1, {})), {},
+                                   kCompareFrames, &changed));
+
+    for (size_t i = 0; i < expected.size(); i++) {
+        ASSERT_EQ(expected[i], changed[i]) << "Renders differ at sample " << i;
+    }
+}
+
+TEST_F(SonivoxDlsTest, ReverbSendTest) {
+    // With the reverb send bus, a DLS voice on a channel with CC91 at 0 puts nothing on the bus,
+    // so enabling the reverb must not change the output. With CC91 at 127 it must.
+    ASSERT_NO_FATAL_FAILURE(checkEffectSend(EAS_MODULE_REVERB, EAS_PARAM_REVERB_BYPASS, 91));
+}
+
+TEST_F(SonivoxDlsTest, ReverbPresetTest) {
+    // Each reverb preset set before the first render must be used, so the renders of a note sent
+    // to the reverb must all differ.
+    static constexpr EAS_I32 kFrames = kDlsSampleRate;
+
+    DlsWave wave = {vector<int16_t>(kDlsSampleRate / 4), 0, 0};
+    for (uint32_t i = 0; i < wave.samples.size(); i++) {
+        wave.samples[i] = (int16_t)(12000 * sin(2 * M_PI * 440 * i / kDlsSampleRate));
+    }
+    vector<uint8_t> xmf = makeXmf(makeDls({wave}), makeSmf(0, {{91, 127}}));
+
+    vector<vector<EAS_PCM>> renders(EAS_PARAM_REVERB_ROOM + 1);
+    for (EAS_I32 preset = EAS_PARAM_REVERB_LARGE_HALL; preset <= EAS_PARAM_REVERB_ROOM; preset++) {
+        vector<EffectParam> params = {{EAS_MODULE_REVERB, EAS_PARAM_REVERB_PRESET, preset},
+                                      {EAS_MODULE_REVERB, EAS_PARAM_REVERB_BYPASS, EAS_FALSE}};
+        ASSERT_NO_FATAL_FAILURE(render(xmf, params, kFrames, &renders[preset]));
+        for (EAS_I32 other = EAS_PARAM_REVERB_LARGE_HALL; other < preset; other++) {
+            ASSERT_FALSE(renders[other] == renders[preset])
+                    << "Presets " << other << " and " << preset << " render the same";
+        }
+    }
+}
+
+TEST_F(SonivoxDlsTest, ReverbHalfRateTest) {
+    // At half rate the reverb keeps its delay times and decay, and loses only what is above the
+    // half rate Nyquist frequency. A note of noise lowpassed at about 1 kHz is sent to the reverb,
+    // and for each preset the level of the wet signal, the difference to the bypassed render, must
+    // be within kMaxLevelChange of the full rate one. A pure tone is not used, because the small
+    // changes of the delay lengths move the comb filter peaks of the network across it.
+    static constexpr EAS_I32 kFrames = 2 * kDlsSampleRate;
+    static constexpr double kLowpass = 0.75;
+    static constexpr double kMaxLevelChange = 1;  // dB
+
+    DlsWave wave = {vector<int16_t>(kDlsSampleRate / 4), 0, 0};
+    uint32_t seed = 1;
+    double lowpassed = 0;
+    for (uint32_t i = 0; i < wave.samples.size(); i++) {
+        seed = seed * 1103515245 + 12345;
+        lowpassed = kLowpass * lowpassed + (1 - kLowpass) * (int16_t)(seed >> 16);
+        wave.samples[i] = (int16_t)lowpassed;
+    }
+    vector<uint8_t> xmf = makeXmf(makeDls({wave}), makeSmf(0, {{91, 127}}));
+
+    vector<EAS_PCM> bypassed;
+    ASSERT_NO_FATAL_FAILURE(render(xmf, {{EAS_MODULE_REVERB, EAS_PARAM_REVERB_BYPASS, EAS_TRUE}},
+                                   kFrames, &bypassed));
+    auto wetRms = [&bypassed](const vector<EAS_PCM> &pcm) {
+        vector<EAS_PCM> wet(pcm.size());
+        for (size_t i = 0; i < pcm.size(); i++) wet[i] = pcm[i] - bypassed[i];
+        return rms(wet);
+    };
+
+    for (EAS_I32 preset = EAS_PARAM_REVERB_LARGE_HALL; preset <= EAS_PARAM_REVERB_ROOM; preset++) {
+        vector<EAS_PCM> full;
+        ASSERT_NO_FATAL_FAILURE(render(xmf,
+                                       {{EAS_MODULE_REVERB, EAS_PARAM_REVERB_PRESET, preset},
+                                        {EAS_MODULE_REVERB, EAS_PARAM_REVERB_BYPASS, EAS_FALSE}},
+                                       kFrames, &full));
+        vector<EAS_PCM> half;
+        ASSERT_NO_FATAL_FAILURE(render(xmf,
+                                       {{EAS_MODULE_REVERB, EAS_PARAM_REVERB_PRESET, preset},
+                                        {EAS_MODULE_REVERB, EAS_PARAM_REVERB_BYPASS, EAS_FALSE},
+                                        {EAS_MODULE_REVERB, EAS_PARAM_REVERB_HALF_RATE, EAS_TRUE}},
+                                       kFrames, &half));
+        ASSERT_FALSE(half == full) << "Preset " << preset << " did not run at half rate";
+
+        double fullRms = wetRms(full);
+        ASSERT_GT(fullRms, 0) << "Preset " << preset << " has no wet signal";
+        double change = 20 * log10(wetRms(half) / fullRms);
+        ASSERT_LT(fabs(change), kMaxLevelChange)
+                << "Preset " << preset << " changes by " << change << " dB at half rate";
+    }
+}
+
+TEST_F(SonivoxDlsTest, ReverbIdleTest) {
+    // A note sent to the reverb is followed by enough silence for the reverb to go idle, then the
+    // same note is played again. The tail must fade out to digital silence instead of stopping
+    // with a click, and once the second note starts the output must match a render in which the
+    // reverb ran on silence all along instead of going idle.
+    static constexpr uint32_t kSecondNote = 4 * 384;  // 4 s at 384 ticks per second
+    static constexpr EAS_I32 kFrames = 5 * kDlsSampleRate;
+    static constexpr size_t kFadeEndFrames = 32;
+    static constexpr EAS_PCM kMaxFadeEnd = 1;
+
+    DlsWave wave = {vector<int16_t>(kDlsSampleRate / 4), 0, 0};
+    for (uint32_t i = 0; i < wave.samples.size(); i++) {
+        wave.samples[i] = (int16_t)(12000 * sin(2 * M_PI * 440 * i / kDlsSampleRate));
+    }
+    vector<uint8_t> dls = makeDls({wave});
+    vector<EffectParam> wet = {{EAS_MODULE_REVERB, EAS_PARAM_REVERB_BYPASS, EAS_FALSE}};
+
+    vector<uint8_t> setup = {0x00, 0xc0, 0, 0x00, 0xb0, 91, 127};
+    vector<uint8_t> twoNotes = setup;
+    twoNotes.insert(twoNotes.end(), {0x00, 0x90, kDlsNote, 0x64});
+    twoNotes.insert(twoNotes.end(), {0x81, 0x40, 0x80, kDlsNote, 0x40});  // 192 ticks later
+    putVlq(twoNotes, kSecondNote - 192);
+    twoNotes.insert(twoNotes.end(), {0x90, kDlsNote, 0x64});
+    twoNotes.insert(twoNotes.end(), {0x81, 0x40, 0x80, kDlsNote, 0x40});
+    vector<uint8_t> secondNote = setup;
+    putVlq(secondNote, kSecondNote);
+    secondNote.insert(secondNote.end(), {0x90, kDlsNote, 0x64});
+    secondNote.insert(secondNote.end(), {0x81, 0x40, 0x80, kDlsNote, 0x40});
+
+    vector<EAS_PCM> resumed;
+    ASSERT_NO_FATAL_FAILURE(render(makeXmf(dls, makeTrackSmf(twoNotes)), wet, kFrames, &resumed));
+    vector<EAS_PCM> running;
+    ASSERT_NO_FATAL_FAILURE(render(makeXmf(dls, makeTrackSmf(secondNote)), wet, kFrames, &running));
+
+    size_t start = 0;
+    while (start < running.size() && running[start] == 0) start++;
+    ASSERT_LT(start, running.size()) << "The DLS instrument did not play";
+
+    // the end of the first tail, the frames before it must have faded out
+    const S_EAS_LIB_CONFIG *config = EAS_Config();
+    ASSERT_NE(config, nullptr) << "Failed to configure the library";
+    size_t end = start;
+    while (end > 0 && resumed[end - 1] == 0) end--;
+    ASSERT_LT(end, start) << "The reverb tail did not end";
+    ASSERT_GT(end, kFadeEndFrames * config->numChannels) << "The DLS instrument did not play";
+    for (size_t i = end - kFadeEndFrames * config->numChannels; i < end; i++) {
+        ASSERT_LE(abs(resumed[i]), kMaxFadeEnd) << "The reverb tail was cut off at sample " << end;
+    }
+
+    for (size_t i = start; i < resumed.size(); i++) {
+        ASSERT_EQ(running[i], resumed[i]) << "Renders differ at sample " << i;
+    }
+}
+
+TEST_F(SonivoxDlsTest, ChorusSendTest) {
+    // Same for the chorus send bus and CC93.
+    ASSERT_NO_FATAL_FAILURE(checkEffectSend(EAS_MODULE_CHORUS, EAS_PARAM_CHORUS_BYPASS, 93));
+}
+
+TEST_F(SonivoxDlsTest, RenderBudgetTest) {
+    // A budget of 1 us per buffer is exceeded while the first chord of 32 notes plays, so the
+    // render time controller lowers the polyphony to its lower limit of 8 voices. It raises the
+    // polyphony one voice at a time once the load drops, so the second chord of 16 notes starts
+    // right after the first one has faded out and only gets 8 or 9 voices. The voices play the
+    // same looped sine at different pitches, so the rms of the chord is proportional to the
+    // square root of the number of voices, sqrt(8 / 16) to sqrt(9 / 16) of the unlimited render.
+    static constexpr uint32_t kLoopLength = 50;  // one period of 441 Hz
+    static constexpr EAS_I32 kFrames = 2 * kDlsSampleRate;
+    static constexpr EAS_I32 kMeasureStart = kDlsSampleRate;
+    static constexpr uint8_t kFirstChord = 24;
+    static constexpr uint8_t kSecondChord = 48;
+    static constexpr double kMinRatio = 0.68;  // sqrt(7.5 / 16)
+    static constexpr double kMaxRatio = 0.77;  // sqrt(9.5 / 16)
+
+    DlsWave wave = {vector<int16_t>(20 * kLoopLength), 19 * kLoopLength, kLoopLength};
+    for (uint32_t i = 0; i < wave.samples.size(); i++) {
+        wave.samples[i] = (int16_t)(4000 * sin(2 * M_PI * i / kLoopLength));
+    }
+
+    vector<uint8_t> track = {0x00, 0xc0, 0};
+    auto addChord = [&track](const vector<uint8_t> &delta, uint8_t status, uint8_t firstNote,
+                             uint8_t numNotes) {
+        append(track, delta);
+        for (uint8_t note = firstNote; note < firstNote + numNotes; note++) {
+            if (note != firstNote) track.push_back(0x00);
+            track.insert(track.end(), {status, note, 0x40});
+        }
+    };
+    addChord({0x00}, 0x90, kFirstChord, 32);
+    addChord({0x81, 0x40}, 0x80, kFirstChord, 32);  // 192 ticks later
+    addChord({12}, 0x90, kSecondChord, 16);
+    addChord({0x86, 0x00}, 0x80, kSecondChord, 16);  // 768 ticks later
+    vector<uint8_t> xmf = makeXmf(makeDls({wave}), makeTrackSmf(track));
+
+    const S_EAS_LIB_CONFIG *config = EAS_Config();
+    ASSERT_NE(config, nullptr) << "Failed to configure the library";
+    vector<EAS_PCM> unlimited;
+    ASSERT_NO_FATAL_FAILURE(render(xmf, {}, kFrames, &unlimited));
+    vector<EAS_PCM> limited;
+    ASSERT_NO_FATAL_FAILURE(render(xmf, {}, kFrames, &limited, 1));
+
+    vector<EAS_PCM> unlimitedChord(unlimited.begin() + kMeasureStart * config->numChannels,
+                                   unlimited.end());
+    vector<EAS_PCM> limitedChord(limited.begin() + kMeasureStart * config->numChannels,
+                                 limited.end());
+    double unlimitedRms = rms(unlimitedChord);
+    ASSERT_GT(unlimitedRms, 0) << "The DLS instrument did not play";
+    double ratio = rms(limitedChord) / unlimitedRms;
+    ASSERT_GT(ratio, kMinRatio) << "The polyphony went below its lower limit";
+    ASSERT_LT(ratio, kMaxRatio) << "The polyphony was not lowered";
+}
+
+TEST_F(SonivoxDlsTest, StealIndexTest) {
+    // Plays random notes of a looped sine on eight channels, many more than there are voices,
+    // with a note-off for one event in four. Most notes steal a voice, often one that plays the
+    // same note on the same channel. There are only two velocities, so voices that have not
+    // started yet often have equal steal scores. The library is built with _STEAL_INDEX_CHECK,
+    // so every steal also scans all voices and EAS_Render fails if the steal tree picked
+    // another voice.
+    static constexpr uint32_t kLoopLength = 50;
+    static constexpr int kNumChannels = 8;
+    static constexpr int kNumEvents = 3000;
+    static constexpr uint8_t kFirstNote = 48;
+    static constexpr uint8_t kNumNotes = 12;  // few notes, so new notes often match playing ones
+    static constexpr EAS_I32 kFrames = 8 * kDlsSampleRate;
+
+    DlsWave wave = {vector<int16_t>(20 * kLoopLength), 19 * kLoopLength, kLoopLength};
+    for (uint32_t i = 0; i < wave.samples.size(); i++) {
+        wave.samples[i] = (int16_t)(4000 * sin(2 * M_PI * i / kLoopLength));
+    }
+
+    vector<uint8_t> track;
+    for (uint8_t channel = 0; channel < kNumChannels; channel++) {
+        track.insert(track.end(), {0x00, (uint8_t)(0xc0 | channel), 0});
+    }
+    uint32_t seed = 1;
+    auto nextRandom = [&seed](uint32_t range) {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) % range;
+    };
+    for (int event = 0; event < kNumEvents; event++) {
+        uint8_t channel = nextRandom(kNumChannels);
+        uint8_t note = kFirstNote + nextRandom(kNumNotes);
+        uint8_t status = (nextRandom(4) == 0 ? 0x80 : 0x90) | channel;
+        uint8_t velocity = nextRandom(2) ? 64 : 100;
+        track.insert(track.end(), {(uint8_t)nextRandom(3), status, note, velocity});
+    }
+    vector<uint8_t> xmf = makeXmf(makeDls({wave}), makeTrackSmf(track));
+
+    vector<EAS_PCM> pcm;
+    ASSERT_NO_FATAL_FAILURE(render(xmf, {}, kFrames, &pcm));
+    ASSERT_GT(rms(pcm), 0) << "The DLS instrument did not play";
+}
+
+// Builds a JET file that holds the given MIDI files as its segments, without DLS collections.
+static vector<uint8_t> makeJet(const vector<vector<uint8_t>> &segments) {
+    vector<uint8_t> info;
+    putId(info, "SMF#");
+    put32(info, segments.size());
+    putId(info, "DLS#");
+    put32(info, 0);
+    putId(info, "JVER");
+    put32(info, 0x01000000);
+
+    vector<uint8_t> chunks = riffChunk("JINF", info);
+    for (const vector<uint8_t> &smf : segments) append(chunks, riffChunk("JSMF", smf));
+    return riffChunk("JET ", chunks);
+}
+
+TEST(SonivoxJetTest, SegmentQueueTest) {
+    // Queues a short segment as often as the queue allows and plays the queue to the end, twice.
+    // Segments that finish while rendering are closed by the next JET call, never inside
+    // EAS_Render, so the second pass only fits if those closes free the queue.
+    static constexpr EAS_INT kQueueDepth = 3;
+    static constexpr EAS_I32 kMaxBuffers = 1000;
+
+    vector<uint8_t> jet = makeJet({makeSmf(0, {})});
+    EAS_FILE easFile;
+    easFile.handle = (void *)&jet;
+    easFile.readAt = memReadAt;
+    easFile.size = memGetSize;
+
+    const S_EAS_LIB_CONFIG *config = EAS_Config();
+    ASSERT_NE(config, nullptr) << "Failed to configure the library";
+
+    EAS_DATA_HANDLE easData = nullptr;
+    ASSERT_EQ(EAS_Init(&easData), EAS_SUCCESS) << "Failed to initialize synthesizer library";
+    ASSERT_EQ(JET_Init(easData, nullptr, 0), EAS_SUCCESS) << "Failed to initialize JET";
+    ASSERT_EQ(JET_OpenFile(easData, &easFile), EAS_SUCCESS) << "Failed to open the JET file";
+
+    vector<EAS_PCM> buffer(config->mixBufferSize * config->numChannels);
+    for (int pass = 0; pass < 2; pass++) {
+        for (EAS_INT i = 0; i < kQueueDepth; i++) {
+            ASSERT_EQ(JET_QueueSegment(easData, 0, -1, 0, 0, 0, (EAS_U8)i), EAS_SUCCESS)
+                    << "Failed to queue segment " << i << " in pass " << pass;
+        }
+        ASSERT_EQ(JET_Play(easData), EAS_SUCCESS) << "Failed to start playback";
+
+        S_JET_STATUS status = {};
+        EAS_I32 buffers;
+        for (buffers = 0; buffers < kMaxBuffers; buffers++) {
+            EAS_I32 count;
+            ASSERT_EQ(EAS_Render(easData, buffer.data(), config->mixBufferSize, &count),
+                      EAS_SUCCESS)
+                    << "Failed to render the audio data";
+            ASSERT_EQ(JET_Status(easData, &status), EAS_SUCCESS);
+            if (status.numQueuedSegments == 0) break;
+        }
+        ASSERT_LT(buffers, kMaxBuffers) << "The queued segments did not finish";
+        ASSERT_EQ(status.currentUserID, -1) << "A finished segment is reported as playing";
+    }
+
+    ASSERT_EQ(JET_CloseFile(easData), EAS_SUCCESS) << "Failed to close the JET file";
+    ASSERT_EQ(JET_Shutdown(easData), EAS_SUCCESS) << "Failed to shut down JET";
+    ASSERT_EQ(EAS_Shutdown(easData), EAS_SUCCESS) << "Failed to shut down synthesizer library";
+}